@@ -0,0 +1,203 @@
+/** \file acquisition_utilities.c ********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: acquisition_utilities.c
+ *         Description: Headless data acquisition.  The MAX31723 is configured
+ *                      once and sampled on a fixed schedule from the global
+ *                      timer; samples go through a ring buffer and are
+ *                      streamed to the UART only when doing so cannot delay
+ *                      the next sample.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "uart_utilities.h"
+#include "max31723_utilities.h"
+#include "acquisition_utilities.h"
+#include "memory_sections.h"
+
+
+u32 acq_init(struct maximAcquisition *pAcq, u32 unPeripheralAddressSPI, u32 unUartAddress,
+		u8 uchConfiguration, u32 unPeriodUs, struct maximSampleRing *pRing)
+/**
+* \brief       Configure the MAX31723 once and prepare the sampling schedule.
+* \par         Details
+*              The period is raised to the conversion time of the selected resolution, since
+*              sampling faster only returns repeated conversions.  The first sample is scheduled
+*              one conversion time after the configuration write.
+*
+* \param[out]  *pAcq                    - acquisition instance
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral the MAX31723 is attached to
+* \param[in]   unUartAddress            - address of the UART samples are streamed to
+* \param[in]   uchConfiguration         - MAX31723 configuration byte (resolution, continuous mode)
+* \param[in]   unPeriodUs               - requested sample period in microseconds
+* \param[in]   *pRing                   - ring to publish samples to, or NULL for the built-in one
+*
+* \retval      Sample period actually used, in microseconds
+*/
+{
+	u32 unMinPeriodUs;
+
+	memset(pAcq, 0, sizeof(*pAcq));
+	pAcq->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	pAcq->unUartAddress = unUartAddress;
+	pAcq->uchConfiguration = uchConfiguration;
+
+	unMinPeriodUs = max_MAX31723_conversion_time_ms(uchConfiguration) * 1000;
+	if(unPeriodUs < unMinPeriodUs)
+		unPeriodUs = unMinPeriodUs;
+	pAcq->unPeriodUs = unPeriodUs;
+	pAcq->ullPeriodTicks = (u64)unPeriodUs * TICKS_PER_US;
+
+	pAcq->pRing = (pRing != NULL) ? pRing : &pAcq->xRing;
+	sample_ring_init(pAcq->pRing);
+	max_MAX31723_configure(unPeripheralAddressSPI, uchConfiguration);
+	pAcq->ullNextTick = get_time_ticks() + (u64)unMinPeriodUs * TICKS_PER_US;
+
+	return(unPeriodUs);
+}
+
+__fast_text int acq_poll(struct maximAcquisition *pAcq)
+/**
+* \brief       Take a sample if its deadline has been reached.
+* \par         Details
+*              Deadlines advance by whole periods from the first one, so there is no cumulative
+*              drift.  A sample taken more than a period late is flagged and the schedule restarts
+*              from the current time instead of bursting to catch up.
+*
+* \param[in]   *pAcq        - acquisition instance
+*
+* \retval      TRUE if a sample was taken
+*/
+{
+	u64 ullNow;
+	u64 ullLateness;
+	struct maximSample xSample;
+
+	ullNow = get_time_ticks();
+	if(ullNow < pAcq->ullNextTick)
+		return(FALSE);
+
+	max_MAX31723_read_raw(&xSample.nRaw, pAcq->unPeripheralAddressSPI, MAX31723_TEMP_READ);
+	xSample.unTimestampUs = (u32)(ullNow / TICKS_PER_US);
+	xSample.uchSensor = 0;
+	xSample.uchFlags = 0;
+
+	ullLateness = ullNow - pAcq->ullNextTick;
+	if(ullLateness / TICKS_PER_US > pAcq->unMaxLatenessUs)
+		pAcq->unMaxLatenessUs = (u32)(ullLateness / TICKS_PER_US);
+
+	pAcq->ullNextTick += pAcq->ullPeriodTicks;
+	if(pAcq->ullNextTick <= ullNow)
+	{
+		xSample.uchFlags |= SAMPLE_FLAG_LATE;
+		pAcq->unLateCount++;
+		pAcq->ullNextTick = ullNow + pAcq->ullPeriodTicks;
+	}
+
+	sample_ring_push(pAcq->pRing, &xSample);
+	pAcq->unSampleCount++;
+	return(TRUE);
+}
+
+int acq_stream_poll(struct maximAcquisition *pAcq)
+/**
+* \brief       Stream one buffered sample if the UART can take it without stalling.
+* \par         Details
+*              A line is only sent while the Tx FIFO is empty (the line is shorter than the FIFO)
+*              and while the next sample deadline is more than ACQ_STREAM_GUARD_US away, so the
+*              output path never delays a sample by more than the guard time.
+*
+* \param[in]   *pAcq        - acquisition instance
+*
+* \retval      TRUE if a line was sent
+*/
+{
+	struct maximSample xSample;
+
+	if(sample_ring_count(pAcq->pRing) == 0 || !checkUartTxEmpty(pAcq->unUartAddress))
+		return(FALSE);
+	if(get_time_ticks() + (u64)ACQ_STREAM_GUARD_US * TICKS_PER_US >= pAcq->ullNextTick)
+		return(FALSE);
+
+	sample_ring_pop(pAcq->pRing, &xSample);
+	acq_print_sample(&xSample);
+	fflush(stdout);
+	pAcq->unStreamCount++;
+	return(TRUE);
+}
+
+void acq_print_sample(const struct maximSample *pSample)
+/**
+* \brief       Print one sample in the stream format described in acquisition_utilities.h.
+*
+* \param[in]   *pSample     - sample to print
+*
+* \retval      None
+*/
+{
+	printf("S %lu %d %u\r\n", (unsigned long)pSample->unTimestampUs, (int)pSample->nRaw,
+			(unsigned int)pSample->uchFlags);
+}
+
+void acq_run_headless(struct maximAcquisition *pAcq)
+/**
+* \brief       Run the acquisition loop until 'Q' is received on the UART.
+* \par         Details
+*              Only the sampler, the stream output and a one register Rx check run in the loop;
+*              nothing is drawn.  Samples still buffered when 'Q' arrives are flushed before the
+*              trailer line.
+*
+* \param[in]   *pAcq        - acquisition instance (see acq_init())
+*
+* \retval      None
+*/
+{
+	u8 uchInput;
+	struct maximSample xSample;
+
+	printf("# HEADLESS PERIOD_US=%lu CONFIG=0x%02x\r\n", (unsigned long)pAcq->unPeriodUs,
+			(unsigned int)pAcq->uchConfiguration);
+	fflush(stdout);
+
+	while(TRUE)
+	{
+		acq_poll(pAcq);
+		acq_stream_poll(pAcq);
+		if(!checkUartEmpty(pAcq->unUartAddress))
+		{
+			uchInput = getUartByte(pAcq->unUartAddress);
+			if(uchInput == 'Q' || uchInput == 'q')
+				break;
+		}
+	}
+
+	while(sample_ring_pop(pAcq->pRing, &xSample))
+	{
+		acq_print_sample(&xSample);
+		pAcq->unStreamCount++;
+	}
+	printf("# END SAMPLES=%lu STREAMED=%lu DROPPED=%lu LATE=%lu MAX_LATE_US=%lu\r\n",
+			(unsigned long)pAcq->unSampleCount, (unsigned long)pAcq->unStreamCount,
+			(unsigned long)pAcq->pRing->unDropped, (unsigned long)pAcq->unLateCount,
+			(unsigned long)pAcq->unMaxLatenessUs);
+	fflush(stdout);
+}
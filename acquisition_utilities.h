@@ -0,0 +1,70 @@
+/** \file acquisition_utilities.h ********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: acquisition_utilities.h
+ *         Description: Headless data acquisition.  The MAX31723 is configured
+ *                      once and sampled on a fixed schedule from the global
+ *                      timer; samples go through a ring buffer and are
+ *                      streamed to the UART only when doing so cannot delay
+ *                      the next sample.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef ACQUISITION_UTILITIES_H_
+#define ACQUISITION_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "sample_ring.h"
+#include "max31723_utilities.h"
+
+#define ACQ_DEFAULT_CONFIGURATION MAX31723_CONFIG_12BIT_CONTINUOUS  //!< Configuration written at start
+#define ACQ_DEFAULT_PERIOD_US 200000    //!< One sample per 12-bit conversion
+#define ACQ_STREAM_GUARD_US 300         //!< No UART output this close to the next sample deadline
+
+/*
+ * Stream format, one line per sample:
+ *
+ *   S <timestamp us> <temperature in 1/16 degC> <flags>
+ *
+ * framed by a "# HEADLESS ..." header and a "# END ..." trailer with the counters below.
+ */
+
+struct maximAcquisition                 //!< State of one headless acquisition
+{
+	u32 unPeripheralAddressSPI;
+	u32 unUartAddress;
+	u8 uchConfiguration;                //!< MAX31723 configuration byte written at start
+	u32 unPeriodUs;                     //!< sample period actually used
+	u64 ullPeriodTicks;
+	u64 ullNextTick;                    //!< deadline of the next sample
+	u32 unSampleCount;
+	u32 unStreamCount;
+	u32 unLateCount;                    //!< samples taken more than one period late
+	u32 unMaxLatenessUs;                //!< worst delay between deadline and sample
+	struct maximSampleRing *pRing;      //!< ring samples are pushed to, xRing unless another was given
+	struct maximSampleRing xRing;
+};
+
+u32 acq_init(struct maximAcquisition *pAcq, u32 unPeripheralAddressSPI, u32 unUartAddress,
+		u8 uchConfiguration, u32 unPeriodUs, struct maximSampleRing *pRing);
+int acq_poll(struct maximAcquisition *pAcq);
+int acq_stream_poll(struct maximAcquisition *pAcq);
+void acq_print_sample(const struct maximSample *pSample);
+void acq_run_headless(struct maximAcquisition *pAcq);
+
+#endif /* ACQUISITION_UTILITIES_H_ */
@@ -0,0 +1,191 @@
+/** \file adaptive_sampling.c ************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: adaptive_sampling.c
+ *         Description: Adaptive MAX31723 sampling.  The sample period follows
+ *                      the rate of change of the temperature:  it backs off
+ *                      to a slow rate with one-shot conversions while the
+ *                      reading is stable and returns to the conversion
+ *                      limited rate as soon as it moves or nears an alarm
+ *                      setpoint.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "max31723_utilities.h"
+#include "max31723_cache.h"
+#include "adaptive_sampling.h"
+
+
+void adaptive_default_config(struct maximAdaptiveConfig *pConfig)
+/**
+* \brief       Fill in the ADAPTIVE_DEFAULT_... settings.
+*
+* \retval      None
+*/
+{
+	pConfig->unSlowPeriodMs = ADAPTIVE_DEFAULT_SLOW_PERIOD_MS;
+	pConfig->unRateWindowMs = ADAPTIVE_DEFAULT_RATE_WINDOW_MS;
+	pConfig->nStableRate = ADAPTIVE_DEFAULT_STABLE_RATE;
+	pConfig->nGuardBand = ADAPTIVE_DEFAULT_GUARD_BAND;
+	pConfig->uchSlowResolution = ADAPTIVE_DEFAULT_SLOW_RESOLUTION;
+}
+
+void adaptive_init(struct maximAdaptiveSampler *pSampler, struct maximMax31723Cache *pCache,
+		const struct maximAdaptiveConfig *pConfig)
+/**
+* \brief       Start sampling at the full rate in continuous 12-bit mode.
+*
+* \param[out]  *pSampler    - sampler instance
+* \param[in]   *pCache      - cache of the MAX31723 to sample
+* \param[in]   *pConfig     - policy, or NULL for the defaults
+*
+* \retval      None
+*/
+{
+	memset(pSampler, 0, sizeof(*pSampler));
+	pSampler->pCache = pCache;
+	if(pConfig != NULL)
+		pSampler->xConfig = *pConfig;
+	else
+		adaptive_default_config(&pSampler->xConfig);
+
+	pSampler->unFastPeriodMs = max_MAX31723_conversion_time_ms(MAX31723_CONFIG_12BIT_CONTINUOUS);
+	if(pSampler->xConfig.unSlowPeriodMs < pSampler->unFastPeriodMs)
+		pSampler->xConfig.unSlowPeriodMs = pSampler->unFastPeriodMs;
+	pSampler->unPeriodMs = pSampler->unFastPeriodMs;
+
+	if(pCache->uchConfiguration != MAX31723_CONFIG_12BIT_CONTINUOUS)
+		max31723_cache_configure(pCache, MAX31723_CONFIG_12BIT_CONTINUOUS);
+	pSampler->unNextMs = get_time_ms();
+}
+
+static int adaptive_is_active(struct maximAdaptiveSampler *pSampler, s16 nTemp, u32 unNow)
+/**
+* \brief       Update dT/dt and decide whether the reading calls for the full rate.
+*/
+{
+	s16 nLowAlarm, nHighAlarm;
+	s32 nDelta;
+	u32 unElapsedMs;
+
+	if(!pSampler->uchHaveReference)
+	{
+		pSampler->uchHaveReference = TRUE;
+		pSampler->nReferenceTemp = nTemp;
+		pSampler->unReferenceMs = unNow;
+	}
+	unElapsedMs = unNow - pSampler->unReferenceMs;
+	if(unElapsedMs >= pSampler->xConfig.unRateWindowMs)
+	{
+		nDelta = nTemp - pSampler->nReferenceTemp;
+		if(nDelta >= -ADAPTIVE_NOISE_LSB && nDelta <= ADAPTIVE_NOISE_LSB)
+			nDelta = 0;
+		pSampler->lRate = nDelta * 60000 / (s32)unElapsedMs;
+		pSampler->nReferenceTemp = nTemp;
+		pSampler->unReferenceMs = unNow;
+	}
+	if(pSampler->lRate > pSampler->xConfig.nStableRate || pSampler->lRate < -pSampler->xConfig.nStableRate)
+		return(TRUE);
+
+	// Alarm setpoints are served from the cache
+	max31723_cache_read_raw(pSampler->pCache, &nLowAlarm, MAX31723_LOW_ALARM_READ);
+	max31723_cache_read_raw(pSampler->pCache, &nHighAlarm, MAX31723_HIGH_ALARM_READ);
+	return(nTemp <= nLowAlarm + pSampler->xConfig.nGuardBand || nTemp >= nHighAlarm - pSampler->xConfig.nGuardBand);
+}
+
+int adaptive_poll(struct maximAdaptiveSampler *pSampler, s16 *pnTemp)
+/**
+* \brief       Take a sample if its deadline has been reached.  Never blocks.
+* \par         Details
+*              In one-shot mode the conversion is started here one conversion time before the
+*              deadline, so the reading at the deadline does not wait.  The new period takes effect
+*              from this sample;  a sampler that fell more than one period behind restarts its
+*              schedule from now.
+*
+* \param[in]   *pSampler    - sampler instance
+* \param[out]  *pnTemp      - temperature in 1/16 degC when a sample was taken
+*
+* \retval      TRUE if a sample was taken
+*/
+{
+	struct maximMax31723Cache *pCache = pSampler->pCache;
+	u8 uchSlowConfiguration = pSampler->xConfig.uchSlowResolution | MAX31723_CONFIG_SHUTDOWN;
+	u32 unNow = get_time_ms();
+	u32 unLeadMs;
+	int nActive;
+
+	if(pSampler->uchOneShot && !pSampler->uchTriggered)
+	{
+		unLeadMs = max_MAX31723_conversion_time_ms(uchSlowConfiguration);
+		if((s32)(unNow - (pSampler->unNextMs - unLeadMs)) >= 0)
+		{
+			max31723_cache_configure(pCache, uchSlowConfiguration | MAX31723_CONFIG_ONE_SHOT);
+			pSampler->uchTriggered = TRUE;
+		}
+	}
+	if((s32)(unNow - pSampler->unNextMs) < 0)
+		return(FALSE);
+
+	// A one-shot or resolution change can still be converting;  sample on a later poll
+	if(max31723_cache_read_raw(pCache, pnTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+		return(FALSE);
+	pSampler->unSampleCount++;
+	if(pSampler->uchOneShot)
+		pSampler->unOneShotCount++;
+	pSampler->uchTriggered = FALSE;
+
+	nActive = adaptive_is_active(pSampler, *pnTemp, unNow);
+	if(nActive)
+		pSampler->unPeriodMs = pSampler->unFastPeriodMs;
+	else if(pSampler->unPeriodMs < pSampler->xConfig.unSlowPeriodMs)
+	{
+		pSampler->unPeriodMs *= 2;
+		if(pSampler->unPeriodMs > pSampler->xConfig.unSlowPeriodMs)
+			pSampler->unPeriodMs = pSampler->xConfig.unSlowPeriodMs;
+	}
+
+	if(pSampler->unPeriodMs >= ADAPTIVE_ONE_SHOT_PERIOD_MS && !pSampler->uchOneShot)
+	{
+		max31723_cache_configure(pCache, uchSlowConfiguration);
+		pSampler->uchOneShot = TRUE;
+	}
+	else if(pSampler->unPeriodMs < ADAPTIVE_ONE_SHOT_PERIOD_MS && pSampler->uchOneShot)
+	{
+		max31723_cache_configure(pCache, MAX31723_CONFIG_12BIT_CONTINUOUS);
+		pSampler->uchOneShot = FALSE;
+	}
+
+	pSampler->unNextMs += pSampler->unPeriodMs;
+	if((s32)(pSampler->unNextMs - unNow) <= 0)
+		pSampler->unNextMs = unNow + pSampler->unPeriodMs;
+	return(TRUE);
+}
+
+void adaptive_stop(struct maximAdaptiveSampler *pSampler)
+/**
+* \brief       Leave the part in continuous 12-bit mode, as the rest of the application expects.
+*
+* \retval      None
+*/
+{
+	if(pSampler->pCache->uchConfiguration != MAX31723_CONFIG_12BIT_CONTINUOUS)
+		max31723_cache_configure(pSampler->pCache, MAX31723_CONFIG_12BIT_CONTINUOUS);
+}
@@ -0,0 +1,86 @@
+/** \file adaptive_sampling.h ************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: adaptive_sampling.h
+ *         Description: Adaptive MAX31723 sampling.  The sample period follows
+ *                      the rate of change of the temperature:  it backs off
+ *                      to a slow rate with one-shot conversions while the
+ *                      reading is stable and returns to the conversion
+ *                      limited rate as soon as it moves or nears an alarm
+ *                      setpoint.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef ADAPTIVE_SAMPLING_H_
+#define ADAPTIVE_SAMPLING_H_
+
+#include "xbasic_types.h"
+#include "max31723_cache.h"
+
+#define ADAPTIVE_DEFAULT_SLOW_PERIOD_MS 8000    //!< Slowest sample period
+#define ADAPTIVE_DEFAULT_RATE_WINDOW_MS 2000    //!< Shortest baseline dT/dt is measured over
+#define ADAPTIVE_DEFAULT_STABLE_RATE 8          //!< Stable below this |dT/dt|, 1/16 degC per minute (0.5 degC/min)
+#define ADAPTIVE_DEFAULT_GUARD_BAND (2 * 16)    //!< Full rate within 2 degC of Tlow or Thigh
+#define ADAPTIVE_DEFAULT_SLOW_RESOLUTION MAX31723_CONFIG_RESOLUTION_12BIT   //!< R1:R0 of the one-shot conversions
+#define ADAPTIVE_NOISE_LSB 1                    //!< Changes this small over a baseline count as no change
+#define ADAPTIVE_ONE_SHOT_PERIOD_MS 1000        //!< Periods this long shut the part down between samples
+
+/*
+ * The full rate is one sample per 12-bit conversion in continuous mode.  Each stable sample doubles
+ * the period up to unSlowPeriodMs;  once the period reaches ADAPTIVE_ONE_SHOT_PERIOD_MS the part is
+ * shut down between samples and a one-shot conversion is started one conversion time before each
+ * deadline.  A reading that moves faster than nStableRate, or lies within nGuardBand of either
+ * setpoint, returns to the full rate at once.
+ *
+ * dT/dt is measured between readings at least unRateWindowMs apart, so the 1 LSB dither of a steady
+ * reading does not look like movement at the full rate.
+ */
+
+struct maximAdaptiveConfig
+{
+	u32 unSlowPeriodMs;
+	u32 unRateWindowMs;
+	s16 nStableRate;                    //!< 1/16 degC per minute
+	s16 nGuardBand;                     //!< 1/16 degC
+	u8 uchSlowResolution;               //!< MAX31723_CONFIG_RESOLUTION_... for one-shot conversions
+};
+
+struct maximAdaptiveSampler
+{
+	struct maximMax31723Cache *pCache;
+	struct maximAdaptiveConfig xConfig;
+	u32 unFastPeriodMs;                 //!< 12-bit conversion time
+	u32 unPeriodMs;                     //!< current sample period
+	u32 unNextMs;                       //!< deadline of the next sample, get_time_ms()
+	u8 uchOneShot;                      //!< TRUE while the part is shut down between samples
+	u8 uchTriggered;                    //!< one-shot conversion started for the next deadline
+	u8 uchHaveReference;
+	s16 nReferenceTemp;                 //!< start of the dT/dt baseline
+	u32 unReferenceMs;
+	s32 lRate;                          //!< last dT/dt, 1/16 degC per minute
+	u32 unSampleCount;
+	u32 unOneShotCount;                 //!< samples taken from one-shot conversions
+};
+
+void adaptive_default_config(struct maximAdaptiveConfig *pConfig);
+void adaptive_init(struct maximAdaptiveSampler *pSampler, struct maximMax31723Cache *pCache,
+		const struct maximAdaptiveConfig *pConfig);
+int adaptive_poll(struct maximAdaptiveSampler *pSampler, s16 *pnTemp);
+void adaptive_stop(struct maximAdaptiveSampler *pSampler);
+
+#endif /* ADAPTIVE_SAMPLING_H_ */
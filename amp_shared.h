@@ -0,0 +1,94 @@
+/** \file amp_shared.h *******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: amp_shared.h
+ *         Description: Memory shared by the two Cortex-A9 cores in the AMP
+ *                      configuration.  CPU1 (cpu1/) samples the MAX31723 and
+ *                      publishes into the sample ring below; CPU0 runs the
+ *                      menu, UART, OLED and logging and consumes the ring.
+ *                      This header is compiled into both applications.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef AMP_SHARED_H_
+#define AMP_SHARED_H_
+
+#include "xbasic_types.h"
+#include "sample_ring.h"
+
+#ifndef AMP_ENABLED
+#define AMP_ENABLED 0                   //!< 1 when the boot image also carries the CPU1 application
+#endif
+
+/*
+ * Memory map
+ *
+ *   0x00100000 - 0x0FFFFFFF   CPU0 application (lscript.ld)
+ *   0x10000000 - 0x1FFFFFFF   CPU1 application (cpu1/lscript.ld)
+ *   0xFFFF0000 - 0xFFFF0FFF   struct maximAmpShared (top OCM, non-cacheable on both CPUs)
+ *   0xFFFFFFF0                CPU1 start address, polled by the boot ROM after SEV
+ *
+ * The shared block lives in the high OCM mapping rather than ps7_ram_0: memory attributes are set
+ * per 1 MB MMU section, and making the 0x00000000 section non-cacheable would also slow down the
+ * code and data placed in ps7_ram_0.  The 0xFFF00000 section only holds OCM, so it can be made
+ * non-cacheable (AMP_SHARED_TLB_ATTRIBUTES) without cache maintenance on either side.  Neither
+ * linker script places anything in the first AMP_SHARED_SIZE bytes of that OCM.
+ */
+#define AMP_SHARED_BASEADDR 0xFFFF0000      //!< Start of the shared block (ps7_ram_1)
+#define AMP_SHARED_SIZE 0x1000              //!< Reserved for it:  both linker scripts start ps7_ram_1 above it
+#define AMP_SHARED_TLB_ATTRIBUTES 0x14de2   //!< Shareable normal memory, inner/outer non-cacheable
+#define AMP_CPU1_START_ADDRESS 0x10000000   //!< _vector_table of the CPU1 application
+#define AMP_CPU1_RELEASE_ADDRESS 0xFFFFFFF0 //!< CPU1 jumps to the address written here on SEV
+
+#define AMP_SHARED_MAGIC 0x414D5031         //!< "AMP1", written by CPU1 once it is running
+
+#define AMP_CPU1_STATE_OFF 0                //!< CPU1 has not started
+#define AMP_CPU1_STATE_IDLE 1               //!< CPU1 waits for AMP_COMMAND_START; CPU0 owns the SPI bus
+#define AMP_CPU1_STATE_RUNNING 2            //!< CPU1 is sampling; CPU0 must not touch the SPI bus
+
+#define AMP_COMMAND_NONE 0
+#define AMP_COMMAND_START 1                 //!< start sampling with unConfiguration and unPeriodUs
+#define AMP_COMMAND_STOP 2                  //!< stop sampling and go back to AMP_CPU1_STATE_IDLE
+
+struct maximAmpShared                   //!< Written by the CPU named in each comment only
+{
+	volatile u32 unMagic;               //!< CPU1
+	volatile u32 unCpu1State;           //!< CPU1, AMP_CPU1_STATE_...
+	volatile u32 unCommand;             //!< CPU0, AMP_COMMAND_...
+	volatile u32 unPeripheralAddressSPI;//!< CPU0, sensor to sample
+	volatile u32 unConfiguration;       //!< CPU0, MAX31723 configuration byte
+	volatile u32 unPeriodUs;            //!< CPU0 requests, CPU1 writes back the period in use
+	volatile u32 unSampleCount;         //!< CPU1
+	volatile u32 unLateCount;           //!< CPU1
+	volatile u32 unMaxLatenessUs;       //!< CPU1
+	struct maximSampleRing xRing;       //!< CPU1 produces, CPU0 consumes
+};
+
+typedef char amp_shared_size_check[(sizeof(struct maximAmpShared) <= AMP_SHARED_SIZE) ? 1 : -1];  //!< fails to compile when the block outgrows its reservation
+
+#define g_pAmpShared ((struct maximAmpShared *)AMP_SHARED_BASEADDR)
+
+#if defined(__arm__)
+#define AMP_SIGNAL() __asm__ __volatile__("dsb\n\tsev" ::: "memory")    //!< Complete prior writes, wake the other CPU
+#define AMP_WAIT() __asm__ __volatile__("wfe" ::: "memory")             //!< Sleep until SEV or an interrupt
+#else
+#define AMP_SIGNAL() __asm__ __volatile__("" ::: "memory")
+#define AMP_WAIT() __asm__ __volatile__("" ::: "memory")
+#endif
+
+#endif /* AMP_SHARED_H_ */
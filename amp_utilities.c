@@ -0,0 +1,173 @@
+/** \file amp_utilities.c ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: amp_utilities.c
+ *         Description: CPU0 side of the AMP configuration:  releases CPU1,
+ *                      hands it the SPI bus for acquisition and consumes the
+ *                      samples it publishes (see amp_shared.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "xil_io.h"
+#include "xil_mmu.h"
+#include "delays.h"
+#include "uart_utilities.h"
+#include "acquisition_utilities.h"
+#include "amp_utilities.h"
+
+
+static int amp_wait_cpu1_state(u32 unState)
+/**
+* \brief       Wait for CPU1 to reach unState, for at most AMP_HANDSHAKE_TIMEOUT_MS.
+*
+* \retval      TRUE if the state was reached
+*/
+{
+	u32 unStartMs = get_time_ms();
+
+	while(g_pAmpShared->unCpu1State != unState)
+	{
+		if(get_time_ms() - unStartMs > AMP_HANDSHAKE_TIMEOUT_MS)
+			return(FALSE);
+	}
+	return(TRUE);
+}
+
+int amp_cpu1_start(void)
+/**
+* \brief       Release CPU1 from the boot ROM wait loop and wait until it is idle.
+* \par         Details
+*              The shared block is made non-cacheable first, so neither CPU needs cache maintenance
+*              on it.  CPU1 is released by writing its start address to AMP_CPU1_RELEASE_ADDRESS and
+*              executing SEV.  Calling this again once CPU1 runs does nothing.
+*
+* \retval      TRUE if CPU1 is running and idle
+*/
+{
+	Xil_SetTlbAttributes(AMP_SHARED_BASEADDR, AMP_SHARED_TLB_ATTRIBUTES);
+
+	if(g_pAmpShared->unMagic == AMP_SHARED_MAGIC && g_pAmpShared->unCpu1State != AMP_CPU1_STATE_OFF)
+		return(TRUE);
+
+	g_pAmpShared->unCpu1State = AMP_CPU1_STATE_OFF;
+	g_pAmpShared->unCommand = AMP_COMMAND_NONE;
+	Xil_Out32(AMP_CPU1_RELEASE_ADDRESS, AMP_CPU1_START_ADDRESS);
+	AMP_SIGNAL();
+
+	return(amp_wait_cpu1_state(AMP_CPU1_STATE_IDLE));
+}
+
+int amp_acquisition_start(u32 unPeripheralAddressSPI, u8 uchConfiguration, u32 unPeriodUs)
+/**
+* \brief       Hand the SPI bus to CPU1 and start sampling.
+* \par         Details
+*              Until amp_acquisition_stop() returns, CPU0 must not access the SPI peripheral.
+*
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral the MAX31723 is attached to
+* \param[in]   uchConfiguration         - MAX31723 configuration byte
+* \param[in]   unPeriodUs               - requested sample period (raised to the conversion time by CPU1)
+*
+* \retval      TRUE if CPU1 started sampling
+*/
+{
+	if(g_pAmpShared->unCpu1State != AMP_CPU1_STATE_IDLE)
+		return(FALSE);
+
+	sample_ring_init(&g_pAmpShared->xRing);
+	g_pAmpShared->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	g_pAmpShared->unConfiguration = uchConfiguration;
+	g_pAmpShared->unPeriodUs = unPeriodUs;
+	g_pAmpShared->unCommand = AMP_COMMAND_START;
+	AMP_SIGNAL();
+
+	return(amp_wait_cpu1_state(AMP_CPU1_STATE_RUNNING));
+}
+
+int amp_acquisition_stop(void)
+/**
+* \brief       Stop sampling on CPU1 and take the SPI bus back.
+*
+* \retval      TRUE if CPU1 went back to idle
+*/
+{
+	g_pAmpShared->unCommand = AMP_COMMAND_STOP;
+	AMP_SIGNAL();
+
+	return(amp_wait_cpu1_state(AMP_CPU1_STATE_IDLE));
+}
+
+void amp_run_headless(u32 unUartAddress, u32 unPeripheralAddressSPI, u8 uchConfiguration, u32 unPeriodUs)
+/**
+* \brief       Headless acquisition with CPU1 as the sampler; returns when 'Q' is received.
+* \par         Details
+*              Same stream format as acq_run_headless(), but the output no longer has to stay
+*              clear of sample deadlines:  CPU0 prints whenever there is something to print and
+*              sleeps (WFE) until CPU1 signals the next sample otherwise.
+*
+* \param[in]   unUartAddress            - address of the UART samples are streamed to
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral the MAX31723 is attached to
+* \param[in]   uchConfiguration         - MAX31723 configuration byte
+* \param[in]   unPeriodUs               - requested sample period in microseconds
+*
+* \retval      None
+*/
+{
+	u8 uchInput;
+	u32 unStreamCount = 0;
+	struct maximSample xSample;
+
+	if(!amp_cpu1_start() || !amp_acquisition_start(unPeripheralAddressSPI, uchConfiguration, unPeriodUs))
+	{
+		printf("# HEADLESS AMP CPU1_NOT_RESPONDING\r\n");
+		return;
+	}
+	printf("# HEADLESS AMP PERIOD_US=%lu CONFIG=0x%02x\r\n", (unsigned long)g_pAmpShared->unPeriodUs,
+			(unsigned int)uchConfiguration);
+	fflush(stdout);
+
+	while(TRUE)
+	{
+		if(sample_ring_pop(&g_pAmpShared->xRing, &xSample))
+		{
+			acq_print_sample(&xSample);
+			unStreamCount++;
+			continue;
+		}
+		fflush(stdout);
+		if(!checkUartEmpty(unUartAddress))
+		{
+			uchInput = getUartByte(unUartAddress);
+			if(uchInput == 'Q' || uchInput == 'q')
+				break;
+		}
+		AMP_WAIT();    // woken by the next sample, or at the latest by the tick interrupt
+	}
+
+	amp_acquisition_stop();
+	while(sample_ring_pop(&g_pAmpShared->xRing, &xSample))
+	{
+		acq_print_sample(&xSample);
+		unStreamCount++;
+	}
+	printf("# END SAMPLES=%lu STREAMED=%lu DROPPED=%lu LATE=%lu MAX_LATE_US=%lu\r\n",
+			(unsigned long)g_pAmpShared->unSampleCount, (unsigned long)unStreamCount,
+			(unsigned long)g_pAmpShared->xRing.unDropped, (unsigned long)g_pAmpShared->unLateCount,
+			(unsigned long)g_pAmpShared->unMaxLatenessUs);
+	fflush(stdout);
+}
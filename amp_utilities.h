@@ -0,0 +1,39 @@
+/** \file amp_utilities.h ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: amp_utilities.h
+ *         Description: CPU0 side of the AMP configuration:  releases CPU1,
+ *                      hands it the SPI bus for acquisition and consumes the
+ *                      samples it publishes (see amp_shared.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef AMP_UTILITIES_H_
+#define AMP_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "amp_shared.h"
+
+#define AMP_HANDSHAKE_TIMEOUT_MS 1000   //!< Time allowed for CPU1 to acknowledge a state change
+
+int amp_cpu1_start(void);
+int amp_acquisition_start(u32 unPeripheralAddressSPI, u8 uchConfiguration, u32 unPeriodUs);
+int amp_acquisition_stop(void);
+void amp_run_headless(u32 unUartAddress, u32 unPeripheralAddressSPI, u8 uchConfiguration, u32 unPeriodUs);
+
+#endif /* AMP_UTILITIES_H_ */
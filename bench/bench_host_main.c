@@ -0,0 +1,389 @@
+/** \file bench_host_main.c **************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: bench_host_main.c
+ *         Description: Host benchmark runner.  Runs bench_run() against the
+ *                      simulated bus and optionally checks the deterministic
+ *                      counters against a baseline file.
+ *
+ *                      bench_host [--check <baseline>] [--spi-bits 8|16|32] [filter]
+ *
+ *                      With --check, a case whose mmio_rd, mmio_wr or bus_ns
+ *                      total is higher than in the baseline fails the run
+ *                      (exit status 1).  wall_ns is never compared.  The
+ *                      baseline is for the default 8 bit SPI core;
+ *                      --spi-bits simulates a core built wider.  The
+ *                      spi_fixed_... cases and the MAX31723 driver use
+ *                      transfers specialized for SPI_FIXED_WORD_BYTES (see
+ *                      spi_fixed.h), so other widths also need e.g.
+ *                      CFLAGS="-O2 -DSPI_FIXED_WORD_BYTES=2".
+ *
+ *                      After the cases, driver checks run against the
+ *                      device models at the selected width and print
+ *                      "# CHECK <name> PASSED|FAILED";  a failed check
+ *                      fails the run with or without --check.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "sim_bus.h"
+#include "spi_utilities.h"
+#include "spi_fixed.h"
+#include "bench_utilities.h"
+#include "max31723_utilities.h"
+#include "register_map.h"
+#include "max31723_cache.h"
+#include "max31855_utilities.h"
+
+#define BENCH_HOST_TEMPERATURE_RAW 401  //!< 25.0625 degC in 1/16 degC
+#define BENCH_HOST_THERMOCOUPLE_SLAVE 3 //!< free slave select the MAX31855 model is put on
+#define BENCH_LINE_LENGTH 256
+
+
+static int bench_check_case(const struct maximBenchResult *pResult, const char *sBaselinePath)
+/**
+* \brief       Compare one result with its line in the baseline file.
+*
+* \retval      Number of counters that got worse (0 if the case is not in the baseline)
+*/
+{
+	FILE *pFile;
+	char sLine[BENCH_LINE_LENGTH];
+	char sName[64];
+	unsigned long unIterations;
+	unsigned long long ullWall, ullReads, ullWrites, ullBusNs;
+	int nWorse = 0;
+
+	pFile = fopen(sBaselinePath, "r");
+	if(pFile == NULL)
+		return(0);
+	while(fgets(sLine, sizeof(sLine), pFile) != NULL)
+	{
+		if(sscanf(sLine, "BENCH case=%63s iters=%lu wall_ns=%llu mmio_rd=%llu mmio_wr=%llu bus_ns=%llu",
+				sName, &unIterations, &ullWall, &ullReads, &ullWrites, &ullBusNs) != 6)
+			continue;
+		if(strcmp(sName, pResult->sName) != 0)
+			continue;
+		if(unIterations != pResult->unIterations)
+		{
+			printf("CHECK %s: iters %lu -> %lu, not compared\n", sName, unIterations, (unsigned long)pResult->unIterations);
+			break;
+		}
+		if(pResult->xCounters.ullMmioReads > ullReads)
+		{
+			printf("CHECK %s: mmio_rd %llu -> %llu\n", sName, ullReads, (unsigned long long)pResult->xCounters.ullMmioReads);
+			nWorse++;
+		}
+		if(pResult->xCounters.ullMmioWrites > ullWrites)
+		{
+			printf("CHECK %s: mmio_wr %llu -> %llu\n", sName, ullWrites, (unsigned long long)pResult->xCounters.ullMmioWrites);
+			nWorse++;
+		}
+		if(pResult->xCounters.ullBusNs > ullBusNs)
+		{
+			printf("CHECK %s: bus_ns %llu -> %llu\n", sName, ullBusNs, (unsigned long long)pResult->xCounters.ullBusNs);
+			nWorse++;
+		}
+		break;
+	}
+	fclose(pFile);
+	return(nWorse);
+}
+
+static int bench_check_result(const char *sName, int nFailures)
+{
+	printf("# CHECK %s %s\n", sName, nFailures ? "FAILED" : "PASSED");
+	return(nFailures);
+}
+
+static int bench_check_max31723_registers(const char *sName, const char *sStep, const u8 *auchExpected)
+/**
+* \brief       Compare the registers of the simulated MAX31723 with auchExpected.
+*
+* \retval      Number of registers that differ
+*/
+{
+	int nFailures = 0;
+	int i;
+
+	for(i=0;i<7;i++)
+		if(sim_max31723_register(i) != auchExpected[i])
+		{
+			printf("CHECK %s: %s, reg %02x = %02x, expected %02x\n", sName, sStep, i, sim_max31723_register(i), auchExpected[i]);
+			nFailures++;
+		}
+	return(nFailures);
+}
+
+static int bench_check_max31723_alarms(u32 unPeripheralAddressSPI)
+/**
+* \brief       Write each alarm register, through the driver and through the register map, and check
+*              that no other register changed.
+* \par         Details
+*              The MAX31723 auto-increments across its registers, so a write that shifts more
+*              bytes than asked (word padding on a wide core) lands in the next register.  TLOW is
+*              written first, so its LSB is not zero when THIGH is written next to it.
+*
+* \retval      Number of registers that differ from what was written
+*/
+{
+	struct maximRegisterMap xMap;
+	u8 auchExpected[7];
+	int nFailures = 0;
+	int i;
+
+	sim_max31723_reset();
+	max_MAX31723_configure(unPeripheralAddressSPI, MAX31723_CONFIG_12BIT_CONTINUOUS);
+	for(i=0;i<7;i++)
+		auchExpected[i] = sim_max31723_register(i);
+	auchExpected[0] = MAX31723_CONFIG_12BIT_CONTINUOUS;
+	nFailures += bench_check_max31723_registers("max31723_alarms", "configure", auchExpected);
+
+	max_MAX31723_set_alarm_raw(-10 * 16 - 5, unPeripheralAddressSPI, MAX31723_LOW_ALARM_WRITE);
+	auchExpected[5] = 0xB0;
+	auchExpected[6] = 0xF5;
+	nFailures += bench_check_max31723_registers("max31723_alarms", "TLOW write", auchExpected);
+
+	max_MAX31723_set_alarm_raw(90 * 16 + 3, unPeripheralAddressSPI, MAX31723_HIGH_ALARM_WRITE);
+	auchExpected[3] = 0x30;
+	auchExpected[4] = 90;
+	nFailures += bench_check_max31723_registers("max31723_alarms", "THIGH write", auchExpected);
+	nFailures = bench_check_result("max31723_alarms", nFailures);
+
+	sim_max31723_reset();
+	for(i=0;i<7;i++)
+		auchExpected[i] = sim_max31723_register(i);
+	regmap_init(&xMap, &g_xMax31723Device, unPeripheralAddressSPI, 0);
+	regmap_write(&xMap, MAX31723_REG_CONFIG, MAX31723_CONFIG_12BIT_CONTINUOUS);
+	auchExpected[0] = MAX31723_CONFIG_12BIT_CONTINUOUS;
+	i = bench_check_max31723_registers("regmap_alarms", "configure", auchExpected);
+	regmap_write(&xMap, MAX31723_REG_LOW_ALARM, -10 * 16 - 5);
+	auchExpected[5] = 0xB0;
+	auchExpected[6] = 0xF5;
+	i += bench_check_max31723_registers("regmap_alarms", "TLOW write", auchExpected);
+	regmap_write(&xMap, MAX31723_REG_HIGH_ALARM, 90 * 16 + 3);
+	auchExpected[3] = 0x30;
+	auchExpected[4] = 90;
+	i += bench_check_max31723_registers("regmap_alarms", "THIGH write", auchExpected);
+	nFailures += bench_check_result("regmap_alarms", i);
+
+	sim_max31723_reset();
+	sim_max31723_set_temp(BENCH_HOST_TEMPERATURE_RAW);
+	return(nFailures);
+}
+
+static int bench_check_max31723_cache(u32 unPeripheralAddressSPI)
+/**
+* \brief       Check that the typed cache readers and the REG command's register map are one cache.
+* \par         Details
+*              A setpoint read through max31723_cache_read_raw() must be a hit for regmap_read_one(),
+*              and one written through the register map must be re-read by the cache.  A temperature
+*              read right after the configuration write must return MAX31723_CACHE_NOT_READY without
+*              waiting or touching the bus.
+*
+* \retval      Number of reads that missed, hit or returned the wrong value
+*/
+{
+	struct maximMax31723Cache xCache;
+	s16 nValue;
+	s32 lValue;
+	u64 ullBytes;
+	int nFailures = 0;
+
+	sim_max31723_reset();
+	max31723_cache_init(&xCache, unPeripheralAddressSPI, MAX31723_CONFIG_12BIT_CONTINUOUS);
+	ullBytes = g_xSimQspiStats.ullBytes;
+	if(max31723_cache_read_raw(&xCache, &nValue, MAX31723_TEMP_READ) != MAX31723_CACHE_NOT_READY ||
+			g_xSimQspiStats.ullBytes != ullBytes)
+	{
+		printf("CHECK max31723_cache: TEMP read during the first 12-bit conversion was not NOT_READY\n");
+		nFailures++;
+	}
+	max31723_cache_set_alarm(&xCache, -10 * 16 - 5, MAX31723_LOW_ALARM_WRITE);
+	if(max31723_cache_read_raw(&xCache, &nValue, MAX31723_LOW_ALARM_READ) || nValue != -10 * 16 - 5)
+	{
+		printf("CHECK max31723_cache: TLOW after a write = %d, expected a read of %d\n", nValue, -10 * 16 - 5);
+		nFailures++;
+	}
+	if(!regmap_read_one(&xCache.xRegisters, MAX31723_REG_LOW_ALARM, &lValue) || lValue != -10 * 16 - 5)
+	{
+		printf("CHECK max31723_cache: REG TLOW = %ld, expected a hit of %d\n", (long)lValue, -10 * 16 - 5);
+		nFailures++;
+	}
+	regmap_write(&xCache.xRegisters, MAX31723_REG_HIGH_ALARM, 90 * 16 + 3);
+	if(max31723_cache_read_raw(&xCache, &nValue, MAX31723_HIGH_ALARM_READ) || nValue != 90 * 16 + 3)
+	{
+		printf("CHECK max31723_cache: THIGH after REG write = %d, expected a read of %d\n", nValue, 90 * 16 + 3);
+		nFailures++;
+	}
+
+	sim_max31723_reset();
+	sim_max31723_set_temp(BENCH_HOST_TEMPERATURE_RAW);
+	return(bench_check_result("max31723_cache", nFailures));
+}
+
+static int bench_check_idle_select(u32 unPeripheralAddressSPI)
+/**
+* \brief       Put a second active high MAX31723 on slave 2 and check that transfers to slave 0,
+*              through the fixed profile and through SpiRWSlave(), never select it as well.
+*
+* \retval      Number of bytes shifted with both parts selected
+*/
+{
+	u8 auchWrite[4] = { MAX31723_TEMP_READ, 0, 0, 0 };
+	u8 auchRead[4];
+	u64 ullConflicts = g_xSimQspiStats.ullSelectConflicts;
+	s16 nTemp;
+	int nFailures;
+
+	sim_qspi_attach(2, &g_xSimMax31723Slave);
+	spi_set_slave_polarity(unPeripheralAddressSPI, 2, TRUE);
+	max_MAX31723_read_raw(&nTemp, unPeripheralAddressSPI, MAX31723_TEMP_READ);
+	SpiRWSlave(unPeripheralAddressSPI, 0, 1, 0, auchWrite, auchRead, SPI_ALIGN_BYTES(3, spi_word_bytes(unPeripheralAddressSPI)), TRUE);
+	nFailures = (int)(g_xSimQspiStats.ullSelectConflicts - ullConflicts);
+	if(nFailures)
+		printf("CHECK idle_select: %d bytes shifted with slaves 0 and 2 selected\n", nFailures);
+
+	spi_set_slave_polarity(unPeripheralAddressSPI, 2, FALSE);
+	sim_qspi_detach(2);
+	return(bench_check_result("idle_select", nFailures));
+}
+
+static int bench_check_max31855_frame(const char *sStep, struct maximMax31855 *pSensor, s16 nProbe, s16 nInternal,
+		u8 uchFaults)
+/**
+* \brief       Read one frame from the simulated MAX31855 and compare the decoded reading.
+*
+* \param[in]   nProbe       - expected probe temperature, 1/16 degC
+* \param[in]   nInternal    - expected cold junction temperature, 1/16 degC
+* \param[in]   uchFaults    - expected MAX31855_FAULT_... bits
+*
+* \retval      1 if the reading or the return value is wrong, else 0
+*/
+{
+	struct maximMax31855Reading xReading;
+	int nValid;
+
+	regmap_invalidate(&pSensor->xRegisters);
+	nValid = max_MAX31855_read(pSensor, &xReading);
+	if(xReading.nProbe == nProbe && xReading.nInternal == nInternal && xReading.uchFaults == uchFaults &&
+			nValid == (uchFaults == 0))
+		return(0);
+	printf("CHECK max31855 %s: probe %d internal %d faults 0x%02x valid %d, expected %d %d 0x%02x %d\n", sStep,
+			xReading.nProbe, xReading.nInternal, xReading.uchFaults, nValid, nProbe, nInternal, uchFaults,
+			uchFaults == 0);
+	return(1);
+}
+
+static int bench_check_max31855(u32 unPeripheralAddressSPI)
+/**
+* \brief       Put the MAX31855 model on BENCH_HOST_THERMOCOUPLE_SLAVE and check the frame decoding.
+* \par         Details
+*              Covers the sign extension of the 14-bit probe and 12-bit cold junction fields at
+*              both ends of their range, the x4 scaling of the probe to 1/16 degC, each fault bit,
+*              and D16 without a fault bit, which is reported as open.  The transfers must also
+*              use the part's SPI mode.
+*
+* \retval      Number of wrong readings and mode errors
+*/
+{
+	struct maximMax31855 xSensor;
+	u64 ullModeErrors = g_xSimQspiStats.ullModeErrors;
+	s32 lValue;
+	int nFailures = 0;
+
+	sim_max31855_reset();
+	sim_qspi_attach(BENCH_HOST_THERMOCOUPLE_SLAVE, &g_xSimMax31855Slave);
+	max_MAX31855_init(&xSensor, unPeripheralAddressSPI, BENCH_HOST_THERMOCOUPLE_SLAVE);
+
+	sim_max31855_set(100 * 4 + 1, 21 * 16 + 9, 0);          // +100.25, +21.5625 degC
+	nFailures += bench_check_max31855_frame("positive", &xSensor, 100 * 16 + 4, 21 * 16 + 9, 0);
+	sim_max31855_set(-(250 * 4 + 3), -(5 * 16 + 1), 0);     // -250.75, -5.0625 degC
+	nFailures += bench_check_max31855_frame("negative", &xSensor, -(250 * 16 + 12), -(5 * 16 + 1), 0);
+	sim_max31855_set(-1, -1, 0);                            // -0.25, -0.0625 degC:  all ones
+	nFailures += bench_check_max31855_frame("minus one lsb", &xSensor, -4, -1, 0);
+	// The s16 scaling would hide an unsigned 14-bit probe field, so check the field itself
+	if(!regmap_read_one(&xSensor.xRegisters, MAX31855_REG_PROBE, &lValue) || lValue != -1)
+	{
+		printf("CHECK max31855: PROBE field = %ld, expected a hit of -1\n", (long)lValue);
+		nFailures++;
+	}
+	sim_max31855_set(-8192, -2048, 0);                      // most negative 14 and 12 bit values
+	nFailures += bench_check_max31855_frame("minimum", &xSensor, -32768, -2048, 0);
+	sim_max31855_set(8191, 2047, 0);                        // +2047.75, +127.9375 degC
+	nFailures += bench_check_max31855_frame("maximum", &xSensor, 32764, 2047, 0);
+
+	sim_max31855_set(-4, 20 * 16, MAX31855_FAULT_OC);
+	nFailures += bench_check_max31855_frame("OC", &xSensor, -16, 20 * 16, MAX31855_FAULT_OC);
+	sim_max31855_set(-4, 20 * 16, MAX31855_FAULT_SCG);
+	nFailures += bench_check_max31855_frame("SCG", &xSensor, -16, 20 * 16, MAX31855_FAULT_SCG);
+	sim_max31855_set(-4, 20 * 16, MAX31855_FAULT_SCV);
+	nFailures += bench_check_max31855_frame("SCV", &xSensor, -16, 20 * 16, MAX31855_FAULT_SCV);
+	sim_max31855_set_frame(0x00010000);                     // D16 alone
+	nFailures += bench_check_max31855_frame("D16 only", &xSensor, 0, 0, MAX31855_FAULT_OC);
+
+	if(g_xSimQspiStats.ullModeErrors != ullModeErrors)
+	{
+		printf("CHECK max31855: %llu bytes shifted in the wrong SPI mode\n",
+				(unsigned long long)(g_xSimQspiStats.ullModeErrors - ullModeErrors));
+		nFailures++;
+	}
+
+	sim_qspi_detach(BENCH_HOST_THERMOCOUPLE_SLAVE);
+	return(bench_check_result("max31855", nFailures));
+}
+
+int main(int argc, char *argv[])
+{
+	struct maximBenchResult axResults[BENCH_MAX_CASES];
+	const char *sBaselinePath = NULL;
+	const char *sFilter = NULL;
+	int nCases, i;
+	int nSpiBits = SPI_FIXED_WORD_BYTES * 8;
+	int nWorse = 0;
+
+	for(i=1;i<argc;i++)
+	{
+		if(strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+			sBaselinePath = argv[++i];
+		else if(strcmp(argv[i], "--spi-bits") == 0 && i + 1 < argc)
+			nSpiBits = atoi(argv[++i]);
+		else
+			sFilter = argv[i];
+	}
+
+	sim_init();
+	sim_max31723_set_temp(BENCH_HOST_TEMPERATURE_RAW);
+	if(!spi_set_transfer_width(XPAR_AXI_QUAD_SPI_0_BASEADDR, (u8)nSpiBits))
+	{
+		fprintf(stderr, "bench_host: unsupported SPI transfer width %d\n", nSpiBits);
+		return(EXIT_FAILURE);
+	}
+	if(nSpiBits != SPI_FIXED_WORD_BYTES * 8)
+	{
+		fprintf(stderr, "bench_host: built for %d bit fixed transfers, rebuild with -DSPI_FIXED_WORD_BYTES=%d\n",
+				SPI_FIXED_WORD_BYTES * 8, nSpiBits / 8);
+		return(EXIT_FAILURE);
+	}
+	sim_qspi_set_transfer_bits(nSpiBits);
+	nCases = bench_run(XPAR_AXI_QUAD_SPI_0_BASEADDR, XPAR_XUARTPS_0_BASEADDR, sFilter, axResults, BENCH_MAX_CASES);
+
+	printf("# SIM qspi_bytes=%llu mode_errors=%llu rx_underruns=%llu tx_overruns=%llu unmapped=%llu\n",
+			(unsigned long long)g_xSimQspiStats.ullBytes, (unsigned long long)g_xSimQspiStats.ullModeErrors,
+			(unsigned long long)g_xSimQspiStats.ullRxUnderruns, (unsigned long long)g_xSimQspiStats.ullTxOverruns,
+			(unsigned long long)g_xSimBus.ullUnmapped);
+
+	nWorse += bench_check_max31723_alarms(XPAR_AXI_QUAD_SPI_0_BASEADDR);
+	nWorse += bench_check_max31723_cache(XPAR_AXI_QUAD_SPI_0_BASEADDR);
+	nWorse += bench_check_idle_select(XPAR_AXI_QUAD_SPI_0_BASEADDR);
+	nWorse += bench_check_max31855(XPAR_AXI_QUAD_SPI_0_BASEADDR);
+	if(sBaselinePath == NULL)
+		return(nWorse ? EXIT_FAILURE : EXIT_SUCCESS);
+	for(i=0;i<nCases && i<BENCH_MAX_CASES;i++)
+		nWorse += bench_check_case(&axResults[i], sBaselinePath);
+	printf("# CHECK %s\n", nWorse ? "FAILED" : "PASSED");
+	return(nWorse ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,147 @@
+/** \file replay_host_main.c *************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: replay_host_main.c
+ *         Description: Replays an SPI capture (CAP command output) through
+ *                      the driver code on the host.
+ *
+ *                      replay_host [-n <passes>] <capture file>
+ *
+ *                      Each transaction is re-issued by the driver call that
+ *                      makes it on the target, with the simulated slave on
+ *                      the captured slave select line returning the captured
+ *                      RX bytes:
+ *
+ *                        slave 0, 3 byte read of 0x01/0x03/0x05  max_MAX31723_read_raw()
+ *                        slave 0, 2 byte write of 0x80           max_MAX31723_configure()
+ *                        anything else                           SpiRWSlave() with the captured TX
+ *
+ *                      Transactions on a controller other than the
+ *                      simulated AXI Quad SPI are skipped.
+ *
+ *                      One "REPLAY <sequence> ..." line is printed per
+ *                      transaction with the decoded result.  With -n, the
+ *                      capture is replayed that many times without output
+ *                      and the time per pass is reported instead.  The exit
+ *                      status is 1 if the driver sent bytes that differ from
+ *                      the capture or sent them to another slave.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "sim_bus.h"
+#include "delays.h"
+#include "spi_utilities.h"
+#include "max31723_utilities.h"
+#include "fixed_point_utilities.h"
+#include "spi_capture.h"
+
+
+static void replay_one(const struct simReplayRecord *pRecord, int nVerbose)
+/**
+* \brief       Re-issue one captured transaction through the driver.
+*/
+{
+	u8 auchRx[SPI_CAPTURE_MAX_TRANSFER];
+	s16 nTemp = 0;
+	char sText[Q4_MAX_TEXT];
+	int i;
+
+	if(!sim_replay_begin(pRecord))
+	{
+		if(nVerbose)
+			printf("REPLAY %08lx SKIP %08lx %02x\n", (unsigned long)pRecord->unSequence,
+					(unsigned long)pRecord->unPeripheralAddressSPI, (unsigned int)pRecord->uchSlave);
+		return;
+	}
+	if(pRecord->uchSlave == 0 && pRecord->uLength == 3 && (pRecord->auchTx[0] == MAX31723_TEMP_READ
+			|| pRecord->auchTx[0] == MAX31723_HIGH_ALARM_READ || pRecord->auchTx[0] == MAX31723_LOW_ALARM_READ))
+	{
+		max_MAX31723_read_raw(&nTemp, pRecord->unPeripheralAddressSPI, pRecord->auchTx[0]);
+		q4_format(sText, nTemp, 4);
+		if(nVerbose)
+			printf("REPLAY %08lx READ %02x %s\n", (unsigned long)pRecord->unSequence,
+					(unsigned int)pRecord->auchTx[0], sText);
+	}
+	else if(pRecord->uchSlave == 0 && pRecord->uLength == 2 && pRecord->auchTx[0] == MAX31723_CONFIG_WRITE)
+	{
+		max_MAX31723_configure(pRecord->unPeripheralAddressSPI, pRecord->auchTx[1]);
+		if(nVerbose)
+			printf("REPLAY %08lx CONFIG %02x\n", (unsigned long)pRecord->unSequence, (unsigned int)pRecord->auchTx[1]);
+	}
+	else
+	{
+		SpiRWSlave(pRecord->unPeripheralAddressSPI, pRecord->uchSlave, (pRecord->uchMode & SPI_CAPTURE_MODE_CPHA) ? 1 : 0,
+				(pRecord->uchMode & SPI_CAPTURE_MODE_CPOL) ? 1 : 0, pRecord->auchTx,
+				(pRecord->uchMode & SPI_CAPTURE_MODE_NO_RX) ? NULL : auchRx, pRecord->uLength,
+				(pRecord->uchMode & SPI_CAPTURE_MODE_CS_HIGH) ? 1 : 0);
+		if(nVerbose)
+		{
+			printf("REPLAY %08lx RAW %02x %u ", (unsigned long)pRecord->unSequence, (unsigned int)pRecord->uchSlave,
+					(unsigned int)pRecord->uLength);
+			for(i=0;i<pRecord->uLength;i++)
+				printf("%02x", (pRecord->uchMode & SPI_CAPTURE_MODE_NO_RX) ? 0 : (unsigned int)auchRx[i]);
+			printf("\n");
+		}
+	}
+	sim_replay_end();
+}
+
+int main(int argc, char *argv[])
+{
+	const char *sPath = NULL;
+	long lPasses = 0;
+	long lPass;
+	int nCount, i;
+	u64 ullStart, ullNs;
+
+	for(i=1;i<argc;i++)
+	{
+		if(strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			lPasses = atol(argv[++i]);
+		else
+			sPath = argv[i];
+	}
+	if(sPath == NULL)
+	{
+		fprintf(stderr, "usage: replay_host [-n <passes>] <capture file>\n");
+		return(2);
+	}
+
+	sim_init();
+	nCount = sim_replay_load(sPath);
+	if(nCount < 0)
+	{
+		fprintf(stderr, "replay_host: cannot read %s\n", sPath);
+		return(2);
+	}
+
+	if(lPasses <= 0)
+	{
+		for(i=0;i<nCount;i++)
+			replay_one(sim_replay_record(i), TRUE);
+	}
+	else
+	{
+		ullStart = get_time_ticks();
+		for(lPass=0;lPass<lPasses;lPass++)
+		{
+			for(i=0;i<nCount;i++)
+				replay_one(sim_replay_record(i), FALSE);
+		}
+		ullNs = (get_time_ticks() - ullStart) * 1000000000ULL / TICKS_PER_SECOND;
+		printf("# REPLAY passes=%ld transactions=%ld wall_ns=%llu ns_per_transaction=%llu\n", lPasses,
+				lPasses * nCount, (unsigned long long)ullNs,
+				nCount ? (unsigned long long)(ullNs / (u64)(lPasses * nCount)) : 0ULL);
+	}
+
+	printf("# REPLAY records=%d mismatches=%llu overruns=%llu underruns=%llu skipped=%llu mode_errors=%llu\n", nCount,
+			(unsigned long long)g_xSimReplayStats.ullMismatches, (unsigned long long)g_xSimReplayStats.ullOverruns,
+			(unsigned long long)g_xSimReplayStats.ullUnderruns, (unsigned long long)g_xSimReplayStats.ullSkipped,
+			(unsigned long long)g_xSimQspiStats.ullModeErrors);
+	return((g_xSimReplayStats.ullMismatches || g_xSimReplayStats.ullOverruns || g_xSimReplayStats.ullUnderruns) ?
+			EXIT_FAILURE : EXIT_SUCCESS);
+}
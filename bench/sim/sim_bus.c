@@ -0,0 +1,133 @@
+/** \file sim_bus.c **********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_bus.c
+ *         Description: Simulated Zynq bus:  Xil_In / Xil_Out, the address
+ *                      map, the simulated bus clock and the global timer
+ *                      (see sim_bus.h).
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <time.h>
+#include "xil_io.h"
+#include "xparameters.h"
+#include "xtime_l.h"
+#include "sim_bus.h"
+#include "../../bench_utilities.h"
+
+#define SIM_GPIO_LED 0
+#define SIM_GPIO_OLED 1
+
+struct simBusCounters g_xSimBus;
+
+
+void XTime_GetTime(XTime *Xtime_Global)
+/**
+* \brief       Global timer:  host monotonic clock in COUNTS_PER_SECOND ticks.
+*/
+{
+	struct timespec xNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	*Xtime_Global = (XTime)xNow.tv_sec * COUNTS_PER_SECOND
+			+ (XTime)xNow.tv_nsec * COUNTS_PER_SECOND / 1000000000ULL;
+}
+
+static u32 sim_bus_access(UINTPTR Addr, int nWrite, u32 unValue)
+/**
+* \brief       Route one 32 bit access to the model mapped at Addr, and charge its cost.
+*
+* \retval      Read data (0 for writes and unmapped reads)
+*/
+{
+	XTime xNow;
+
+	if(nWrite)
+		g_xSimBus.ullWrites++;
+	else
+		g_xSimBus.ullReads++;
+
+	if(Addr >= XPAR_AXI_QUAD_SPI_0_BASEADDR && Addr <= XPAR_AXI_QUAD_SPI_0_HIGHADDR)
+	{
+		// Charge the access first, so the model sees the time at which it completes
+		g_xSimBus.ullBusNs += nWrite ? SIM_PL_WRITE_NS : SIM_PL_READ_NS;
+		if(nWrite)
+			sim_qspi_write((u32)(Addr - XPAR_AXI_QUAD_SPI_0_BASEADDR), unValue);
+		else
+			return(sim_qspi_read((u32)(Addr - XPAR_AXI_QUAD_SPI_0_BASEADDR)));
+	}
+	else if((Addr & ~0xFFFFUL) == XPAR_AXI_GPIO_LED_BASEADDR || (Addr & ~0xFFFFUL) == XPAR_AXI_GPIO_OLED_BASEADDR)
+	{
+		int nGpio = ((Addr & ~0xFFFFUL) == XPAR_AXI_GPIO_LED_BASEADDR) ? SIM_GPIO_LED : SIM_GPIO_OLED;
+
+		g_xSimBus.ullBusNs += nWrite ? SIM_PL_WRITE_NS : SIM_PL_READ_NS;
+		if(nWrite)
+			sim_gpio_write(nGpio, (u32)(Addr & 0xFFFF), unValue);
+		else
+			return(sim_gpio_read(nGpio, (u32)(Addr & 0xFFFF)));
+	}
+	else if(Addr >= XPAR_XUARTPS_0_BASEADDR && Addr < XPAR_XUARTPS_0_BASEADDR + 0x1000)
+	{
+		g_xSimBus.ullBusNs += nWrite ? SIM_PS_WRITE_NS : SIM_PS_READ_NS;
+		if(nWrite)
+			sim_uart_write((u32)(Addr - XPAR_XUARTPS_0_BASEADDR), unValue);
+		else
+			return(sim_uart_read((u32)(Addr - XPAR_XUARTPS_0_BASEADDR)));
+	}
+	else if(Addr == GLOBAL_TMR_BASEADDR + GTIMER_COUNTER_LOWER_OFFSET || Addr == GLOBAL_TMR_BASEADDR + GTIMER_COUNTER_UPPER_OFFSET)
+	{
+		g_xSimBus.ullBusNs += SIM_SCU_ACCESS_NS;
+		if(!nWrite)
+		{
+			XTime_GetTime(&xNow);
+			return((Addr == GLOBAL_TMR_BASEADDR) ? (u32)xNow : (u32)(xNow >> 32));
+		}
+	}
+	else
+		g_xSimBus.ullUnmapped++;
+	return(0);
+}
+
+u32 Xil_In32(UINTPTR Addr) { return(sim_bus_access(Addr, FALSE, 0)); }
+u16 Xil_In16(UINTPTR Addr) { return((u16)sim_bus_access(Addr, FALSE, 0)); }
+u8 Xil_In8(UINTPTR Addr) { return((u8)sim_bus_access(Addr, FALSE, 0)); }
+void Xil_Out32(UINTPTR Addr, u32 Value) { sim_bus_access(Addr, TRUE, Value); }
+void Xil_Out16(UINTPTR Addr, u16 Value) { sim_bus_access(Addr, TRUE, Value); }
+void Xil_Out8(UINTPTR Addr, u8 Value) { sim_bus_access(Addr, TRUE, Value); }
+
+u64 sim_time_ns(void)
+/**
+* \brief       Simulated time.  Only bus accesses advance it.
+*/
+{
+	return(g_xSimBus.ullBusNs);
+}
+
+void sim_init(void)
+/**
+* \brief       Reset the counters and every model, and put the MAX31723 on QSPI slave 0.
+*/
+{
+	memset(&g_xSimBus, 0, sizeof(g_xSimBus));
+	sim_qspi_reset();
+	sim_max31723_reset();
+	sim_qspi_attach(0, &g_xSimMax31723Slave);
+	sim_flash_reset();
+	sim_qspi_attach(1, &g_xSimFlashSlave);
+	sim_uart_reset();
+	sim_gpio_reset();
+}
+
+int bench_counters_read(struct maximBenchCounters *pCounters)
+/**
+* \brief       Benchmark counters of the host build:  the simulated bus.
+*
+* \retval      BENCH_COUNTERS_MMIO | BENCH_COUNTERS_BUS
+*/
+{
+	pCounters->ullMmioReads = g_xSimBus.ullReads;
+	pCounters->ullMmioWrites = g_xSimBus.ullWrites;
+	pCounters->ullBusNs = g_xSimBus.ullBusNs;
+	return(BENCH_COUNTERS_MMIO | BENCH_COUNTERS_BUS);
+}
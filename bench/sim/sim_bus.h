@@ -0,0 +1,128 @@
+/** \file sim_bus.h **********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_bus.h
+ *         Description: Simulated Zynq bus for the host benchmark build.
+ *                      Every Xil_In / Xil_Out goes through sim_bus.c, which
+ *                      counts it, charges its cost to a simulated bus clock
+ *                      and forwards it to the peripheral model mapped at that
+ *                      address:  AXI Quad SPI (with a MAX31723 on slave 0),
+ *                      the two AXI GPIOs, the PS UART and the global timer.
+ *
+ *                      The costs are a model, not a measurement.  They only
+ *                      need to stay fixed so that counts and bus time of two
+ *                      builds can be compared exactly.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SIM_BUS_H
+#define SIM_BUS_H
+
+#include "xil_types.h"
+
+#define SIM_PL_READ_NS 120              //!< AXI GP read from a PL peripheral (CPU waits for the response)
+#define SIM_PL_WRITE_NS 60              //!< AXI GP write to a PL peripheral
+#define SIM_PS_READ_NS 80               //!< PS peripheral (UART) read
+#define SIM_PS_WRITE_NS 40              //!< PS peripheral (UART) write
+#define SIM_SCU_ACCESS_NS 10            //!< CPU private peripheral (global timer) access
+
+#define SIM_SPI_SCK_HZ 5000000          //!< AXI Quad SPI serial clock
+#define SIM_SPI_FIFO_DEPTH 16
+#define SIM_QSPI_SLAVES 4               //!< slave select lines of the simulated AXI Quad SPI
+#define SIM_UART_BAUD 115200            //!< 10 bits per character on the wire
+#define SIM_UART_FIFO_DEPTH 64
+
+struct simBusCounters
+{
+	u64 ullReads;
+	u64 ullWrites;
+	u64 ullUnmapped;                    //!< accesses that hit no model (read as 0)
+	u64 ullBusNs;                       //!< simulated time spent on the bus and waiting for peripherals
+};
+
+extern struct simBusCounters g_xSimBus;
+
+struct simSpiSlave                      //!< A device on one AXI Quad SPI slave select line
+{
+	int nCsActiveHigh;                  //!< board inverts the select line (MAX31723 CE is active high)
+	u8 uchCpol;                         //!< mode the device needs; other modes are counted as errors
+	u8 uchCpha;
+	void (*pfnSelect)(void *pContext, int nSelected);
+	u8 (*pfnTransfer)(void *pContext, u8 uchMosi);   //!< one full-duplex byte, returns MISO
+	void *pContext;
+};
+
+struct simQspiStats
+{
+	u64 ullBytes;                       //!< bytes shifted, including word padding
+	u64 ullModeErrors;                  //!< bytes shifted to a selected slave in the wrong CPOL/CPHA
+	u64 ullRxUnderruns;                 //!< DRR reads with the Rx FIFO empty
+	u64 ullTxOverruns;                  //!< DTR writes with the Tx FIFO full
+	u64 ullSelectConflicts;             //!< bytes shifted with more than one slave selected
+};
+
+extern struct simQspiStats g_xSimQspiStats;
+
+void sim_init(void);
+u64 sim_time_ns(void);
+
+void sim_qspi_reset(void);
+void sim_qspi_attach(int nSlave, const struct simSpiSlave *pSlave);
+void sim_qspi_detach(int nSlave);
+void sim_qspi_set_transfer_bits(int nBits);
+u32 sim_qspi_read(u32 unOffset);
+void sim_qspi_write(u32 unOffset, u32 unValue);
+
+void sim_max31723_reset(void);
+void sim_max31723_set_temp(s16 nRaw);
+u8 sim_max31723_register(int nRegister);
+extern const struct simSpiSlave g_xSimMax31723Slave;
+
+void sim_max31855_reset(void);
+void sim_max31855_set(s16 nProbe, s16 nInternal, u8 uchFaults);
+void sim_max31855_set_frame(u32 unFrame);
+extern const struct simSpiSlave g_xSimMax31855Slave;
+
+void sim_flash_reset(void);
+extern const struct simSpiSlave g_xSimFlashSlave;
+
+void sim_uart_reset(void);
+u32 sim_uart_read(u32 unOffset);
+void sim_uart_write(u32 unOffset, u32 unValue);
+u64 sim_uart_tx_bytes(void);
+
+struct simReplayRecord                  //!< One "CAP ..." line of a capture (see ../../spi_capture.h)
+{
+	u32 unSequence;
+	u32 unTimestamp;
+	u32 unPeripheralAddressSPI;
+	u8 uchSlave;                        //!< slave select line (0 for captures made before it was recorded)
+	u8 uchMode;                         //!< SPI_CAPTURE_MODE_... bits
+	u16 uLength;
+	u8 *auchTx;
+	u8 *auchRx;
+};
+
+struct simReplayStats
+{
+	u64 ullMismatches;                  //!< MOSI bytes that differ from the captured TX
+	u64 ullOverruns;                    //!< bytes clocked past the end of the captured transaction
+	u64 ullUnderruns;                   //!< captured bytes never clocked on the captured controller and slave
+	u64 ullSkipped;                     //!< transactions on a controller the simulation has no model of
+};
+
+extern struct simReplayStats g_xSimReplayStats;
+
+int sim_replay_load(const char *sPath);
+int sim_replay_count(void);
+const struct simReplayRecord *sim_replay_record(int nIndex);
+int sim_replay_begin(const struct simReplayRecord *pRecord);
+void sim_replay_end(void);
+
+int sim_interrupt_raise(u32 unInterruptId);
+
+void sim_gpio_reset(void);
+u32 sim_gpio_read(int nGpio, u32 unOffset);
+void sim_gpio_write(int nGpio, u32 unOffset, u32 unValue);
+
+#endif /* SIM_BUS_H */
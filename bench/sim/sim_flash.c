@@ -0,0 +1,129 @@
+/** \file sim_flash.c ********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_flash.c
+ *         Description: SPI model of a small serial NOR flash (64 KB, Micron
+ *                      style JEDEC ID) on slave select line 1.
+ *
+ *                      Supports read ID, read status, write enable, page
+ *                      program (single and quad input), 4 KB sector erase
+ *                      and the fast, dual and quad output reads.  The data
+ *                      lanes are not modelled:  every command shifts bytes
+ *                      the same way, which is also what the core's FIFOs
+ *                      see.  Program and erase complete when the select
+ *                      line is released, so WIP never reads back set.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "sim_bus.h"
+
+#define SIM_FLASH_SIZE 0x10000
+#define SIM_FLASH_PAGE_SIZE 256
+#define SIM_FLASH_SECTOR_SIZE 4096
+
+struct simFlash
+{
+	u8 auchArray[SIM_FLASH_SIZE];
+	u8 auchPage[SIM_FLASH_PAGE_SIZE];   //!< program data latched until the select is released
+	int nPageBytes;
+	int nWriteEnabled;
+	u8 uchCommand;
+	int nByte;                          //!< bytes shifted since the select went active
+	u32 unAddress;
+};
+
+static struct simFlash g_xSimFlash;
+
+
+static void sim_flash_select(void *pContext, int nSelected)
+{
+	struct simFlash *pDevice = (struct simFlash *)pContext;
+	u32 unBase;
+	int i;
+
+	if(!nSelected && pDevice->nByte > 0 && pDevice->nWriteEnabled)
+	{
+		if((pDevice->uchCommand == 0x02 || pDevice->uchCommand == 0x32) && pDevice->nByte >= 4)
+		{
+			unBase = pDevice->unAddress & (SIM_FLASH_SIZE - 1) & ~(u32)(SIM_FLASH_PAGE_SIZE - 1);
+			for(i=0;i<pDevice->nPageBytes && i<SIM_FLASH_PAGE_SIZE;i++)
+				pDevice->auchArray[unBase + ((pDevice->unAddress + i) & (SIM_FLASH_PAGE_SIZE - 1))] &= pDevice->auchPage[i];
+			pDevice->nWriteEnabled = FALSE;
+		}
+		else if(pDevice->uchCommand == 0x20 && pDevice->nByte >= 4)
+		{
+			unBase = pDevice->unAddress & (SIM_FLASH_SIZE - 1) & ~(u32)(SIM_FLASH_SECTOR_SIZE - 1);
+			memset(&pDevice->auchArray[unBase], 0xFF, SIM_FLASH_SECTOR_SIZE);
+			pDevice->nWriteEnabled = FALSE;
+		}
+	}
+	if(!nSelected && pDevice->nByte == 1 && pDevice->uchCommand == 0x06)
+		pDevice->nWriteEnabled = TRUE;
+
+	pDevice->nByte = 0;
+	pDevice->nPageBytes = 0;
+	pDevice->unAddress = 0;
+}
+
+static u8 sim_flash_transfer(void *pContext, u8 uchMosi)
+{
+	struct simFlash *pDevice = (struct simFlash *)pContext;
+	static const u8 auchId[3] = { 0x20, 0xBA, 0x10 };   // Micron, 3 V, 64 KB
+	int nByte = pDevice->nByte++;
+	u8 uchMiso = 0xFF;
+
+	if(nByte == 0)
+	{
+		pDevice->uchCommand = uchMosi;
+		return(0xFF);
+	}
+
+	switch(pDevice->uchCommand)
+	{
+		case 0x9F:
+			if(nByte <= 3)
+				uchMiso = auchId[nByte - 1];
+			break;
+		case 0x05:
+			uchMiso = pDevice->nWriteEnabled ? 0x02 : 0x00;
+			break;
+		case 0x0B:
+		case 0x3B:
+		case 0x6B:
+		case 0x02:
+		case 0x32:
+		case 0x20:
+			if(nByte <= 3)
+				pDevice->unAddress = (pDevice->unAddress << 8) | uchMosi;
+			else if(pDevice->uchCommand == 0x02 || pDevice->uchCommand == 0x32)
+			{
+				if(pDevice->nPageBytes < SIM_FLASH_PAGE_SIZE)
+					pDevice->auchPage[pDevice->nPageBytes++] = uchMosi;
+			}
+			else if(pDevice->uchCommand != 0x20 && nByte >= 5)   // one dummy byte
+				uchMiso = pDevice->auchArray[(pDevice->unAddress + (u32)(nByte - 5)) & (SIM_FLASH_SIZE - 1)];
+			break;
+		default:
+			break;
+	}
+	return(uchMiso);
+}
+
+const struct simSpiSlave g_xSimFlashSlave =
+{
+	FALSE,      // active low select
+	0, 0,       // CPOL=0, CPHA=0
+	sim_flash_select,
+	sim_flash_transfer,
+	&g_xSimFlash
+};
+
+void sim_flash_reset(void)
+/**
+* \brief       Erased array, write enable latch clear.
+*/
+{
+	memset(&g_xSimFlash, 0, sizeof(g_xSimFlash));
+	memset(g_xSimFlash.auchArray, 0xFF, sizeof(g_xSimFlash.auchArray));
+}
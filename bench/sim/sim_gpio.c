@@ -0,0 +1,75 @@
+/** \file sim_gpio.c *********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_gpio.c
+ *         Description: AXI GPIO model (data and tri-state registers of two
+ *                      channels) and the XGpio driver functions the
+ *                      application uses, which access it through Xil_In32 /
+ *                      Xil_Out32 like the real driver.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xparameters.h"
+#include "xgpio.h"
+#include "sim_bus.h"
+
+#define SIM_GPIO_COUNT 2
+#define SIM_GPIO_REGISTERS 4            //!< DATA, TRI, DATA2, TRI2
+
+static u32 g_aunSimGpio[SIM_GPIO_COUNT][SIM_GPIO_REGISTERS];
+
+
+void sim_gpio_reset(void)
+{
+	int i;
+
+	memset(g_aunSimGpio, 0, sizeof(g_aunSimGpio));
+	for(i=0;i<SIM_GPIO_COUNT;i++)
+	{
+		g_aunSimGpio[i][1] = 0xFFFFFFFF;    // all inputs after reset
+		g_aunSimGpio[i][3] = 0xFFFFFFFF;
+	}
+}
+
+u32 sim_gpio_read(int nGpio, u32 unOffset)
+{
+	if(unOffset >= SIM_GPIO_REGISTERS * 4)
+		return(0);
+	return(g_aunSimGpio[nGpio][unOffset / 4]);
+}
+
+void sim_gpio_write(int nGpio, u32 unOffset, u32 unValue)
+{
+	if(unOffset < SIM_GPIO_REGISTERS * 4)
+		g_aunSimGpio[nGpio][unOffset / 4] = unValue;
+}
+
+int XGpio_Initialize(XGpio *InstancePtr, u16 DeviceId)
+{
+	memset(InstancePtr, 0, sizeof(*InstancePtr));
+	if(DeviceId == XPAR_AXI_GPIO_LED_DEVICE_ID)
+		InstancePtr->BaseAddress = XPAR_AXI_GPIO_LED_BASEADDR;
+	else if(DeviceId == XPAR_AXI_GPIO_OLED_DEVICE_ID)
+		InstancePtr->BaseAddress = XPAR_AXI_GPIO_OLED_BASEADDR;
+	else
+		return(XST_DEVICE_NOT_FOUND);
+	InstancePtr->IsDual = TRUE;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+	return(XST_SUCCESS);
+}
+
+void XGpio_SetDataDirection(XGpio *InstancePtr, unsigned Channel, u32 DirectionMask)
+{
+	Xil_Out32(InstancePtr->BaseAddress + (Channel - 1) * XGPIO_CHAN_OFFSET + XGPIO_TRI_OFFSET, DirectionMask);
+}
+
+u32 XGpio_DiscreteRead(XGpio *InstancePtr, unsigned Channel)
+{
+	return(Xil_In32(InstancePtr->BaseAddress + (Channel - 1) * XGPIO_CHAN_OFFSET + XGPIO_DATA_OFFSET));
+}
+
+void XGpio_DiscreteWrite(XGpio *InstancePtr, unsigned Channel, u32 Data)
+{
+	Xil_Out32(InstancePtr->BaseAddress + (Channel - 1) * XGPIO_CHAN_OFFSET + XGPIO_DATA_OFFSET, Data);
+}
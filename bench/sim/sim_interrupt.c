@@ -0,0 +1,37 @@
+/** \file sim_interrupt.c ***************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_interrupt.c
+ *         Description: Interrupt connections of the host build.  Handlers
+ *                      are recorded by interrupt id and only run when a
+ *                      bench case raises the interrupt with
+ *                      sim_interrupt_raise();  no model raises one itself.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include "xbasic_types.h"
+#include "interrupt_utilities.h"
+#include "sim_bus.h"
+
+#define SIM_INTERRUPTS 96               //!< GIC interrupt ids of the Zynq
+
+static Xil_InterruptHandler g_apfnSimInterruptHandlers[SIM_INTERRUPTS];
+static void *g_apSimInterruptRefs[SIM_INTERRUPTS];
+
+
+int interrupt_connect(u32 unInterruptId, Xil_InterruptHandler pfnHandler, void *pCallbackRef)
+{
+	if(unInterruptId >= SIM_INTERRUPTS)
+		return(XST_FAILURE);
+	g_apfnSimInterruptHandlers[unInterruptId] = pfnHandler;
+	g_apSimInterruptRefs[unInterruptId] = pCallbackRef;
+	return(XST_SUCCESS);
+}
+
+int sim_interrupt_raise(u32 unInterruptId)
+{
+	if(unInterruptId >= SIM_INTERRUPTS || g_apfnSimInterruptHandlers[unInterruptId] == NULL)
+		return(FALSE);
+	g_apfnSimInterruptHandlers[unInterruptId](g_apSimInterruptRefs[unInterruptId]);
+	return(TRUE);
+}
@@ -0,0 +1,101 @@
+/** \file sim_max31723.c *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_max31723.c
+ *         Description: SPI model of the MAX31723 register file.
+ *
+ *                      The first byte after CE goes high is the address
+ *                      (bit 7 set for a write); data bytes follow with the
+ *                      address auto-incrementing over registers 0x00-0x06.
+ *                      The temperature registers are read only and hold the
+ *                      value set with sim_max31723_set_temp().
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "sim_bus.h"
+
+#define MAX31723_REGISTERS 7
+
+struct simMax31723
+{
+	u8 auchRegisters[MAX31723_REGISTERS];   //!< config, T LSB, T MSB, THIGH LSB, THIGH MSB, TLOW LSB, TLOW MSB
+	int nSelected;
+	int nAddressPhase;
+	int nWrite;
+	u8 uchAddress;
+};
+
+static struct simMax31723 g_xSimMax31723;
+
+
+static void sim_max31723_select(void *pContext, int nSelected)
+{
+	struct simMax31723 *pDevice = (struct simMax31723 *)pContext;
+
+	pDevice->nSelected = nSelected;
+	pDevice->nAddressPhase = TRUE;
+}
+
+static u8 sim_max31723_transfer(void *pContext, u8 uchMosi)
+{
+	struct simMax31723 *pDevice = (struct simMax31723 *)pContext;
+	u8 uchMiso = 0x00;
+
+	if(pDevice->nAddressPhase)
+	{
+		pDevice->nAddressPhase = FALSE;
+		pDevice->nWrite = (uchMosi & 0x80) ? TRUE : FALSE;
+		pDevice->uchAddress = (u8)((uchMosi & 0x7F) % MAX31723_REGISTERS);
+		return(0x00);
+	}
+
+	if(pDevice->nWrite)
+	{
+		if(pDevice->uchAddress == 0x00)
+			pDevice->auchRegisters[0] = uchMosi & 0x1F;
+		else if(pDevice->uchAddress >= 0x03)
+			pDevice->auchRegisters[pDevice->uchAddress] = uchMosi;
+	}
+	else
+		uchMiso = pDevice->auchRegisters[pDevice->uchAddress];
+	pDevice->uchAddress = (u8)((pDevice->uchAddress + 1) % MAX31723_REGISTERS);
+	return(uchMiso);
+}
+
+const struct simSpiSlave g_xSimMax31723Slave =
+{
+	TRUE,       // CE active high
+	0, 1,       // CPOL=0, CPHA=1
+	sim_max31723_select,
+	sim_max31723_transfer,
+	&g_xSimMax31723
+};
+
+void sim_max31723_set_temp(s16 nRaw)
+/**
+* \brief       Set the temperature conversion result, in 1/16 degC.
+*/
+{
+	g_xSimMax31723.auchRegisters[1] = (u8)((nRaw & 0x0F) << 4);
+	g_xSimMax31723.auchRegisters[2] = (u8)((nRaw >> 4) & 0xFF);
+}
+
+u8 sim_max31723_register(int nRegister)
+/**
+* \brief       Register 0x00-0x06 as the part holds it.
+*/
+{
+	return(g_xSimMax31723.auchRegisters[nRegister % MAX31723_REGISTERS]);
+}
+
+void sim_max31723_reset(void)
+/**
+* \brief       Power-on state:  9-bit continuous, THIGH +80 degC, TLOW +75 degC, 25.0625 degC measured.
+*/
+{
+	memset(&g_xSimMax31723, 0, sizeof(g_xSimMax31723));
+	g_xSimMax31723.auchRegisters[4] = 0x50;
+	g_xSimMax31723.auchRegisters[6] = 0x4B;
+	sim_max31723_set_temp(25 * 16 + 1);
+}
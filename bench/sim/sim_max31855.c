@@ -0,0 +1,88 @@
+/** \file sim_max31855.c *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_max31855.c
+ *         Description: SPI model of the MAX31855 thermocouple converter.
+ *
+ *                      Every select shifts out the 32-bit frame MSB first,
+ *                      followed by zeros;  MOSI is ignored.  The frame is
+ *                      built from temperatures and fault bits with
+ *                      sim_max31855_set(), or given as is with
+ *                      sim_max31855_set_frame().  Not attached by
+ *                      sim_init():  a check puts it on a free slave.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "sim_bus.h"
+
+struct simMax31855
+{
+	u32 unFrame;
+	int nByte;                          //!< bytes shifted since the select went active
+};
+
+static struct simMax31855 g_xSimMax31855;
+
+
+static void sim_max31855_select(void *pContext, int nSelected)
+{
+	struct simMax31855 *pDevice = (struct simMax31855 *)pContext;
+
+	(void)nSelected;
+	pDevice->nByte = 0;
+}
+
+static u8 sim_max31855_transfer(void *pContext, u8 uchMosi)
+{
+	struct simMax31855 *pDevice = (struct simMax31855 *)pContext;
+	u8 uchMiso = 0x00;
+
+	(void)uchMosi;
+	if(pDevice->nByte < 4)
+		uchMiso = (u8)(pDevice->unFrame >> (24 - 8 * pDevice->nByte));
+	pDevice->nByte++;
+	return(uchMiso);
+}
+
+const struct simSpiSlave g_xSimMax31855Slave =
+{
+	FALSE,      // CS active low
+	0, 0,       // CPOL=0, CPHA=0
+	sim_max31855_select,
+	sim_max31855_transfer,
+	&g_xSimMax31855
+};
+
+void sim_max31855_set(s16 nProbe, s16 nInternal, u8 uchFaults)
+/**
+* \brief       Set the frame:  probe in 0.25 degC (14 bit), cold junction in 1/16 degC (12 bit) and
+*              the SCV/SCG/OC bits (D2:0).  D16 is set when any of them is.
+*/
+{
+	u32 unFrame;
+
+	unFrame = ((u32)nProbe & 0x3FFF) << 18;
+	unFrame |= ((u32)nInternal & 0x0FFF) << 4;
+	unFrame |= uchFaults & 0x07;
+	if(uchFaults & 0x07)
+		unFrame |= 0x00010000;
+	g_xSimMax31855.unFrame = unFrame;
+}
+
+void sim_max31855_set_frame(u32 unFrame)
+/**
+* \brief       Set the raw 32-bit frame, e.g. D16 without a fault bit.
+*/
+{
+	g_xSimMax31855.unFrame = unFrame;
+}
+
+void sim_max31855_reset(void)
+/**
+* \brief       25.00 degC on the probe, 24.0625 degC at the cold junction, no fault.
+*/
+{
+	memset(&g_xSimMax31855, 0, sizeof(g_xSimMax31855));
+	sim_max31855_set(25 * 4, 24 * 16 + 1, 0);
+}
@@ -0,0 +1,253 @@
+/** \file sim_qspi.c *********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_qspi.c
+ *         Description: Register model of the AXI Quad SPI core in standard
+ *                      SPI master mode with FIFOs and manual slave select.
+ *
+ *                      Words are shifted when the master is enabled and not
+ *                      inhibited, MSB first, 8, 16 or 32 bits each as set by
+ *                      sim_qspi_set_transfer_bits() (the core's
+ *                      C_NUM_TRANSFER_BITS).  The shift register stays busy
+ *                      for one SCK period per bit of simulated time, and SR
+ *                      Tx empty only reads back as set once that has passed.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "sim_bus.h"
+
+#define QSPI_SRR 0x40
+#define QSPI_CR 0x60
+#define QSPI_SR 0x64
+#define QSPI_DTR 0x68
+#define QSPI_DRR 0x6C
+#define QSPI_SSR 0x70
+#define QSPI_TX_OCY 0x74
+#define QSPI_RX_OCY 0x78
+
+#define QSPI_CR_SPE 0x002
+#define QSPI_CR_MASTER 0x004
+#define QSPI_CR_CPOL 0x008
+#define QSPI_CR_CPHA 0x010
+#define QSPI_CR_TXFIFO_RESET 0x020
+#define QSPI_CR_RXFIFO_RESET 0x040
+#define QSPI_CR_INHIBIT 0x100
+
+#define QSPI_SR_RX_EMPTY 0x01
+#define QSPI_SR_RX_FULL 0x02
+#define QSPI_SR_TX_EMPTY 0x04
+#define QSPI_SR_TX_FULL 0x08
+
+struct simQspi
+{
+	u32 unCR;
+	u32 unSSR;
+	int nTransferBytes;                 //!< 1, 2 or 4
+	u32 aunTx[SIM_SPI_FIFO_DEPTH];
+	int nTxCount;
+	u32 aunRx[SIM_SPI_FIFO_DEPTH];
+	int nRxHead, nRxCount;
+	u64 ullBusyUntilNs;                 //!< simulated time at which the last shifted byte completes
+	int anSelected[SIM_QSPI_SLAVES];
+	struct simSpiSlave axSlaves[SIM_QSPI_SLAVES];
+	int anAttached[SIM_QSPI_SLAVES];
+};
+
+static struct simQspi g_xQspi;
+struct simQspiStats g_xSimQspiStats;
+
+
+static int sim_qspi_slave_selected(int nSlave)
+{
+	int nLineHigh = (g_xQspi.unSSR >> nSlave) & 1;
+
+	return(g_xQspi.axSlaves[nSlave].nCsActiveHigh ? nLineHigh : !nLineHigh);
+}
+
+static void sim_qspi_update_selects(void)
+/**
+* \brief       Tell attached slaves about select line edges.
+*/
+{
+	int i, nSelected;
+
+	for(i=0;i<SIM_QSPI_SLAVES;i++)
+	{
+		if(!g_xQspi.anAttached[i])
+			continue;
+		nSelected = sim_qspi_slave_selected(i);
+		if(nSelected != g_xQspi.anSelected[i])
+		{
+			g_xQspi.anSelected[i] = nSelected;
+			g_xQspi.axSlaves[i].pfnSelect(g_xQspi.axSlaves[i].pContext, nSelected);
+		}
+	}
+}
+
+static void sim_qspi_shift(void)
+/**
+* \brief       Shift out the Tx FIFO if the master is running.
+*/
+{
+	u8 uchMiso;
+	u32 unMosiWord, unMisoWord;
+	int i, nWord, nByte, nSelected;
+	u64 ullByteNs = 8ULL * 1000000000ULL / SIM_SPI_SCK_HZ;
+	u32 unCpol = (g_xQspi.unCR & QSPI_CR_CPOL) ? 1 : 0;
+	u32 unCpha = (g_xQspi.unCR & QSPI_CR_CPHA) ? 1 : 0;
+
+	if((g_xQspi.unCR & (QSPI_CR_SPE | QSPI_CR_MASTER | QSPI_CR_INHIBIT)) != (QSPI_CR_SPE | QSPI_CR_MASTER))
+		return;
+
+	for(nWord=0;nWord<g_xQspi.nTxCount;nWord++)
+	{
+		unMosiWord = g_xQspi.aunTx[nWord];
+		unMisoWord = 0;
+		for(nByte=g_xQspi.nTransferBytes-1;nByte>=0;nByte--)
+		{
+			uchMiso = 0xFF;     // pulled up when nobody drives MISO
+			nSelected = 0;
+			for(i=0;i<SIM_QSPI_SLAVES;i++)
+			{
+				if(!g_xQspi.anAttached[i] || !g_xQspi.anSelected[i])
+					continue;
+				if(++nSelected == 2)
+					g_xSimQspiStats.ullSelectConflicts++;
+				if(g_xQspi.axSlaves[i].uchCpol != unCpol || g_xQspi.axSlaves[i].uchCpha != unCpha)
+					g_xSimQspiStats.ullModeErrors++;
+				uchMiso = g_xQspi.axSlaves[i].pfnTransfer(g_xQspi.axSlaves[i].pContext, (u8)(unMosiWord >> (8 * nByte)));
+			}
+			unMisoWord = (unMisoWord << 8) | uchMiso;
+			if(g_xQspi.ullBusyUntilNs < sim_time_ns())
+				g_xQspi.ullBusyUntilNs = sim_time_ns();
+			g_xQspi.ullBusyUntilNs += ullByteNs;
+			g_xSimQspiStats.ullBytes++;
+		}
+		if(g_xQspi.nRxCount < SIM_SPI_FIFO_DEPTH)
+		{
+			g_xQspi.aunRx[(g_xQspi.nRxHead + g_xQspi.nRxCount) % SIM_SPI_FIFO_DEPTH] = unMisoWord;
+			g_xQspi.nRxCount++;
+		}
+	}
+	g_xQspi.nTxCount = 0;
+}
+
+void sim_qspi_reset(void)
+{
+	struct simSpiSlave axSlaves[SIM_QSPI_SLAVES];
+	int anAttached[SIM_QSPI_SLAVES];
+	int nTransferBytes = g_xQspi.nTransferBytes ? g_xQspi.nTransferBytes : 1;
+
+	memcpy(axSlaves, g_xQspi.axSlaves, sizeof(axSlaves));
+	memcpy(anAttached, g_xQspi.anAttached, sizeof(anAttached));
+	memset(&g_xQspi, 0, sizeof(g_xQspi));
+	memcpy(g_xQspi.axSlaves, axSlaves, sizeof(axSlaves));
+	memcpy(g_xQspi.anAttached, anAttached, sizeof(anAttached));
+	g_xQspi.nTransferBytes = nTransferBytes;
+	memset(&g_xSimQspiStats, 0, sizeof(g_xSimQspiStats));
+	g_xQspi.unCR = 0x180;
+	g_xQspi.unSSR = 0xFFFFFFFF;
+	sim_qspi_update_selects();
+}
+
+void sim_qspi_attach(int nSlave, const struct simSpiSlave *pSlave)
+/**
+* \brief       Connect a device model to slave select line nSlave.
+*/
+{
+	g_xQspi.axSlaves[nSlave] = *pSlave;
+	g_xQspi.anAttached[nSlave] = TRUE;
+	g_xQspi.anSelected[nSlave] = FALSE;
+	sim_qspi_update_selects();
+}
+
+void sim_qspi_detach(int nSlave)
+/**
+* \brief       Disconnect the device model on slave select line nSlave.
+*/
+{
+	g_xQspi.anAttached[nSlave] = FALSE;
+	g_xQspi.anSelected[nSlave] = FALSE;
+}
+
+void sim_qspi_set_transfer_bits(int nBits)
+/**
+* \brief       Transfer width the simulated core was "built" with:  8, 16 or 32.
+*/
+{
+	g_xQspi.nTransferBytes = nBits / 8;
+}
+
+u32 sim_qspi_read(u32 unOffset)
+{
+	u32 unValue = 0;
+
+	switch(unOffset)
+	{
+		case QSPI_CR:
+			return(g_xQspi.unCR);
+		case QSPI_SR:
+			if(g_xQspi.nRxCount == 0)
+				unValue |= QSPI_SR_RX_EMPTY;
+			if(g_xQspi.nRxCount == SIM_SPI_FIFO_DEPTH)
+				unValue |= QSPI_SR_RX_FULL;
+			if(g_xQspi.nTxCount == 0 && sim_time_ns() >= g_xQspi.ullBusyUntilNs)
+				unValue |= QSPI_SR_TX_EMPTY;
+			if(g_xQspi.nTxCount == SIM_SPI_FIFO_DEPTH)
+				unValue |= QSPI_SR_TX_FULL;
+			return(unValue);
+		case QSPI_DRR:
+			if(g_xQspi.nRxCount == 0)
+			{
+				g_xSimQspiStats.ullRxUnderruns++;
+				return(0);
+			}
+			unValue = g_xQspi.aunRx[g_xQspi.nRxHead];
+			g_xQspi.nRxHead = (g_xQspi.nRxHead + 1) % SIM_SPI_FIFO_DEPTH;
+			g_xQspi.nRxCount--;
+			return(unValue);
+		case QSPI_SSR:
+			return(g_xQspi.unSSR);
+		case QSPI_TX_OCY:
+			return(g_xQspi.nTxCount ? (u32)(g_xQspi.nTxCount - 1) : 0);
+		case QSPI_RX_OCY:
+			return(g_xQspi.nRxCount ? (u32)(g_xQspi.nRxCount - 1) : 0);
+		default:
+			return(0);
+	}
+}
+
+void sim_qspi_write(u32 unOffset, u32 unValue)
+{
+	switch(unOffset)
+	{
+		case QSPI_SRR:
+			if(unValue == 0x0A)
+				sim_qspi_reset();
+			break;
+		case QSPI_CR:
+			if(unValue & QSPI_CR_TXFIFO_RESET)
+				g_xQspi.nTxCount = 0;
+			if(unValue & QSPI_CR_RXFIFO_RESET)
+				g_xQspi.nRxCount = 0;
+			g_xQspi.unCR = unValue & ~(QSPI_CR_TXFIFO_RESET | QSPI_CR_RXFIFO_RESET);
+			sim_qspi_shift();
+			break;
+		case QSPI_DTR:
+			if(g_xQspi.nTxCount == SIM_SPI_FIFO_DEPTH)
+			{
+				g_xSimQspiStats.ullTxOverruns++;
+				break;
+			}
+			g_xQspi.aunTx[g_xQspi.nTxCount++] = unValue;
+			sim_qspi_shift();
+			break;
+		case QSPI_SSR:
+			g_xQspi.unSSR = unValue;
+			sim_qspi_update_selects();
+			break;
+		default:
+			break;
+	}
+}
@@ -0,0 +1,176 @@
+/** \file sim_replay.c *******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_replay.c
+ *         Description: SPI slave that plays back a capture made with the CAP
+ *                      command.  sim_replay_begin() attaches it on the
+ *                      slave select line and in the mode of one captured
+ *                      transaction; while selected it returns the captured
+ *                      RX bytes and checks that the driver sends the
+ *                      captured TX bytes.  Bytes the driver sends to another
+ *                      slave never reach it and are counted as underruns by
+ *                      sim_replay_end().
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "sim_bus.h"
+#include "../../spi_capture.h"
+
+#define REPLAY_LINE_LENGTH (64 + 4 * SPI_CAPTURE_MAX_TRANSFER)
+
+struct simReplay
+{
+	struct simReplayRecord *axRecords;
+	int nCount;
+	const struct simReplayRecord *pCurrent;
+	int nPosition;                      //!< byte of pCurrent clocked next
+};
+
+static struct simReplay g_xSimReplay;
+struct simReplayStats g_xSimReplayStats;
+
+
+static void sim_replay_select(void *pContext, int nSelected)
+{
+	(void)pContext;
+	if(nSelected)
+		g_xSimReplay.nPosition = 0;
+}
+
+static u8 sim_replay_transfer(void *pContext, u8 uchMosi)
+{
+	const struct simReplayRecord *pRecord = g_xSimReplay.pCurrent;
+
+	(void)pContext;
+	if(pRecord == NULL || g_xSimReplay.nPosition >= pRecord->uLength)
+	{
+		g_xSimReplayStats.ullOverruns++;
+		return(0xFF);
+	}
+	if(uchMosi != pRecord->auchTx[g_xSimReplay.nPosition])
+		g_xSimReplayStats.ullMismatches++;
+	return(pRecord->auchRx[g_xSimReplay.nPosition++]);
+}
+
+static int sim_replay_parse_hex(const char *sHex, u8 *auchOut, int nLength)
+{
+	unsigned int unByte;
+	int i;
+
+	if((int)strlen(sHex) != 2 * nLength)
+		return(FALSE);
+	for(i=0;i<nLength;i++)
+	{
+		if(sscanf(sHex + 2 * i, "%2x", &unByte) != 1)
+			return(FALSE);
+		auchOut[i] = (u8)unByte;
+	}
+	return(TRUE);
+}
+
+int sim_replay_load(const char *sPath)
+/**
+* \brief       Read every "CAP ..." line of a file.  Other lines (replies, LOG records) are ignored.
+*
+* \retval      Number of transactions loaded, -1 if the file cannot be read
+*/
+{
+	FILE *pFile;
+	char sLine[REPLAY_LINE_LENGTH];
+	char sTx[2 * SPI_CAPTURE_MAX_TRANSFER + 1], sRx[2 * SPI_CAPTURE_MAX_TRANSFER + 1];
+	unsigned long ulSequence, ulTimestamp, ulAddress;
+	unsigned int unSlave, unMode, unLength;
+	struct simReplayRecord *pRecord;
+	int nCapacity = 0;
+
+	pFile = fopen(sPath, "r");
+	if(pFile == NULL)
+		return(-1);
+	while(fgets(sLine, sizeof(sLine), pFile) != NULL)
+	{
+		if(sscanf(sLine, "CAP %lx %lx %lx %x %x %x %256s %256s", &ulSequence, &ulTimestamp, &ulAddress,
+				&unSlave, &unMode, &unLength, sTx, sRx) != 8)
+		{
+			// Captures made before the slave was recorded have one field less and are taken as slave 0
+			unSlave = 0;
+			if(sscanf(sLine, "CAP %lx %lx %lx %x %x %256s %256s", &ulSequence, &ulTimestamp, &ulAddress,
+					&unMode, &unLength, sTx, sRx) != 7)
+				continue;
+		}
+		if(unLength == 0 || unLength > SPI_CAPTURE_MAX_TRANSFER)
+			continue;
+		if(g_xSimReplay.nCount == nCapacity)
+		{
+			nCapacity = nCapacity ? 2 * nCapacity : 64;
+			g_xSimReplay.axRecords = realloc(g_xSimReplay.axRecords, nCapacity * sizeof(struct simReplayRecord));
+		}
+		pRecord = &g_xSimReplay.axRecords[g_xSimReplay.nCount];
+		pRecord->unSequence = (u32)ulSequence;
+		pRecord->unTimestamp = (u32)ulTimestamp;
+		pRecord->unPeripheralAddressSPI = (u32)ulAddress;
+		pRecord->uchSlave = (u8)unSlave;
+		pRecord->uchMode = (u8)unMode;
+		pRecord->uLength = (u16)unLength;
+		pRecord->auchTx = malloc(2 * unLength);
+		pRecord->auchRx = pRecord->auchTx + unLength;
+		if(!sim_replay_parse_hex(sTx, pRecord->auchTx, unLength) || !sim_replay_parse_hex(sRx, pRecord->auchRx, unLength))
+		{
+			free(pRecord->auchTx);
+			continue;
+		}
+		g_xSimReplay.nCount++;
+	}
+	fclose(pFile);
+	return(g_xSimReplay.nCount);
+}
+
+int sim_replay_count(void)
+{
+	return(g_xSimReplay.nCount);
+}
+
+const struct simReplayRecord *sim_replay_record(int nIndex)
+{
+	return(&g_xSimReplay.axRecords[nIndex]);
+}
+
+int sim_replay_begin(const struct simReplayRecord *pRecord)
+/**
+* \brief       Put the replay slave on the slave select line of pRecord, in its mode, serving its bytes.
+*
+* \retval      FALSE (and counted as skipped) if pRecord is not on the simulated AXI Quad SPI
+*/
+{
+	struct simSpiSlave xSlave;
+
+	g_xSimReplay.pCurrent = NULL;
+	if(pRecord->unPeripheralAddressSPI != XPAR_AXI_QUAD_SPI_0_BASEADDR || pRecord->uchSlave >= SIM_QSPI_SLAVES)
+	{
+		g_xSimReplayStats.ullSkipped++;
+		return(FALSE);
+	}
+	xSlave.nCsActiveHigh = (pRecord->uchMode & SPI_CAPTURE_MODE_CS_HIGH) ? TRUE : FALSE;
+	xSlave.uchCpol = (pRecord->uchMode & SPI_CAPTURE_MODE_CPOL) ? 1 : 0;
+	xSlave.uchCpha = (pRecord->uchMode & SPI_CAPTURE_MODE_CPHA) ? 1 : 0;
+	xSlave.pfnSelect = sim_replay_select;
+	xSlave.pfnTransfer = sim_replay_transfer;
+	xSlave.pContext = &g_xSimReplay;
+	g_xSimReplay.pCurrent = pRecord;
+	g_xSimReplay.nPosition = 0;
+	sim_qspi_attach(pRecord->uchSlave, &xSlave);
+	return(TRUE);
+}
+
+void sim_replay_end(void)
+/**
+* \brief       Count the bytes of the current transaction that the driver did not clock on its slave.
+*/
+{
+	if(g_xSimReplay.pCurrent != NULL && g_xSimReplay.nPosition < g_xSimReplay.pCurrent->uLength)
+		g_xSimReplayStats.ullUnderruns += (u64)(g_xSimReplay.pCurrent->uLength - g_xSimReplay.nPosition);
+	g_xSimReplay.pCurrent = NULL;
+}
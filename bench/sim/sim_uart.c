@@ -0,0 +1,78 @@
+/** \file sim_uart.c *********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sim_uart.c
+ *         Description: PS UART model:  the channel status register and the
+ *                      Tx FIFO.  The FIFO drains at SIM_UART_BAUD in
+ *                      simulated time; nothing is ever received.
+ *
+ * ------------------------------------------------------------------------- */
+
+#include "sim_bus.h"
+
+#define UART_SR 0x2C
+#define UART_FIFO 0x30
+
+#define UART_SR_RXEMPTY 0x02
+#define UART_SR_TXEMPTY 0x08
+#define UART_SR_TXFULL 0x10
+
+#define UART_CHARACTER_NS (10ULL * 1000000000ULL / SIM_UART_BAUD)
+
+struct simUart
+{
+	u64 ullTxDoneNs;                    //!< simulated time at which the last queued character has left
+	u64 ullTxBytes;
+};
+
+static struct simUart g_xSimUart;
+
+
+static u32 sim_uart_tx_level(void)
+{
+	u64 ullNow = sim_time_ns();
+
+	if(g_xSimUart.ullTxDoneNs <= ullNow)
+		return(0);
+	return((u32)((g_xSimUart.ullTxDoneNs - ullNow + UART_CHARACTER_NS - 1) / UART_CHARACTER_NS));
+}
+
+void sim_uart_reset(void)
+{
+	g_xSimUart.ullTxDoneNs = 0;
+	g_xSimUart.ullTxBytes = 0;
+}
+
+u32 sim_uart_read(u32 unOffset)
+{
+	u32 unLevel;
+	u32 unValue = UART_SR_RXEMPTY;
+
+	if(unOffset != UART_SR)
+		return(0);
+	unLevel = sim_uart_tx_level();
+	if(unLevel == 0)
+		unValue |= UART_SR_TXEMPTY;
+	if(unLevel >= SIM_UART_FIFO_DEPTH)
+		unValue |= UART_SR_TXFULL;
+	return(unValue);
+}
+
+void sim_uart_write(u32 unOffset, u32 unValue)
+{
+	(void)unValue;
+	if(unOffset != UART_FIFO || sim_uart_tx_level() >= SIM_UART_FIFO_DEPTH)
+		return;
+	if(g_xSimUart.ullTxDoneNs < sim_time_ns())
+		g_xSimUart.ullTxDoneNs = sim_time_ns();
+	g_xSimUart.ullTxDoneNs += UART_CHARACTER_NS;
+	g_xSimUart.ullTxBytes++;
+}
+
+u64 sim_uart_tx_bytes(void)
+/**
+* \brief       Characters accepted into the Tx FIFO since the last reset.
+*/
+{
+	return(g_xSimUart.ullTxBytes);
+}
@@ -0,0 +1,15 @@
+/** \file xbasic_types.h ********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xbasic_types.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name (see bench/Makefile).
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XBASIC_TYPES_H
+#define XBASIC_TYPES_H
+
+#include "xil_types.h"
+
+#endif /* XBASIC_TYPES_H */
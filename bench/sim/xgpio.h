@@ -0,0 +1,30 @@
+/** \file xgpio.h ***************************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xgpio.h
+ *         Description: Host build stand-in for the Xilinx AXI GPIO driver.  The
+ *                      functions (sim_gpio.c) access the simulated registers
+ *                      the same way the real driver does.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XGPIO_H
+#define XGPIO_H
+
+#include "xil_types.h"
+#include "xgpio_l.h"
+
+typedef struct
+{
+	UINTPTR BaseAddress;
+	u32 IsReady;
+	int InterruptPresent;
+	int IsDual;
+} XGpio;
+
+int XGpio_Initialize(XGpio *InstancePtr, u16 DeviceId);
+void XGpio_SetDataDirection(XGpio *InstancePtr, unsigned Channel, u32 DirectionMask);
+u32 XGpio_DiscreteRead(XGpio *InstancePtr, unsigned Channel);
+void XGpio_DiscreteWrite(XGpio *InstancePtr, unsigned Channel, u32 Data);
+
+#endif /* XGPIO_H */
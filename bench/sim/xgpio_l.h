@@ -0,0 +1,20 @@
+/** \file xgpio_l.h *************************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xgpio_l.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XGPIO_L_H
+#define XGPIO_L_H
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#define XGPIO_DATA_OFFSET 0x0
+#define XGPIO_TRI_OFFSET 0x4
+#define XGPIO_CHAN_OFFSET 0x8
+
+#endif /* XGPIO_L_H */
@@ -0,0 +1,24 @@
+/** \file xil_exception.h *******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xil_exception.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name.  The host has no exceptions to mask;  the handler
+ *                      types are all the drivers need.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XIL_EXCEPTION_H
+#define XIL_EXCEPTION_H
+
+#include "xil_types.h"
+
+typedef void (*Xil_ExceptionHandler)(void *data);
+typedef void (*Xil_InterruptHandler)(void *data);
+
+#define XIL_EXCEPTION_IRQ 0x80        //!< CPSR I bit
+
+#define Xil_ExceptionEnable() do { } while(0)
+#define Xil_ExceptionDisable() do { } while(0)
+
+#endif /* XIL_EXCEPTION_H */
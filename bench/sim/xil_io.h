@@ -0,0 +1,23 @@
+/** \file xil_io.h **************************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xil_io.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name.  The accessors are implemented by the simulated
+ *                      bus in sim_bus.c.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+u8 Xil_In8(UINTPTR Addr);
+u16 Xil_In16(UINTPTR Addr);
+u32 Xil_In32(UINTPTR Addr);
+void Xil_Out8(UINTPTR Addr, u8 Value);
+void Xil_Out16(UINTPTR Addr, u16 Value);
+void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#endif /* XIL_IO_H */
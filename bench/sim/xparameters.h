@@ -0,0 +1,28 @@
+/** \file xparameters.h *********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xparameters.h
+ *         Description: Host build stand-in for the generated BSP parameters:
+ *                      the peripherals present in the simulated system.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_CPU_CORTEXA9_CORE_CLOCK_FREQ_HZ 666666687
+
+#define XPAR_AXI_QUAD_SPI_0_DEVICE_ID 0
+#define XPAR_AXI_QUAD_SPI_0_BASEADDR 0x41E00000
+#define XPAR_AXI_QUAD_SPI_0_HIGHADDR 0x41E0FFFF
+#define XPAR_AXI_QUAD_SPI_0_NUM_TRANSFER_BITS 8
+
+#define XPAR_AXI_GPIO_LED_DEVICE_ID 1
+#define XPAR_AXI_GPIO_LED_BASEADDR 0x41200000
+#define XPAR_AXI_GPIO_OLED_DEVICE_ID 2
+#define XPAR_AXI_GPIO_OLED_BASEADDR 0x41210000
+
+#define XPAR_XUARTPS_0_BASEADDR 0xE0001000
+#define XPAR_PS7_UART_1_BASEADDR 0xE0001000
+
+#endif /* XPARAMETERS_H */
@@ -0,0 +1,19 @@
+/** \file xpseudo_asm.h *******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xpseudo_asm.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name.  The host has no CPSR:  it reads as 0 and writes
+ *                      are dropped.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XPSEUDO_ASM_H
+#define XPSEUDO_ASM_H
+
+#include "xil_types.h"
+
+#define mfcpsr() ((u32)0)
+#define mtcpsr(v) ((void)(v))
+
+#endif /* XPSEUDO_ASM_H */
@@ -0,0 +1,21 @@
+/** \file xscugic.h *************************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xscugic.h
+ *         Description: Host build stand-in for the Xilinx GIC driver header.
+ *                      interrupt_connect() is implemented by sim_interrupt.c.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XSCUGIC_H
+#define XSCUGIC_H
+
+#include "xil_types.h"
+#include "xil_exception.h"
+
+typedef struct
+{
+	u32 IsReady;
+} XScuGic;
+
+#endif /* XSCUGIC_H */
@@ -0,0 +1,17 @@
+/** \file xspi_l.h **************************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xspi_l.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name.  The register accessors themselves are in
+ *                      spi_utilities.h.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XSPI_L_H
+#define XSPI_L_H
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#endif /* XSPI_L_H */
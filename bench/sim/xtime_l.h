@@ -0,0 +1,26 @@
+/** \file xtime_l.h *************************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: xtime_l.h
+ *         Description: Host build stand-in for the Xilinx BSP header of the same
+ *                      name.  XTime_GetTime() follows the host monotonic
+ *                      clock at the Zynq global timer rate.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef XTIME_L_H
+#define XTIME_L_H
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+typedef u64 XTime;
+
+#define GLOBAL_TMR_BASEADDR 0xF8F00200
+#define GTIMER_COUNTER_LOWER_OFFSET 0x00
+#define GTIMER_COUNTER_UPPER_OFFSET 0x04
+#define COUNTS_PER_SECOND (XPAR_CPU_CORTEXA9_CORE_CLOCK_FREQ_HZ / 2)
+
+void XTime_GetTime(XTime *Xtime_Global);
+
+#endif /* XTIME_L_H */
@@ -0,0 +1,340 @@
+/** \file bench_utilities.c **************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: bench_utilities.c
+ *         Description: Benchmark suite for the driver hot paths
+ *                      (see bench_utilities.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "spi_utilities.h"
+#include "spi_backend.h"
+#include "uart_utilities.h"
+#include "max31723_utilities.h"
+#include "oled_utilities.h"
+#include "bench_utilities.h"
+#include "mmio_utilities.h"
+#include "qspi_flash_utilities.h"
+#include "spi_fixed.h"
+#include "fixed_point_utilities.h"
+#include "sample_store.h"
+
+#define BENCH_UART_PAYLOAD 64           //!< Bytes per uart_tx iteration, one full Tx FIFO
+
+struct maximBenchContext
+{
+	u32 unPeripheralAddressSPI;
+	u32 unUartAddress;
+	u8 auchTx[256];
+	u8 auchRx[256];
+	char sText[32];
+	s16 nRaw;
+	struct maximQspiFlash xFlash;       //!< flash on QSPI_FLASH_SLAVE (reads 0xFF when none is fitted)
+	struct maximSampleStore xStore;
+};
+
+struct maximBenchCase
+{
+	const char *sName;
+	u32 unIterations;
+	void (*pfnRun)(struct maximBenchContext *pCtx);
+};
+
+// Same device as the spi_rw_ cases, specialized at compile time (see spi_fixed.h)
+SPI_FIXED_DEVICE(bench_spi, 0, 1, 0, TRUE)
+
+static u8 g_auchBenchFont[128 * 8];     // blank glyphs: rendering cost does not depend on the pixels
+static volatile u32 g_unBenchSink;      // keeps results of pure computations alive
+
+
+// Lengths are rounded up to whole words:  a core wider than 8 bits refuses a partial last word
+static void bench_spi_rw_1(struct maximBenchContext *pCtx)
+{
+	SpiRW(pCtx->unPeripheralAddressSPI, 1, 0, pCtx->auchTx, pCtx->auchRx,
+			SPI_ALIGN_BYTES(1, spi_word_bytes(pCtx->unPeripheralAddressSPI)), 1);
+}
+
+static void bench_spi_rw_3(struct maximBenchContext *pCtx)
+{
+	SpiRW(pCtx->unPeripheralAddressSPI, 1, 0, pCtx->auchTx, pCtx->auchRx,
+			SPI_ALIGN_BYTES(3, spi_word_bytes(pCtx->unPeripheralAddressSPI)), 1);
+}
+
+static void bench_spi_rw_16(struct maximBenchContext *pCtx)
+{
+	SpiRW(pCtx->unPeripheralAddressSPI, 1, 0, pCtx->auchTx, pCtx->auchRx, 16, 1);
+}
+
+static void bench_spi_rw_256(struct maximBenchContext *pCtx)
+{
+	SpiRW(pCtx->unPeripheralAddressSPI, 1, 0, pCtx->auchTx, pCtx->auchRx, 256, 1);
+}
+
+static void bench_spi_fixed_1(struct maximBenchContext *pCtx)
+{
+	bench_spi_rw(pCtx->unPeripheralAddressSPI, pCtx->auchTx, pCtx->auchRx, SPI_ALIGN_BYTES(1, SPI_FIXED_WORD_BYTES));
+}
+
+static void bench_spi_fixed_3(struct maximBenchContext *pCtx)
+{
+	bench_spi_rw(pCtx->unPeripheralAddressSPI, pCtx->auchTx, pCtx->auchRx, SPI_ALIGN_BYTES(3, SPI_FIXED_WORD_BYTES));
+}
+
+static void bench_spi_fixed_16(struct maximBenchContext *pCtx)
+{
+	bench_spi_rw(pCtx->unPeripheralAddressSPI, pCtx->auchTx, pCtx->auchRx, 16);
+}
+
+static void bench_spi_fixed_256(struct maximBenchContext *pCtx)
+{
+	bench_spi_rw(pCtx->unPeripheralAddressSPI, pCtx->auchTx, pCtx->auchRx, 256);
+}
+
+static void bench_spi_run_all_4(struct maximBenchContext *pCtx)
+/**
+* \brief       Four 3 byte transfers queued through spi_transfer_run_all() on the one controller.
+*/
+{
+	struct spiTransfer axTransfers[4];
+	int nLength = SPI_ALIGN_BYTES(3, spi_word_bytes(pCtx->unPeripheralAddressSPI));
+	int i;
+
+	for(i=0;i<4;i++)
+		spi_transfer_setup(&axTransfers[i], pCtx->unPeripheralAddressSPI, 0, 1, 0, pCtx->auchTx, &pCtx->auchRx[4 * i],
+				nLength, TRUE);
+	spi_transfer_run_all(axTransfers, 4);
+}
+
+static void bench_max31723_read(struct maximBenchContext *pCtx)
+{
+	max_MAX31723_read_raw(&pCtx->nRaw, pCtx->unPeripheralAddressSPI, MAX31723_TEMP_READ);
+}
+
+static void bench_max31723_burst(struct maximBenchContext *pCtx)
+/**
+* \brief       Configuration, temperature and both alarms in one auto-incrementing transfer.
+*/
+{
+	pCtx->auchTx[0] = MAX31723_CONFIG_READ;
+	SpiRW(pCtx->unPeripheralAddressSPI, 1, 0, pCtx->auchTx, pCtx->auchRx, 8, 1);
+	pCtx->auchTx[0] = 0x00;
+	pCtx->nRaw = (s16)(((s8)pCtx->auchRx[3]) * 16 + (pCtx->auchRx[2] >> 4));
+	g_unBenchSink = pCtx->auchRx[1] + pCtx->auchRx[5] + pCtx->auchRx[7];
+}
+
+static void bench_flash_read_256(struct maximBenchContext *pCtx)
+{
+	qspi_flash_read(&pCtx->xFlash, 0, pCtx->auchRx, 256);
+}
+
+static void bench_oled_refresh_full(struct maximBenchContext *pCtx)
+{
+	(void)pCtx;
+	displayOLEDBuffer(g_structureOLED.flippedBuffer);
+}
+
+static void bench_oled_refresh_page(struct maximBenchContext *pCtx)
+{
+	(void)pCtx;
+	displayOLEDPages(g_structureOLED.flippedBuffer, 1, 1);
+}
+
+static void bench_oled_flip(struct maximBenchContext *pCtx)
+{
+	(void)pCtx;
+	flipAndCopyDisplayBuffer(g_structureOLED.writeBuffer, g_structureOLED.flippedBuffer);
+}
+
+static void bench_oled_render(struct maximBenchContext *pCtx)
+{
+	(void)pCtx;
+	printfToBufferOLED(0, 0, "Temp:  25.0625 C");
+}
+
+static void bench_format_float(struct maximBenchContext *pCtx)
+{
+	pCtx->nRaw = (s16)(pCtx->nRaw + 1);
+	snprintf(pCtx->sText, sizeof(pCtx->sText), "%.4f", (float)pCtx->nRaw / 16.0f);
+	g_unBenchSink = (u8)pCtx->sText[0];
+}
+
+static void bench_format_fixed(struct maximBenchContext *pCtx)
+{
+	pCtx->nRaw = (s16)(pCtx->nRaw + 1);
+	q4_format(pCtx->sText, pCtx->nRaw, 4);
+	g_unBenchSink = (u8)pCtx->sText[0];
+}
+
+static void bench_store_add(struct maximBenchContext *pCtx)
+{
+	pCtx->nRaw = (s16)(pCtx->nRaw + 1);
+	sample_store_add_raw(&pCtx->xStore, (s16)(400 + (pCtx->nRaw & 0x1F)), 0);
+}
+
+static void bench_store_stats(struct maximBenchContext *pCtx)
+{
+	struct maximSampleStats xStats;
+
+	sample_store_stats(&pCtx->xStore, &xStats);
+	g_unBenchSink = (u8)xStats.nStdDev;
+}
+
+static void bench_uart_tx(struct maximBenchContext *pCtx)
+{
+	sendUartBuffer(pCtx->unUartAddress, pCtx->auchTx, BENCH_UART_PAYLOAD);
+}
+
+static const struct maximBenchCase g_axBenchCases[] =
+{
+	{ "spi_rw_1",           1000,   bench_spi_rw_1 },
+	{ "spi_rw_3",           1000,   bench_spi_rw_3 },
+	{ "spi_rw_16",          1000,   bench_spi_rw_16 },
+	{ "spi_rw_256",         100,    bench_spi_rw_256 },
+	{ "spi_fixed_1",        1000,   bench_spi_fixed_1 },
+	{ "spi_fixed_3",        1000,   bench_spi_fixed_3 },
+	{ "spi_fixed_16",       1000,   bench_spi_fixed_16 },
+	{ "spi_fixed_256",      100,    bench_spi_fixed_256 },
+	{ "spi_run_all_4",      1000,   bench_spi_run_all_4 },
+	{ "max31723_read",      1000,   bench_max31723_read },
+	{ "max31723_burst",     1000,   bench_max31723_burst },
+	{ "flash_read_256",     100,    bench_flash_read_256 },
+	{ "oled_refresh_full",  10,     bench_oled_refresh_full },
+	{ "oled_refresh_page",  10,     bench_oled_refresh_page },
+	{ "oled_flip",          100,    bench_oled_flip },
+	{ "oled_render",        100,    bench_oled_render },
+	{ "format_float",       1000,   bench_format_float },
+	{ "format_fixed",       1000,   bench_format_fixed },
+	{ "store_add",          1000,   bench_store_add },
+	{ "store_stats",        1000,   bench_store_stats },
+	{ "uart_tx_64",         10,     bench_uart_tx },
+};
+
+#define BENCH_CASE_COUNT ((int)(sizeof(g_axBenchCases) / sizeof(g_axBenchCases[0])))
+
+#if !BENCH_HOST
+int bench_counters_read(struct maximBenchCounters *pCounters)
+/**
+* \brief       Platform MMIO and bus time counters.
+* \par         Details
+*              The board has no bus time counter.  MMIO accesses are counted when the build has
+*              MMIO_TRACE_ENABLED=1; UART and timer accesses are not routed through that layer.
+*
+* \retval      BENCH_COUNTERS_... bits of the counters filled in
+*/
+{
+	memset(pCounters, 0, sizeof(*pCounters));
+#if MMIO_TRACE_ENABLED
+	pCounters->ullMmioReads = g_xMmio.ullReads;
+	pCounters->ullMmioWrites = g_xMmio.ullWrites;
+	return(BENCH_COUNTERS_MMIO);
+#else
+	return(0);
+#endif
+}
+#endif
+
+static void bench_print_count(const char *sKey, int nValid, u64 ullValue)
+{
+	if(nValid)
+		printf(" %s=%llu", sKey, (unsigned long long)ullValue);
+	else
+		printf(" %s=na", sKey);
+}
+
+int bench_run(u32 unPeripheralAddressSPI, u32 unUartAddress, const char *sFilter,
+		struct maximBenchResult *axResults, int nMaxResults)
+/**
+* \brief       Run every case whose name contains sFilter and print one result line each.
+* \par         Details
+*              Each case runs a fixed number of iterations so totals stay comparable between
+*              runs.  The OLED buffers are used as they are; the OLED is initialized with a blank
+*              font first if nobody has initialized it yet.  uart_tx_64 writes raw bytes to the
+*              console UART.
+*
+* \param[in]   unPeripheralAddressSPI   - SPI peripheral with the MAX31723
+* \param[in]   unUartAddress            - console UART
+* \param[in]   *sFilter                 - substring of the case names to run, NULL or "" for all
+* \param[out]  *axResults               - results are also stored here when not NULL
+* \param[in]   nMaxResults              - size of axResults
+*
+* \retval      Number of cases run
+*/
+{
+	static struct maximBenchContext xCtx;
+	struct maximBenchCounters xBefore, xAfter;
+	struct maximBenchResult xResult;
+	u64 ullStart;
+	int nCountersValid;
+	int nCases = 0;
+	int i;
+	u32 j;
+
+	memset(&xCtx, 0, sizeof(xCtx));
+	xCtx.unPeripheralAddressSPI = unPeripheralAddressSPI;
+	xCtx.unUartAddress = unUartAddress;
+	for(i=0;i<BENCH_UART_PAYLOAD;i++)
+		xCtx.auchTx[i] = (i < BENCH_UART_PAYLOAD-2) ? 'U' : ((i == BENCH_UART_PAYLOAD-2) ? '\r' : '\n');
+	if(g_structureOLED.font == NULL)
+		initializeOLED(g_auchBenchFont);
+	spi_set_slave_polarity(unPeripheralAddressSPI, 0, TRUE);    // MAX31723 CE, before the flash is selected
+	qspi_flash_init(&xCtx.xFlash, unPeripheralAddressSPI, QSPI_FLASH_SLAVE, QSPI_FLASH_MODE_STANDARD);
+	sample_store_init(&xCtx.xStore);
+
+	nCountersValid = bench_counters_read(&xBefore);
+	printf("# BENCH v1 platform=%s counters=%s\r\n", BENCH_HOST ? "host" : "target",
+			(nCountersValid & BENCH_COUNTERS_BUS) ? "sim" : ((nCountersValid & BENCH_COUNTERS_MMIO) ? "mmio" : "none"));
+
+	for(i=0;i<BENCH_CASE_COUNT;i++)
+	{
+		if(sFilter != NULL && strstr(g_axBenchCases[i].sName, sFilter) == NULL)
+			continue;
+
+		bench_counters_read(&xBefore);
+		ullStart = get_time_ticks();
+		for(j=0;j<g_axBenchCases[i].unIterations;j++)
+			g_axBenchCases[i].pfnRun(&xCtx);
+		xResult.ullWallNs = (get_time_ticks() - ullStart) * 1000000000ULL / TICKS_PER_SECOND;
+		bench_counters_read(&xAfter);
+
+		xResult.sName = g_axBenchCases[i].sName;
+		xResult.unIterations = g_axBenchCases[i].unIterations;
+		xResult.nCountersValid = nCountersValid;
+		xResult.xCounters.ullMmioReads = xAfter.ullMmioReads - xBefore.ullMmioReads;
+		xResult.xCounters.ullMmioWrites = xAfter.ullMmioWrites - xBefore.ullMmioWrites;
+		xResult.xCounters.ullBusNs = xAfter.ullBusNs - xBefore.ullBusNs;
+
+		printf("BENCH case=%s iters=%lu wall_ns=%llu", xResult.sName, (unsigned long)xResult.unIterations,
+				(unsigned long long)xResult.ullWallNs);
+		bench_print_count("mmio_rd", nCountersValid & BENCH_COUNTERS_MMIO, xResult.xCounters.ullMmioReads);
+		bench_print_count("mmio_wr", nCountersValid & BENCH_COUNTERS_MMIO, xResult.xCounters.ullMmioWrites);
+		bench_print_count("bus_ns", nCountersValid & BENCH_COUNTERS_BUS, xResult.xCounters.ullBusNs);
+		printf("\r\n");
+		fflush(stdout);
+
+		if(axResults != NULL && nCases < nMaxResults)
+			axResults[nCases] = xResult;
+		nCases++;
+	}
+	printf("# BENCH END cases=%d\r\n", nCases);
+	fflush(stdout);
+	return(nCases);
+}
@@ -0,0 +1,75 @@
+/** \file bench_utilities.h **************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: bench_utilities.h
+ *         Description: Benchmark suite for the driver hot paths.  The same
+ *                      cases run on the board (BENCH command) and in the host
+ *                      build in bench/, where the peripherals are simulated
+ *                      and MMIO accesses and bus time are counted.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef BENCH_UTILITIES_H_
+#define BENCH_UTILITIES_H_
+
+#include "xbasic_types.h"
+
+#ifndef BENCH_HOST
+#define BENCH_HOST 0                    //!< 1 in the bench/ host build, which supplies bench_counters_read()
+#endif
+
+/*
+ * Output, one line per case:
+ *
+ *   # BENCH v1 platform=<host|target> counters=<sim|mmio|none>
+ *   BENCH case=<name> iters=<n> wall_ns=<n> mmio_rd=<n> mmio_wr=<n> bus_ns=<n>
+ *   # BENCH END cases=<n>
+ *
+ * All values are totals over iters.  mmio_rd, mmio_wr and bus_ns are "na" when the platform
+ * cannot count them:  the host build counts all three (counters=sim), a target build with
+ * MMIO_TRACE_ENABLED=1 counts SPI register and GPIO accesses only (counters=mmio).  In the
+ * host build they are deterministic, so bench/ compares them exactly against a baseline;
+ * wall_ns is informative only.
+ */
+
+#define BENCH_MAX_CASES 24              //!< Result slots needed for the whole suite
+
+#define BENCH_COUNTERS_MMIO 0x01        //!< bench_counters_read() filled ullMmioReads and ullMmioWrites
+#define BENCH_COUNTERS_BUS 0x02         //!< bench_counters_read() filled ullBusNs
+
+struct maximBenchCounters               //!< Platform counters sampled around each case
+{
+	u64 ullMmioReads;
+	u64 ullMmioWrites;
+	u64 ullBusNs;                       //!< simulated bus and peripheral time
+};
+
+struct maximBenchResult
+{
+	const char *sName;
+	u32 unIterations;
+	u64 ullWallNs;
+	int nCountersValid;                 //!< BENCH_COUNTERS_... bits
+	struct maximBenchCounters xCounters;
+};
+
+int bench_counters_read(struct maximBenchCounters *pCounters);
+int bench_run(u32 unPeripheralAddressSPI, u32 unUartAddress, const char *sFilter,
+		struct maximBenchResult *axResults, int nMaxResults);
+
+#endif /* BENCH_UTILITIES_H_ */
@@ -0,0 +1,1079 @@
+/** \file command_utilities.c ************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: command_utilities.c
+ *         Description: Line oriented command interface for automated test
+ *                      rigs.  Commands are collected from the UART Rx FIFO
+ *                      without blocking and answered with one machine
+ *                      readable "OK ..." or "ERR ..." line each.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "uart_utilities.h"
+#include "max31723_utilities.h"
+#include "log_utilities.h"
+#include "command_utilities.h"
+#include "memory_sections.h"
+#include "mmu_utilities.h"
+#include "profile_utilities.h"
+#include "bench_utilities.h"
+#include "mmio_utilities.h"
+#include "spi_capture.h"
+#include "spi_utilities.h"
+#include "qspi_flash_utilities.h"
+#include "fixed_point_utilities.h"
+#include "max31723_cache.h"
+
+
+static void cmd_reply_error(struct maximCommandInterface *pCmd, const char *sReason)
+/**
+* \brief       Send an "ERR <reason>" reply and count it.
+*
+* \param[in]   *pCmd        - command interface instance
+* \param[in]   *sReason     - single word describing the error
+*
+* \retval      None
+*/
+{
+	pCmd->unErrorCount++;
+	printf("ERR %s\r\n", sReason);
+	fflush(stdout);
+}
+
+static int cmd_tokenize(char *sLine, char *asTokens[])
+/**
+* \brief       Split a command line in place into upper case, space separated words.
+*
+* \param[in]   *sLine       - null terminated command line (modified)
+* \param[out]  asTokens     - array of CMD_MAX_TOKENS pointers into sLine
+*
+* \retval      Number of words found, or -1 if there are more than CMD_MAX_TOKENS
+*/
+{
+	int nTokens=0;
+	char *p=sLine;
+
+	while(*p != '\0')
+	{
+		while(*p == ' ' || *p == '\t')
+			*p++ = '\0';
+		if(*p == '\0')
+			break;
+		if(nTokens == CMD_MAX_TOKENS)
+			return(-1);
+		asTokens[nTokens++] = p;
+		while(*p != '\0' && *p != ' ' && *p != '\t')
+		{
+			if(*p >= 'a' && *p <= 'z')
+				*p -= 32;  // convert lowercase to uppercase
+			p++;
+		}
+	}
+	return(nTokens);
+}
+
+static int cmd_parse_int(const char *sToken, long *plValue, const char **psSuffix)
+/**
+* \brief       Parse a decimal integer, optionally followed by a unit suffix.
+*
+* \param[in]   *sToken      - token to parse
+* \param[out]  *plValue     - parsed value
+* \param[out]  *psSuffix    - set to the first character after the number (may be NULL)
+*
+* \retval      TRUE if at least one digit was found
+*/
+{
+	char *pEnd;
+
+	*plValue = strtol(sToken, &pEnd, 10);
+	if(pEnd == sToken)
+		return(FALSE);
+	if(psSuffix != NULL)
+		*psSuffix = pEnd;
+	else if(*pEnd != '\0')
+		return(FALSE);
+	return(TRUE);
+}
+
+static void cmd_record_temp(struct maximCommandInterface *pCmd, s16 nTemp)
+/**
+* \brief       Account for one temperature reading and add it to the sample store, if any.
+*/
+{
+	pCmd->unReadCount++;
+	pCmd->nLastTemp = nTemp;
+	if(pCmd->pStore != NULL)
+		sample_store_add_raw(pCmd->pStore, nTemp, 0);
+}
+
+static u8 cmd_alarm_register(const char *sToken, u8 *puchWriteRegister)
+/**
+* \brief       Map TLOW/THIGH to the MAX31723 alarm register addresses.
+*
+* \param[in]   *sToken              - upper case alarm name
+* \param[out]  *puchWriteRegister   - write address of the alarm register
+*
+* \retval      Read address of the alarm register, 0 if the name is not recognized
+*/
+{
+	if(strcmp(sToken, "TLOW") == 0)
+	{
+		*puchWriteRegister = MAX31723_LOW_ALARM_WRITE;
+		return(MAX31723_LOW_ALARM_READ);
+	}
+	if(strcmp(sToken, "THIGH") == 0)
+	{
+		*puchWriteRegister = MAX31723_HIGH_ALARM_WRITE;
+		return(MAX31723_HIGH_ALARM_READ);
+	}
+	return(0);
+}
+
+static void cmd_do_read(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       READ [n]
+*/
+{
+	s16 nTemp=0;
+	char sText[Q4_MAX_TEXT];
+	long lCount=1;
+	int i;
+
+	if(nTokens > 2 || (nTokens == 2 && !cmd_parse_int(asTokens[1], &lCount, NULL)))
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(lCount < 1 || lCount > CMD_MAX_READ_COUNT)
+	{
+		cmd_reply_error(pCmd, "RANGE");
+		return;
+	}
+
+	// Right after a configuration change there is no conversion result yet;  the host retries
+	if(nTokens == 1)
+	{
+		if(max31723_cache_read_raw(pCmd->pCache, &nTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+		{
+			cmd_reply_error(pCmd, "NOT_READY");
+			return;
+		}
+		cmd_record_temp(pCmd, nTemp);
+		q4_format(sText, nTemp, 4);
+		printf("OK READ %s\r\n", sText);
+	}
+	else
+	{
+		for(i=0;i<lCount;i++)
+		{
+			if(max31723_cache_read_raw(pCmd->pCache, &nTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+			{
+				cmd_reply_error(pCmd, "NOT_READY");
+				return;
+			}
+			cmd_record_temp(pCmd, nTemp);
+			q4_format(sText, nTemp, 4);
+			printf("DATA %s\r\n", sText);
+		}
+		printf("OK READ %ld\r\n", lCount);
+	}
+	fflush(stdout);
+}
+
+static void cmd_do_latency(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       LATENCY [n]
+* \par         Details
+*              Times n back-to-back temperature register reads (SpiRW plus decode) with the global
+*              timer.  OCM= reports whether the __fast_ sections are in OCM, so the same command on
+*              an OCM_FAST_SECTIONS=0 build gives the DDR baseline.  Interrupts stay enabled, so
+*              MAX_NS includes any tick interrupt that lands in a read.
+*/
+{
+	long lCount=CMD_LATENCY_DEFAULT_COUNT;
+	long i;
+	s16 nRaw;
+	u64 ullStart, ullTicks;
+	u64 ullMin=~0ULL, ullMax=0, ullTotal=0;
+
+	if(nTokens > 2 || (nTokens == 2 && !cmd_parse_int(asTokens[1], &lCount, NULL)))
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(lCount < 1 || lCount > CMD_MAX_READ_COUNT)
+	{
+		cmd_reply_error(pCmd, "RANGE");
+		return;
+	}
+
+	for(i=0;i<lCount;i++)
+	{
+		ullStart = get_time_ticks();
+		max_MAX31723_read_raw(&nRaw, pCmd->unPeripheralAddressSPI, MAX31723_TEMP_READ);
+		ullTicks = get_time_ticks() - ullStart;
+		if(ullTicks < ullMin)
+			ullMin = ullTicks;
+		if(ullTicks > ullMax)
+			ullMax = ullTicks;
+		ullTotal += ullTicks;
+	}
+	pCmd->unReadCount += (u32)lCount;
+
+	printf("OK LATENCY N=%ld MIN_NS=%lu MAX_NS=%lu MEAN_NS=%lu OCM=%d\r\n", lCount,
+			(unsigned long)(ullMin * 1000000000ULL / TICKS_PER_SECOND),
+			(unsigned long)(ullMax * 1000000000ULL / TICKS_PER_SECOND),
+			(unsigned long)(ullTotal / lCount * 1000000000ULL / TICKS_PER_SECOND),
+			OCM_FAST_SECTIONS);
+	fflush(stdout);
+}
+
+static void cmd_do_bench(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       BENCH [filter]
+* \par         Details
+*              Runs the benchmark cases whose names contain filter (see bench_utilities.h).  Case
+*              names are lower case, so the filter is converted back from the tokenizer's upper
+*              case.  uart_tx_64 writes raw lines of 'U' to the console while it runs.
+*/
+{
+	char *p;
+	int nCases;
+
+	if(nTokens > 2)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(nTokens == 2)
+	{
+		for(p=asTokens[1];*p!='\0';p++)
+		{
+			if(*p >= 'A' && *p <= 'Z')
+				*p += 32;
+		}
+	}
+	nCases = bench_run(pCmd->unPeripheralAddressSPI, pCmd->unUartAddress, (nTokens == 2) ? asTokens[1] : NULL, NULL, 0);
+	printf("OK BENCH %d\r\n", nCases);
+	fflush(stdout);
+}
+
+static void cmd_do_mmio(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       MMIO [RESET|TRACE|DUMP]
+* \par         Details
+*              Reports and controls the MMIO access counters.  Only available in builds with
+*              MMIO_TRACE_ENABLED=1; otherwise every form answers ERR DISABLED.
+*/
+{
+	if(nTokens > 2)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+#if MMIO_TRACE_ENABLED
+	if(nTokens == 1)
+	{
+		mmio_report();
+		printf("OK MMIO\r\n");
+	}
+	else if(strcmp(asTokens[1], "RESET") == 0)
+	{
+		mmio_reset();
+		printf("OK MMIO RESET\r\n");
+	}
+	else if(strcmp(asTokens[1], "TRACE") == 0)
+	{
+		mmio_trace_start();
+		printf("OK MMIO TRACE\r\n");
+	}
+	else if(strcmp(asTokens[1], "DUMP") == 0)
+	{
+		u32 unCount = mmio_trace_dump();
+
+		printf("OK MMIO DUMP %lu LOST=%lu\r\n", (unsigned long)unCount, (unsigned long)g_xMmio.unTraceLost);
+	}
+	else
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+#else
+	(void)asTokens;
+	cmd_reply_error(pCmd, "DISABLED");
+#endif
+}
+
+static int cmd_parse_hex_bytes(const char *sToken, u8 *auchData, int nMaxBytes)
+/**
+* \brief       Parse a string of hex digit pairs (upper case, as left by the tokenizer).
+*
+* \retval      Number of bytes, or -1 if the string is empty, odd, too long or not hex
+*/
+{
+	int nLength = (int)strlen(sToken);
+	int i;
+	int nDigit;
+	char ch;
+
+	if(nLength == 0 || (nLength & 1) || nLength / 2 > nMaxBytes)
+		return(-1);
+	for(i=0;i<nLength;i++)
+	{
+		ch = sToken[i];
+		if(ch >= '0' && ch <= '9')
+			nDigit = ch - '0';
+		else if(ch >= 'A' && ch <= 'F')
+			nDigit = ch - 'A' + 10;
+		else
+			return(-1);
+		if(i & 1)
+			auchData[i / 2] |= (u8)nDigit;
+		else
+			auchData[i / 2] = (u8)(nDigit << 4);
+	}
+	return(nLength / 2);
+}
+
+static void cmd_do_flash(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       FLASH ID|READ|WRITE|ERASE
+* \par         Details
+*              Accesses the serial flash on QSPI_FLASH_SLAVE of the sensor's SPI controller.  The
+*              device is probed on the first FLASH command rather than in cmd_init(), so boards
+*              without a flash never see traffic on that select line.  WRITE does not erase first.
+*/
+{
+	static const char *asModes[] = { "STD", "DUAL", "QUAD" };
+	u8 auchData[CMD_FLASH_MAX_READ];
+	unsigned long ulAddress=0;
+	long lCount=16;
+	char *pEnd;
+	int nLength;
+	int i;
+
+	if(nTokens < 2)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(nTokens >= 3)
+	{
+		ulAddress = strtoul(asTokens[2], &pEnd, 0);
+		if(pEnd == asTokens[2] || *pEnd != '\0')
+		{
+			cmd_reply_error(pCmd, "SYNTAX");
+			return;
+		}
+		if(ulAddress > 0xFFFFFF)
+		{
+			cmd_reply_error(pCmd, "RANGE");
+			return;
+		}
+	}
+
+	if(pCmd->nFlashState == 0)
+		pCmd->nFlashState = qspi_flash_init(&pCmd->xFlash, pCmd->unPeripheralAddressSPI, QSPI_FLASH_SLAVE,
+				pCmd->uchSpiMode) ? 1 : -1;
+	if(pCmd->nFlashState < 0)
+	{
+		cmd_reply_error(pCmd, "NOFLASH");
+		return;
+	}
+
+	if(strcmp(asTokens[1], "ID") == 0 && nTokens == 2)
+	{
+		printf("OK FLASH ID %02X%02X%02X MODE=%s\r\n", (unsigned int)pCmd->xFlash.auchId[0],
+				(unsigned int)pCmd->xFlash.auchId[1], (unsigned int)pCmd->xFlash.auchId[2],
+				asModes[pCmd->xFlash.uchSpiMode % 3]);
+	}
+	else if(strcmp(asTokens[1], "READ") == 0 && (nTokens == 3 || nTokens == 4))
+	{
+		if(nTokens == 4 && !cmd_parse_int(asTokens[3], &lCount, NULL))
+		{
+			cmd_reply_error(pCmd, "SYNTAX");
+			return;
+		}
+		if(lCount < 1 || lCount > CMD_FLASH_MAX_READ)
+		{
+			cmd_reply_error(pCmd, "RANGE");
+			return;
+		}
+		qspi_flash_read(&pCmd->xFlash, (u32)ulAddress, auchData, (int)lCount);
+		printf("OK FLASH %06lX ", ulAddress);
+		for(i=0;i<lCount;i++)
+			printf("%02X", (unsigned int)auchData[i]);
+		printf("\r\n");
+	}
+	else if(strcmp(asTokens[1], "WRITE") == 0 && nTokens == 4)
+	{
+		if((nLength = cmd_parse_hex_bytes(asTokens[3], auchData, sizeof(auchData))) < 0)
+		{
+			cmd_reply_error(pCmd, "SYNTAX");
+			return;
+		}
+		if(!qspi_flash_program(&pCmd->xFlash, (u32)ulAddress, auchData, nLength))
+		{
+			cmd_reply_error(pCmd, "TIMEOUT");
+			return;
+		}
+		printf("OK FLASH WRITE %d\r\n", nLength);
+	}
+	else if(strcmp(asTokens[1], "ERASE") == 0 && nTokens == 3)
+	{
+		if(!qspi_flash_erase_sector(&pCmd->xFlash, (u32)ulAddress))
+		{
+			cmd_reply_error(pCmd, "TIMEOUT");
+			return;
+		}
+		printf("OK FLASH ERASE %06lX\r\n", ulAddress & ~(unsigned long)(QSPI_FLASH_SECTOR_SIZE - 1));
+	}
+	else
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+}
+
+static void cmd_do_get(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       GET TLOW|THIGH
+*/
+{
+	s16 nTemp=0;
+	char sText[Q4_MAX_TEXT];
+	u8 uchReadRegister;
+	u8 uchWriteRegister;
+
+	if(nTokens != 2 || (uchReadRegister = cmd_alarm_register(asTokens[1], &uchWriteRegister)) == 0)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	max31723_cache_read_raw(pCmd->pCache, &nTemp, uchReadRegister);
+	if(uchReadRegister == MAX31723_LOW_ALARM_READ)
+		pCmd->nLowAlarm = nTemp;
+	else
+		pCmd->nHighAlarm = nTemp;
+	q4_format(sText, nTemp, 4);
+	printf("OK %s %s\r\n", asTokens[1], sText);
+	fflush(stdout);
+}
+
+static void cmd_do_set(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       SET TLOW|THIGH <degC>.  The reply carries the value read back from the part.
+* \par         Details
+*              The setpoint is rounded to the nearest 1/16 degC and stored at that resolution.
+*/
+{
+	s32 nSetpoint=0;
+	s16 nTemp=0;
+	char sText[Q4_MAX_TEXT];
+	const char *pEnd;
+	u8 uchReadRegister;
+	u8 uchWriteRegister;
+
+	if(nTokens != 3 || (uchReadRegister = cmd_alarm_register(asTokens[1], &uchWriteRegister)) == 0)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(!q4_parse(asTokens[2], &nSetpoint, &pEnd) || *pEnd != '\0')
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	// The upper and lower boundaries for the part are -55.0 to 125.0 degC
+	if(nSetpoint < MAX31723_TEMP_MIN_Q4 || nSetpoint > MAX31723_TEMP_MAX_Q4)
+	{
+		cmd_reply_error(pCmd, "RANGE");
+		return;
+	}
+	max31723_cache_set_alarm(pCmd->pCache, (s16)nSetpoint, uchWriteRegister);
+	max31723_cache_read_raw(pCmd->pCache, &nTemp, uchReadRegister);
+	if(uchReadRegister == MAX31723_LOW_ALARM_READ)
+		pCmd->nLowAlarm = nTemp;
+	else
+		pCmd->nHighAlarm = nTemp;
+	q4_format(sText, nTemp, 4);
+	printf("OK %s %s\r\n", asTokens[1], sText);
+	fflush(stdout);
+}
+
+static void cmd_do_stream(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       STREAM ON <period>[ms|s] / STREAM OFF
+*/
+{
+	long lPeriod=0;
+	const char *sSuffix;
+
+	if(nTokens == 2 && strcmp(asTokens[1], "OFF") == 0)
+	{
+		pCmd->nStreamActive = FALSE;
+		printf("OK STREAM OFF\r\n");
+		fflush(stdout);
+		return;
+	}
+	if(nTokens != 3 || strcmp(asTokens[1], "ON") != 0 || !cmd_parse_int(asTokens[2], &lPeriod, &sSuffix))
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(strcmp(sSuffix, "S") == 0)
+	{
+		if(lPeriod > CMD_MAX_STREAM_PERIOD_MS / 1000)
+		{
+			cmd_reply_error(pCmd, "RANGE");
+			return;
+		}
+		lPeriod *= 1000;
+	}
+	else if(*sSuffix != '\0' && strcmp(sSuffix, "MS") != 0)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	if(lPeriod < CMD_MIN_STREAM_PERIOD_MS || lPeriod > CMD_MAX_STREAM_PERIOD_MS)
+	{
+		cmd_reply_error(pCmd, "RANGE");
+		return;
+	}
+
+	pCmd->unStreamPeriodMs = (u32)lPeriod;
+	pCmd->ullNextStreamTick = get_time_ticks();
+	pCmd->nStreamActive = TRUE;
+	printf("OK STREAM ON %lu\r\n", (unsigned long)pCmd->unStreamPeriodMs);
+	fflush(stdout);
+}
+
+static void cmd_do_stats(struct maximCommandInterface *pCmd, int nTokens)
+/**
+* \brief       STATS
+*/
+{
+	if(nTokens != 1)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	printf("OK STATS CMDS=%lu ERRS=%lu READS=%lu STREAMED=%lu\r\n",
+			(unsigned long)pCmd->unCommandCount, (unsigned long)pCmd->unErrorCount,
+			(unsigned long)pCmd->unReadCount, (unsigned long)pCmd->unStreamCount);
+	fflush(stdout);
+}
+
+static void cmd_do_hist(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       HIST / HIST <n> / HIST RESET
+* \par         Details
+*              The summary comes from the running statistics of the sample store and costs the
+*              same whatever the number of readings;  HIST <n> lists the history newest first.
+*/
+{
+	struct maximSampleStats xStats;
+	struct maximSample xSample;
+	char asText[5][Q4_MAX_TEXT];
+	long lCount;
+	u32 i;
+
+	if(pCmd->pStore == NULL)
+	{
+		cmd_reply_error(pCmd, "NO_STORE");
+		return;
+	}
+	if(nTokens == 1)
+	{
+		sample_store_stats(pCmd->pStore, &xStats);
+		q4_format(asText[0], xStats.nMin, 4);
+		q4_format(asText[1], xStats.nMax, 4);
+		q4_format(asText[2], xStats.nMean, 4);
+		q4_format(asText[3], xStats.nEwma, 4);
+		q4_format(asText[4], xStats.nStdDev, 4);
+		printf("OK HIST N=%lu MIN=%s MAX=%s MEAN=%s EWMA=%s SD=%s\r\n", (unsigned long)xStats.unCount,
+				asText[0], asText[1], asText[2], asText[3], asText[4]);
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "RESET") == 0)
+	{
+		sample_store_init(pCmd->pStore);
+		printf("OK HIST RESET\r\n");
+	}
+	else if(nTokens == 2 && cmd_parse_int(asTokens[1], &lCount, NULL))
+	{
+		if(lCount < 1 || lCount > SAMPLE_STORE_SIZE)
+		{
+			cmd_reply_error(pCmd, "RANGE");
+			return;
+		}
+		for(i=0;i<(u32)lCount && sample_store_get(pCmd->pStore, i, &xSample);i++)
+		{
+			q4_format(asText[0], xSample.nRaw, 4);
+			printf("DATA %lu %s\r\n", (unsigned long)xSample.unTimestampUs, asText[0]);
+		}
+		printf("OK HIST %lu\r\n", (unsigned long)i);
+	}
+	else
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+}
+
+static void cmd_do_scan(struct maximCommandInterface *pCmd, int nTokens)
+/**
+* \brief       SCAN
+* \par         Details
+*              One conversion time for the whole array.  The array sensors are left shut down;  when
+*              the cached sensor is one of them its configuration is written again afterwards.
+*/
+{
+	struct maximSensorArray *pArray = pCmd->pArray;
+	struct maximRegisterMap *pMap = &pCmd->pCache->xRegisters;
+	char sText[Q4_MAX_TEXT];
+	int i;
+
+	if(pArray == NULL)
+	{
+		cmd_reply_error(pCmd, "NO_ARRAY");
+		return;
+	}
+	if(nTokens != 1)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	sensor_array_scan(pArray);
+	for(i=0;i<pArray->nSensors;i++)
+	{
+		if(pArray->axEntries[i].unPeripheralAddressSPI == pMap->unPeripheralAddressSPI &&
+				pArray->axEntries[i].uchSlave == pMap->nSlave)
+		{
+			max31723_cache_configure(pCmd->pCache, pCmd->pCache->uchConfiguration);
+			break;
+		}
+	}
+
+	for(i=0;i<pArray->nSensors;i++)
+	{
+		q4_format(sText, pArray->axReadings[i].nRaw, 4);
+		printf("DATA %d %lu %s\r\n", i, (unsigned long)pArray->axReadings[i].unTimestampUs, sText);
+	}
+	printf("OK SCAN %d US=%lu\r\n", pArray->nSensors, (unsigned long)pArray->unLastScanUs);
+	fflush(stdout);
+}
+
+static void cmd_do_reg(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       REG / REG <register>
+* \par         Details
+*              Reads the register map of the MAX31723 cache, so registers the other commands have
+*              read are served from it, and the rest of the register file costs one burst.
+*/
+{
+	struct maximRegisterMap *pMap = &pCmd->pCache->xRegisters;
+	const struct maximDeviceDesc *pDevice = pMap->pDevice;
+	u8 auchRegisters[REGMAP_MAX_REGISTERS];
+	s32 alValues[REGMAP_MAX_REGISTERS];
+	int nRegister, nTransfers, i;
+
+	if(nTokens == 1)
+	{
+		for(i=0;i<pDevice->nRegisters;i++)
+			auchRegisters[i] = (u8)i;
+		nTransfers = regmap_read(pMap, auchRegisters, pDevice->nRegisters, alValues);
+		if(nTransfers == REGMAP_NOT_READY)
+		{
+			cmd_reply_error(pCmd, "NOT_READY");
+			return;
+		}
+		for(i=0;i<pDevice->nRegisters;i++)
+			printf("DATA %s %ld\r\n", pDevice->axRegisters[i].sName, (long)alValues[i]);
+		printf("OK REG %d XFERS=%d\r\n", pDevice->nRegisters, nTransfers);
+	}
+	else if(nTokens == 2 && (nRegister = regmap_find(pDevice, asTokens[1])) >= 0)
+	{
+		auchRegisters[0] = (u8)nRegister;
+		if(regmap_read(pMap, auchRegisters, 1, alValues) == REGMAP_NOT_READY)
+		{
+			cmd_reply_error(pCmd, "NOT_READY");
+			return;
+		}
+		printf("OK REG %s %ld\r\n", pDevice->axRegisters[nRegister].sName, (long)alValues[0]);
+	}
+	else
+	{
+		cmd_reply_error(pCmd, (nTokens == 2) ? "RANGE" : "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+}
+
+static void cmd_do_tc(struct maximCommandInterface *pCmd, int nTokens)
+/**
+* \brief       TC
+* \par         Details
+*              Replies from the frame cmd_poll() keeps current, so TC never waits for a conversion.
+*/
+{
+	struct maximMax31855 *pSensor = pCmd->pThermocouple;
+	char asText[2][Q4_MAX_TEXT];
+	u32 unNow = get_time_us();
+
+	if(pSensor == NULL)
+	{
+		cmd_reply_error(pCmd, "NO_THERMOCOUPLE");
+		return;
+	}
+	if(nTokens != 1)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	max_MAX31855_poll(pSensor, unNow);
+	q4_format(asText[0], pSensor->xLast.nProbe, 4);
+	q4_format(asText[1], pSensor->xLast.nInternal, 4);
+	printf("OK TC %s CJ=%s FAULT=%s AGE_MS=%lu\r\n", asText[0], asText[1], max_MAX31855_fault_name(pSensor->xLast.uchFaults),
+			(unsigned long)((unNow - pSensor->xLast.unTimestampUs) / 1000));
+	fflush(stdout);
+}
+
+static void cmd_do_cache(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       CACHE / CACHE CLEAR
+*/
+{
+	const struct maximMax31723CacheEntry *axEntries = pCmd->pCache->axEntries;
+
+	if(nTokens == 1)
+	{
+		printf("OK CACHE TEMP=%lu/%lu TLOW=%lu/%lu THIGH=%lu/%lu\r\n",
+				(unsigned long)axEntries[MAX31723_CACHE_TEMP].unHits,
+				(unsigned long)axEntries[MAX31723_CACHE_TEMP].unMisses,
+				(unsigned long)axEntries[MAX31723_CACHE_LOW_ALARM].unHits,
+				(unsigned long)axEntries[MAX31723_CACHE_LOW_ALARM].unMisses,
+				(unsigned long)axEntries[MAX31723_CACHE_HIGH_ALARM].unHits,
+				(unsigned long)axEntries[MAX31723_CACHE_HIGH_ALARM].unMisses);
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "CLEAR") == 0)
+	{
+		max31723_cache_invalidate(pCmd->pCache);
+		printf("OK CACHE CLEAR\r\n");
+	}
+	else
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+}
+
+static void cmd_do_log(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       LOG / LOG ON / LOG OFF / LOG CLEAR
+*/
+{
+	u32 unSent;
+
+	if(nTokens == 1)
+	{
+		unSent = log_dump();
+		printf("OK LOG %lu LOST=%lu\r\n", (unsigned long)unSent, (unsigned long)g_xLogRing.unLost);
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "ON") == 0)
+	{
+		pCmd->nLogAutoDrain = TRUE;
+		printf("OK LOG ON\r\n");
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "OFF") == 0)
+	{
+		pCmd->nLogAutoDrain = FALSE;
+		printf("OK LOG OFF\r\n");
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "CLEAR") == 0)
+	{
+		log_clear();
+		printf("OK LOG CLEAR\r\n");
+	}
+	else
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+}
+
+static void cmd_do_capture(struct maximCommandInterface *pCmd, int nTokens, char *asTokens[])
+/**
+* \brief       CAP / CAP ON / CAP OFF / CAP CLEAR
+*/
+{
+	u32 unSent;
+
+	if(nTokens == 1)
+	{
+		unSent = spi_capture_dump();
+		printf("OK CAP %lu LOST=%lu SKIPPED=%lu\r\n", (unsigned long)unSent, (unsigned long)g_xSpiCapture.unLost,
+				(unsigned long)g_xSpiCapture.unSkipped);
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "ON") == 0)
+	{
+		spi_capture_start();
+		printf("OK CAP ON\r\n");
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "OFF") == 0)
+	{
+		spi_capture_stop();
+		printf("OK CAP OFF\r\n");
+	}
+	else if(nTokens == 2 && strcmp(asTokens[1], "CLEAR") == 0)
+	{
+		spi_capture_clear();
+		printf("OK CAP CLEAR\r\n");
+	}
+	else
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+	fflush(stdout);
+}
+
+static void cmd_service_stream(struct maximCommandInterface *pCmd)
+/**
+* \brief       Emit one STREAM line if streaming is enabled and the period has elapsed.
+* \par         Details
+*              The schedule advances in whole periods so the average rate does not drift.  If the
+*              interface fell more than one period behind (e.g. during a long READ n), it is
+*              resynchronized instead of emitting a burst of catch-up samples.
+*
+* \param[in]   *pCmd        - command interface instance
+*
+* \retval      None
+*/
+{
+	u64 ullNow;
+	u64 ullPeriodTicks;
+	s16 nTemp=0;
+	char sText[Q4_MAX_TEXT];
+
+	if(!pCmd->nStreamActive)
+		return;
+
+	ullNow = get_time_ticks();
+	if(ullNow < pCmd->ullNextStreamTick)
+		return;
+
+	// Not due again until the first conversion at a new configuration is available
+	if(max31723_cache_read_raw(pCmd->pCache, &nTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+		return;
+	cmd_record_temp(pCmd, nTemp);
+	pCmd->unStreamCount++;
+	q4_format(sText, nTemp, 4);
+	printf("STREAM %lu %s\r\n", (unsigned long)(ullNow / TICKS_PER_MS), sText);
+	fflush(stdout);
+
+	ullPeriodTicks = (u64)pCmd->unStreamPeriodMs * TICKS_PER_MS;
+	pCmd->ullNextStreamTick += ullPeriodTicks;
+	if(pCmd->ullNextStreamTick <= ullNow)
+		pCmd->ullNextStreamTick = ullNow + ullPeriodTicks;
+}
+
+void cmd_init(struct maximCommandInterface *pCmd, u32 unUartAddress, struct maximMax31723Cache *pCache,
+		struct maximSampleStore *pStore, struct maximSensorArray *pArray, struct maximMax31855 *pThermocouple)
+/**
+* \brief       Initialize a command interface on a MAX31723 register cache.
+* \par         Details
+*              The sensor is put in continuous 12-bit mode, unless the cache already has it there,
+*              so that subsequent reads return the last completed conversion immediately.  READ,
+*              STREAM, GET and SET go through the cache;  LATENCY and BENCH still time the raw
+*              SPI reads.
+*
+* \param[out]  *pCmd                    - command interface instance
+* \param[in]   unUartAddress            - address of the UART peripheral the commands arrive on
+* \param[in]   *pCache                  - cache of the MAX31723, whose SPI peripheral is used throughout
+* \param[in]   *pStore                  - READ and STREAM readings are added here (may be NULL)
+* \param[in]   *pArray                  - initialized sensor array read by SCAN (may be NULL)
+* \param[in]   *pThermocouple           - initialized MAX31855 read by TC (may be NULL)
+*
+* \retval      None
+*/
+{
+	memset(pCmd, 0, sizeof(*pCmd));
+	pCmd->unUartAddress = unUartAddress;
+	pCmd->unPeripheralAddressSPI = pCache->unPeripheralAddressSPI;
+	pCmd->pCache = pCache;
+	pCmd->pStore = pStore;
+	pCmd->pArray = pArray;
+	pCmd->pThermocouple = pThermocouple;
+
+	if(pCache->uchConfiguration != MAX31723_CONFIG_12BIT_CONTINUOUS)
+		max31723_cache_configure(pCache, MAX31723_CONFIG_12BIT_CONTINUOUS);
+	max31723_cache_read_raw(pCache, &pCmd->nLowAlarm, MAX31723_LOW_ALARM_READ);
+	max31723_cache_read_raw(pCache, &pCmd->nHighAlarm, MAX31723_HIGH_ALARM_READ);
+}
+
+void cmd_execute_line(struct maximCommandInterface *pCmd, char *sLine)
+/**
+* \brief       Execute one complete command line and send its reply.
+*
+* \param[in]   *pCmd        - command interface instance
+* \param[in]   *sLine       - null terminated command line, without the line terminator (modified)
+*
+* \retval      None
+*/
+{
+	char *asTokens[CMD_MAX_TOKENS];
+	int nTokens;
+
+	nTokens = cmd_tokenize(sLine, asTokens);
+	if(nTokens == 0)
+		return;
+	pCmd->unCommandCount++;
+	if(nTokens < 0)
+	{
+		cmd_reply_error(pCmd, "SYNTAX");
+		return;
+	}
+
+	if(strcmp(asTokens[0], "PING") == 0 && nTokens == 1)
+	{
+		printf("OK PONG\r\n");
+		fflush(stdout);
+	}
+	else if(strcmp(asTokens[0], "READ") == 0)
+		cmd_do_read(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "GET") == 0)
+		cmd_do_get(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "SET") == 0)
+		cmd_do_set(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "STREAM") == 0)
+		cmd_do_stream(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "STATS") == 0)
+		cmd_do_stats(pCmd, nTokens);
+	else if(strcmp(asTokens[0], "CACHE") == 0)
+		cmd_do_cache(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "HIST") == 0)
+		cmd_do_hist(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "SCAN") == 0)
+		cmd_do_scan(pCmd, nTokens);
+	else if(strcmp(asTokens[0], "REG") == 0)
+		cmd_do_reg(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "TC") == 0)
+		cmd_do_tc(pCmd, nTokens);
+	else if(strcmp(asTokens[0], "LOG") == 0)
+		cmd_do_log(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "CAP") == 0)
+		cmd_do_capture(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "LATENCY") == 0)
+		cmd_do_latency(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "PROF") == 0 && nTokens == 1)
+	{
+		prof_report();
+		printf("OK PROF\r\n");
+		fflush(stdout);
+	}
+	else if(strcmp(asTokens[0], "PROF") == 0 && nTokens == 2 && strcmp(asTokens[1], "RESET") == 0)
+	{
+		prof_reset();
+		printf("OK PROF RESET\r\n");
+		fflush(stdout);
+	}
+	else if(strcmp(asTokens[0], "MMU") == 0 && nTokens == 1)
+	{
+		mmu_report(pCmd->unPeripheralAddressSPI);
+		printf("OK MMU\r\n");
+		fflush(stdout);
+	}
+	else if(strcmp(asTokens[0], "MMIO") == 0)
+		cmd_do_mmio(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "BENCH") == 0)
+		cmd_do_bench(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "FLASH") == 0)
+		cmd_do_flash(pCmd, nTokens, asTokens);
+	else if(strcmp(asTokens[0], "EXIT") == 0 && nTokens == 1)
+	{
+		pCmd->nStreamActive = FALSE;
+		pCmd->nExitRequested = TRUE;
+		printf("OK EXIT\r\n");
+		fflush(stdout);
+	}
+	else
+		cmd_reply_error(pCmd, "UNKNOWN");
+
+	LOG2(LOG_ID_CMD_LINE, pCmd->unCommandCount, pCmd->unErrorCount);
+}
+
+int cmd_poll(struct maximCommandInterface *pCmd)
+/**
+* \brief       Service the command interface without blocking.
+* \par         Details
+*              Drains whatever is currently in the UART Rx FIFO into the line buffer, executes every
+*              complete line in arrival order, emits a STREAM sample if one is due and reads the
+*              thermocouple if a new conversion is ready.  Returns immediately when no input is
+*              pending, so it can be called from any main loop.
+*
+* \param[in]   *pCmd        - command interface instance
+*
+* \retval      FALSE once EXIT has been received, TRUE otherwise
+*/
+{
+	u8 uchInput;
+
+	while(!pCmd->nExitRequested && !checkUartEmpty(pCmd->unUartAddress))
+	{
+		uchInput = getUartByte(pCmd->unUartAddress);
+		if(uchInput == '\r' || uchInput == '\n')
+		{
+			if(pCmd->nLineOverflow)
+			{
+				pCmd->unCommandCount++;
+				cmd_reply_error(pCmd, "TOO_LONG");
+			}
+			else if(pCmd->nLineLength > 0)
+			{
+				pCmd->sLine[pCmd->nLineLength] = '\0';
+				cmd_execute_line(pCmd, pCmd->sLine);
+			}
+			pCmd->nLineLength = 0;
+			pCmd->nLineOverflow = FALSE;
+		}
+		else if(pCmd->nLineLength < CMD_MAX_LINE_LENGTH)
+			pCmd->sLine[pCmd->nLineLength++] = (char)uchInput;
+		else
+			pCmd->nLineOverflow = TRUE;
+	}
+
+	cmd_service_stream(pCmd);
+
+	if(pCmd->pThermocouple != NULL)
+		max_MAX31855_poll(pCmd->pThermocouple, get_time_us());
+
+	if(pCmd->nLogAutoDrain)
+		log_drain(pCmd->unUartAddress, CMD_LOG_DRAIN_PER_POLL);
+
+	return(!pCmd->nExitRequested);
+}
@@ -0,0 +1,125 @@
+/** \file command_utilities.h ************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: command_utilities.h
+ *         Description: Line oriented command interface for automated test
+ *                      rigs.  Commands are collected from the UART Rx FIFO
+ *                      without blocking and answered with one machine
+ *                      readable "OK ..." or "ERR ..." line each.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef COMMAND_UTILITIES_H_
+#define COMMAND_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "qspi_flash_utilities.h"
+#include "sample_store.h"
+#include "max31723_cache.h"
+#include "sensor_array.h"
+#include "register_map.h"
+#include "max31855_utilities.h"
+
+#define CMD_MAX_LINE_LENGTH 64          //!< Longest accepted command line, excluding the terminator
+#define CMD_MAX_TOKENS 4                //!< Most words accepted on one command line
+#define CMD_MAX_READ_COUNT 1000         //!< Upper bound for "READ n"
+#define CMD_MIN_STREAM_PERIOD_MS 1      //!< Shortest accepted "STREAM ON" period
+#define CMD_MAX_STREAM_PERIOD_MS 86400000   //!< Longest accepted "STREAM ON" period, one day
+#define CMD_LOG_DRAIN_PER_POLL 4        //!< Most log records sent per cmd_poll() call with "LOG ON"
+#define CMD_LATENCY_DEFAULT_COUNT 100   //!< Reads timed by "LATENCY" without a count
+#define CMD_FLASH_MAX_READ 64           //!< Upper bound for "FLASH READ <addr> n"
+
+/*
+ * Protocol summary (one command per CR and/or LF terminated line, case insensitive):
+ *
+ *   PING                      -> OK PONG
+ *   READ                      -> OK READ <degC>
+ *   READ <n>                  -> DATA <degC> (n times), then OK READ <n>
+ *   GET TLOW|THIGH            -> OK TLOW|THIGH <degC>
+ *   SET TLOW|THIGH <degC>     -> OK TLOW|THIGH <degC as stored>
+ *   STREAM ON <period>[ms|s]  -> OK STREAM ON <ms>, then STREAM <ms> <degC> lines
+ *   STREAM OFF                -> OK STREAM OFF
+ *   STATS                     -> OK STATS CMDS=<n> ERRS=<n> READS=<n> STREAMED=<n>
+ *   CACHE                     -> OK CACHE TEMP=<hits>/<misses> TLOW=<hits>/<misses> THIGH=<hits>/<misses>
+ *   CACHE CLEAR               -> OK CACHE CLEAR (the next read of each register goes to the part)
+ *   HIST                      -> OK HIST N=<n> MIN=<degC> MAX=<degC> MEAN=<degC> EWMA=<degC> SD=<degC>
+ *   HIST <n>                  -> DATA <us> <degC> (latest n readings, newest first), then OK HIST <lines>
+ *   HIST RESET                -> OK HIST RESET
+ *   SCAN                      -> DATA <sensor> <us> <degC> (one per array sensor), then OK SCAN <n> US=<scan us>
+ *   REG                       -> DATA <register> <value> (every MAX31723 register), then OK REG <n> XFERS=<n>
+ *   REG <register>            -> OK REG <register> <value> (raw decoded field, e.g. TEMP in 1/16 degC)
+ *   TC                        -> OK TC <probe degC> CJ=<degC> FAULT=NONE|OC|SCG|SCV AGE_MS=<ms> (latest MAX31855 frame)
+ *   LOG                       -> LOG ... records (see log_utilities.c), then OK LOG <n> LOST=<n>
+ *   LOG ON|OFF|CLEAR          -> OK LOG ON|OFF|CLEAR (ON drains records lazily while idle)
+ *   CAP                       -> CAP ... records (see spi_capture.h), then OK CAP <n> LOST=<n> SKIPPED=<n>
+ *   CAP ON|OFF|CLEAR          -> OK CAP ON|OFF|CLEAR (ON records every SpiRW() transaction)
+ *   LATENCY [n]               -> OK LATENCY N=<n> MIN_NS=<ns> MAX_NS=<ns> MEAN_NS=<ns> OCM=0|1
+ *   MMU                       -> cache and memory attribute report (see mmu_report()), then OK MMU
+ *   PROF                      -> PROF <site> ... lines (see prof_report()), then OK PROF
+ *   PROF RESET                -> OK PROF RESET
+ *   MMIO                      -> MMIO REGION/SITE/TOTAL lines (see mmio_utilities.h), then OK MMIO
+ *   MMIO RESET                -> OK MMIO RESET
+ *   MMIO TRACE                -> OK MMIO TRACE, then records the next MMIO_TRACE_DEPTH accesses
+ *   MMIO DUMP                 -> MMIO T ... lines, then OK MMIO DUMP <n> LOST=<n>
+ *   BENCH [filter]            -> BENCH ... lines (see bench_utilities.h), then OK BENCH <cases>
+ *   FLASH ID                  -> OK FLASH ID <hex> MODE=STD|DUAL|QUAD
+ *   FLASH READ <addr> [n]     -> OK FLASH <addr> <hex> (n bytes, default 16)
+ *   FLASH WRITE <addr> <hex>  -> OK FLASH WRITE <n>
+ *   FLASH ERASE <addr>        -> OK FLASH ERASE <sector addr>
+ *   EXIT                      -> OK EXIT (cmd_poll() returns FALSE afterwards)
+ *
+ * FLASH addresses may be decimal or 0x prefixed hex.  Errors are reported as ERR <reason>.  Commands may be sent back to back without
+ * waiting for the previous reply; they are executed and answered strictly in order.  No command waits for a conversion:  READ and
+ * REG answer ERR NOT_READY until the first conversion after a configuration change (e.g. by SCAN) has completed, and STREAM skips
+ * to the next poll.
+ */
+
+struct maximCommandInterface              //!< State of one command interface instance
+{
+	u32 unUartAddress;
+	u32 unPeripheralAddressSPI;
+	char sLine[CMD_MAX_LINE_LENGTH + 1];
+	int nLineLength;
+	int nLineOverflow;
+	int nStreamActive;
+	int nLogAutoDrain;
+	u32 unStreamPeriodMs;
+	u64 ullNextStreamTick;
+	u32 unCommandCount;
+	u32 unErrorCount;
+	u32 unReadCount;
+	u32 unStreamCount;
+	s16 nLastTemp;                      //!< most recent temperature read by any command, 1/16 degC
+	s16 nLowAlarm;                      //!< Tlow setpoint as last read or written, 1/16 degC
+	s16 nHighAlarm;                     //!< Thigh setpoint as last read or written, 1/16 degC
+	int nExitRequested;
+	int nFlashState;                    //!< 0 not probed yet, 1 present, -1 no device answered or the core is wider than 8 bits
+	u8 uchSpiMode;                      //!< QSPI_FLASH_MODE_... the SPI core was built with;  set after cmd_init()
+	struct maximQspiFlash xFlash;       //!< flash on QSPI_FLASH_SLAVE, probed by the first FLASH command
+	struct maximMax31723Cache *pCache;  //!< READ, STREAM, GET and SET go through this cache
+	struct maximSampleStore *pStore;    //!< readings are recorded here for HIST, NULL for none
+	struct maximSensorArray *pArray;    //!< sensors read by SCAN, NULL for none
+	struct maximMax31855 *pThermocouple;    //!< polled at its conversion rate by cmd_poll(), read by TC, NULL for none
+};
+
+void cmd_init(struct maximCommandInterface *pCmd, u32 unUartAddress, struct maximMax31723Cache *pCache,
+		struct maximSampleStore *pStore, struct maximSensorArray *pArray, struct maximMax31855 *pThermocouple);
+int cmd_poll(struct maximCommandInterface *pCmd);
+void cmd_execute_line(struct maximCommandInterface *pCmd, char *sLine);
+
+#endif /* COMMAND_UTILITIES_H_ */
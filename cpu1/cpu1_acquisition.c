@@ -0,0 +1,90 @@
+/** \file cpu1_acquisition.c *************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: cpu1_acquisition.c
+ *         Description: CPU1 application of the AMP configuration.  Waits for
+ *                      commands from CPU0 in the shared block and, while
+ *                      started, samples the MAX31723 on a fixed schedule and
+ *                      publishes the samples into the shared ring.
+ *
+ *                      Built by cpu1/Makefile as a separate standalone
+ *                      application linked with cpu1/lscript.ld, from this
+ *                      file plus the SPI, MAX31723, acquisition and sample
+ *                      ring drivers of the parent directory.
+ *                      Its BSP needs USE_AMP=1 (no L2 cache or global timer
+ *                      reinitialization behind CPU0's back); compile with
+ *                      LOG_ENABLED=0, since CPU1 has no console, and with
+ *                      OCM_FAST_SECTIONS=0, since ps7_ram_0 belongs to CPU0.
+ *                      PROFILE_ENABLED=0 leaves out the profiling sites.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include "xil_mmu.h"
+#include "../amp_shared.h"
+#include "../acquisition_utilities.h"
+
+static struct maximAcquisition g_xAcquisition;
+
+
+static void cpu1_run_acquisition(void)
+/**
+* \brief       Sample until CPU0 posts AMP_COMMAND_STOP.
+* \par         Details
+*              Every published sample is followed by DSB + SEV so a consumer sleeping in WFE wakes
+*              up.  Nothing else runs on this CPU, so the only jitter left is the SPI transfer.
+*/
+{
+	acq_init(&g_xAcquisition, g_pAmpShared->unPeripheralAddressSPI, 0, (u8)g_pAmpShared->unConfiguration,
+			g_pAmpShared->unPeriodUs, &g_pAmpShared->xRing);
+	g_pAmpShared->unPeriodUs = g_xAcquisition.unPeriodUs;
+	g_pAmpShared->unSampleCount = 0;
+	g_pAmpShared->unLateCount = 0;
+	g_pAmpShared->unMaxLatenessUs = 0;
+	g_pAmpShared->unCpu1State = AMP_CPU1_STATE_RUNNING;
+	AMP_SIGNAL();
+
+	while(g_pAmpShared->unCommand != AMP_COMMAND_STOP)
+	{
+		if(acq_poll(&g_xAcquisition))
+		{
+			g_pAmpShared->unSampleCount = g_xAcquisition.unSampleCount;
+			g_pAmpShared->unLateCount = g_xAcquisition.unLateCount;
+			g_pAmpShared->unMaxLatenessUs = g_xAcquisition.unMaxLatenessUs;
+			AMP_SIGNAL();
+		}
+	}
+}
+
+int main()
+{
+	Xil_SetTlbAttributes(AMP_SHARED_BASEADDR, AMP_SHARED_TLB_ATTRIBUTES);
+
+	g_pAmpShared->unMagic = AMP_SHARED_MAGIC;
+	g_pAmpShared->unCpu1State = AMP_CPU1_STATE_IDLE;
+	AMP_SIGNAL();
+
+	while(TRUE)
+	{
+		while(g_pAmpShared->unCommand != AMP_COMMAND_START)
+			AMP_WAIT();
+		cpu1_run_acquisition();    // returns with unCommand still AMP_COMMAND_STOP, so the wait above holds
+		g_pAmpShared->unCpu1State = AMP_CPU1_STATE_IDLE;
+		AMP_SIGNAL();
+	}
+	return 0;
+}
@@ -27,3 +27,39 @@ void delay(int nStopValue)
 		//a=i;
 	}
 }
+
+u64 get_time_ticks(void)
+/**
+* \brief       Read the 64-bit free running global timer.
+* \par         Details
+*              Unlike delay(), the global timer is clocked from the CPU and does not depend on
+*              loop timing, so it can be used to schedule and timestamp events.
+*
+* \retval      Number of ticks (TICKS_PER_SECOND per second) since the timer was started
+*/
+{
+	XTime xTime;
+
+	XTime_GetTime(&xTime);
+	return((u64)xTime);
+}
+
+u32 get_time_ms(void)
+/**
+* \brief       Global timer value in milliseconds (wraps after ~49 days).
+*
+* \retval      Milliseconds since the timer was started
+*/
+{
+	return((u32)(get_time_ticks() / TICKS_PER_MS));
+}
+
+u32 get_time_us(void)
+/**
+* \brief       Global timer value in microseconds (wraps after ~71 minutes).
+*
+* \retval      Microseconds since the timer was started
+*/
+{
+	return((u32)(get_time_ticks() / TICKS_PER_US));
+}
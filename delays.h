@@ -13,9 +13,17 @@
 #endif /* SRC_DELAYS_H_ */
 
 #include "stdio.h"
+#include "xtime_l.h"
 
 #define ABOUT_ONE_SECOND 74067512      //!< approx 1 second delay when used as argument with function delay(numberCyclesToDelay)
 // Update this if uBlaze/Zynq CPU core frequency is changed, or if the external memory timing changes.
 // Although emprirically tested to 1.0000003 seconds, it is not meant to be used for precise timing purposes
 
+#define TICKS_PER_SECOND COUNTS_PER_SECOND             //!< Global timer ticks per second (half the CPU clock on Zynq)
+#define TICKS_PER_MS (COUNTS_PER_SECOND / 1000)        //!< Global timer ticks per millisecond
+#define TICKS_PER_US (COUNTS_PER_SECOND / 1000000)     //!< Global timer ticks per microsecond
+
 void delay(int nStopValue);
+u64 get_time_ticks(void);
+u32 get_time_ms(void);
+u32 get_time_us(void);
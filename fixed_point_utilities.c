@@ -0,0 +1,174 @@
+/** \file fixed_point_utilities.c ********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: fixed_point_utilities.c
+ *         Description: Q12.4 fixed point temperatures (see
+ *                      fixed_point_utilities.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include "xbasic_types.h"
+#include "fixed_point_utilities.h"
+#include "memory_sections.h"
+
+#define Q4_PARSE_MAX_DECIMALS 6         //!< Further decimals are read but do not affect rounding
+#define Q4_PARSE_MAX_WHOLE 100000       //!< Whole part limit, keeps the arithmetic in 32 bits
+
+static const u32 g_aunPowersOfTen[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+
+__fast_text s32 q4_celsius_to_fahrenheit(s32 nCelsius)
+/**
+* \brief       Convert a Q12.4 Celsius value to Q12.4 Fahrenheit (F = C * 9 / 5 + 32), rounded to nearest.
+*/
+{
+	s32 nScaled = nCelsius * 9;
+
+	nScaled = (nScaled >= 0) ? (nScaled + 2) / 5 : (nScaled - 2) / 5;
+	return(nScaled + Q4_FROM_INT(32));
+}
+
+__fast_text int q4_format(char *sOut, s32 nValue, int nDecimals)
+/**
+* \brief       Format a Q12.4 value as decimal text, rounded half away from zero.
+* \par         Details
+*              Four decimals are exact (1/16 = 0.0625), so q4_format(s, n, 4) prints the same as
+*              printf("%.4f", n / 16.0f).  No minus sign is printed for values that round to zero.
+*              The whole and fractional parts are scaled separately, so any s32 is formatted exactly.
+*
+* \param[out]  *sOut        - at least Q4_MAX_TEXT characters
+* \param[in]   nValue       - value in 1/16 units, any s32
+* \param[in]   nDecimals    - 0 to 4
+*
+* \retval      Number of characters written (excluding the terminator)
+*/
+{
+	char sDigits[12];
+	int nLength = 0, nDigits = 0;
+	u32 unMagnitude, unWhole, unFraction, unDivisor;
+	int i;
+
+	if(nDecimals < 0)
+		nDecimals = 0;
+	else if(nDecimals > 4)
+		nDecimals = 4;
+
+	unMagnitude = (nValue < 0) ? 0U - (u32)nValue : (u32)nValue;
+	unDivisor = g_aunPowersOfTen[4 - nDecimals];
+	unWhole = unMagnitude >> Q4_FRACTION_BITS;
+	unFraction = ((unMagnitude & (Q4_ONE - 1)) * 625 + unDivisor / 2) / unDivisor;   // fraction * 10^nDecimals
+	if(unFraction >= g_aunPowersOfTen[nDecimals])
+	{
+		// Rounded up to the next whole number
+		unFraction -= g_aunPowersOfTen[nDecimals];
+		unWhole++;
+	}
+
+	if(nValue < 0 && (unWhole != 0 || unFraction != 0))
+		sOut[nLength++] = '-';
+	do
+	{
+		sDigits[nDigits++] = (char)('0' + unWhole % 10);
+		unWhole /= 10;
+	} while(unWhole != 0);
+	while(nDigits > 0)
+		sOut[nLength++] = sDigits[--nDigits];
+	if(nDecimals > 0)
+	{
+		sOut[nLength++] = '.';
+		for(i=nDecimals-1;i>=0;i--)
+		{
+			sOut[nLength + i] = (char)('0' + unFraction % 10);
+			unFraction /= 10;
+		}
+		nLength += nDecimals;
+	}
+	sOut[nLength] = '\0';
+	return(nLength);
+}
+
+int q4_parse(const char *sText, s32 *pnValue, const char **psEnd)
+/**
+* \brief       Parse "[-|+]ddd[.ddd]" into a Q12.4 value rounded to the nearest 1/16.
+*
+* \param[in]   *sText       - text to parse
+* \param[out]  *pnValue     - parsed value
+* \param[out]  *psEnd       - set to the first character not parsed (may be NULL)
+*
+* \retval      TRUE if at least one digit was found and the value is in range
+*/
+{
+	const char *p = sText;
+	int nNegative = FALSE;
+	int nDigits = 0, nDecimals = 0;
+	u32 unWhole = 0, unFraction = 0;
+	u32 unValue;
+
+	if(*p == '-' || *p == '+')
+		nNegative = (*p++ == '-');
+	while(*p >= '0' && *p <= '9')
+	{
+		unWhole = unWhole * 10 + (u32)(*p++ - '0');
+		if(unWhole >= Q4_PARSE_MAX_WHOLE)
+			return(FALSE);
+		nDigits++;
+	}
+	if(*p == '.')
+	{
+		p++;
+		while(*p >= '0' && *p <= '9')
+		{
+			if(nDecimals < Q4_PARSE_MAX_DECIMALS)
+			{
+				unFraction = unFraction * 10 + (u32)(*p - '0');
+				nDecimals++;
+			}
+			p++;
+			nDigits++;
+		}
+	}
+	if(psEnd != NULL)
+		*psEnd = p;
+	if(nDigits == 0)
+		return(FALSE);
+
+	unValue = unWhole * Q4_ONE + (unFraction * Q4_ONE + g_aunPowersOfTen[nDecimals] / 2) / g_aunPowersOfTen[nDecimals];
+	*pnValue = nNegative ? -(s32)unValue : (s32)unValue;
+	return(TRUE);
+}
+
+s16 q4_from_float(float fValue)
+/**
+* \brief       Float adapter:  degC to Q12.4, rounded to nearest and saturated to the s16 range.
+*/
+{
+	fValue *= (float)Q4_ONE;
+	if(fValue >= 32767.0f)
+		return(32767);
+	if(fValue <= -32768.0f)
+		return(-32768);
+	return((s16)((fValue >= 0.0f) ? (fValue + 0.5f) : (fValue - 0.5f)));
+}
+
+float q4_to_float(s32 nValue)
+/**
+* \brief       Float adapter:  Q12.4 to degC.
+*/
+{
+	return((float)nValue / (float)Q4_ONE);
+}
@@ -0,0 +1,63 @@
+/** \file fixed_point_utilities.h ********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: fixed_point_utilities.h
+ *         Description: Q12.4 fixed point temperatures:  signed counts of
+ *                      1/16 degC, the native format of the MAX31723
+ *                      temperature and alarm registers.  Conversion, C/F
+ *                      and text formatting use integer arithmetic only;
+ *                      float appears only in the q4_from_float() and
+ *                      q4_to_float() adapters.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef FIXED_POINT_UTILITIES_H_
+#define FIXED_POINT_UTILITIES_H_
+
+#include "xbasic_types.h"
+
+#define Q4_FRACTION_BITS 4
+#define Q4_ONE (1 << Q4_FRACTION_BITS)  //!< 1.0 degC
+#define Q4_FROM_INT(n) ((s32)(n) * Q4_ONE)
+#define Q4_MAX_TEXT 16                  //!< Longest q4_format() output including the terminator ("-134217728.0000")
+
+/*
+ * Values are passed as s32 so intermediate results (Fahrenheit, differences, sums) do not
+ * overflow;  they are stored as s16.
+ */
+
+static inline int q4_compare(s32 nA, s32 nB)
+/**
+* \brief       -1, 0 or 1 as nA is below, equal to or above nB.
+*/
+{
+	return((nA > nB) - (nA < nB));
+}
+
+static inline s32 q4_clamp(s32 nValue, s32 nMin, s32 nMax)
+{
+	return((nValue < nMin) ? nMin : ((nValue > nMax) ? nMax : nValue));
+}
+
+s32 q4_celsius_to_fahrenheit(s32 nCelsius);
+int q4_format(char *sOut, s32 nValue, int nDecimals);
+int q4_parse(const char *sText, s32 *pnValue, const char **psEnd);
+s16 q4_from_float(float fValue);
+float q4_to_float(s32 nValue);
+
+#endif /* FIXED_POINT_UTILITIES_H_ */
@@ -0,0 +1,146 @@
+/** \file interrupt_utilities.c **********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: interrupt_utilities.c
+ *         Description: Interrupt controller (GIC) setup and a periodic tick
+ *                      from the Cortex-A9 private timer, for code that must
+ *                      keep running while the main loop is busy or blocked.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include "xparameters.h"
+#include "xscutimer.h"
+#include "delays.h"
+#include "interrupt_utilities.h"
+#include "memory_sections.h"
+
+XScuGic g_xInterruptController;
+volatile u32 g_unTickCount;
+
+static XScuTimer g_xTickTimer;
+static TickHandler g_pfnTickHandler;
+static void *g_pTickCallbackRef;
+
+
+__fast_text static void tick_timer_isr(void *pCallbackRef)
+/**
+* \brief       Private timer interrupt:  acknowledge it and run the tick handler.
+*/
+{
+	XScuTimer_ClearInterruptStatus(&g_xTickTimer);
+	g_unTickCount++;
+	if(g_pfnTickHandler != NULL)
+		g_pfnTickHandler(g_pTickCallbackRef);
+}
+
+int interrupt_init(void)
+/**
+* \brief       Initialize the GIC and enable IRQ exceptions on this CPU.
+*
+* \retval      XST_SUCCESS, or XST_FAILURE if the GIC could not be initialized
+*/
+{
+	XScuGic_Config *pConfig;
+
+	pConfig = XScuGic_LookupConfig(XPAR_SCUGIC_SINGLE_DEVICE_ID);
+	if(pConfig == NULL)
+		return(XST_FAILURE);
+	if(XScuGic_CfgInitialize(&g_xInterruptController, pConfig, pConfig->CpuBaseAddress) != XST_SUCCESS)
+		return(XST_FAILURE);
+
+	Xil_ExceptionInit();
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+			(Xil_ExceptionHandler)XScuGic_InterruptHandler, &g_xInterruptController);
+	Xil_ExceptionEnable();
+	return(XST_SUCCESS);
+}
+
+int interrupt_connect(u32 unInterruptId, Xil_InterruptHandler pfnHandler, void *pCallbackRef)
+/**
+* \brief       Attach a handler to a GIC interrupt source and enable it.
+*
+* \param[in]   unInterruptId    - interrupt id, e.g. XPAR_SCUTIMER_INTR or an XPAR_FABRIC_... id
+* \param[in]   pfnHandler       - handler, called in IRQ context
+* \param[in]   *pCallbackRef    - argument passed to the handler
+*
+* \retval      XST_SUCCESS, or XST_FAILURE (also when interrupt_init() has not succeeded)
+*/
+{
+	if(g_xInterruptController.IsReady != XIL_COMPONENT_IS_READY)
+		return(XST_FAILURE);
+	if(XScuGic_Connect(&g_xInterruptController, unInterruptId, pfnHandler, pCallbackRef) != XST_SUCCESS)
+		return(XST_FAILURE);
+	XScuGic_Enable(&g_xInterruptController, unInterruptId);
+	return(XST_SUCCESS);
+}
+
+int tick_timer_start(u32 unTickRateHz, TickHandler pfnHandler, void *pCallbackRef)
+/**
+* \brief       Start the private timer as a periodic tick source.
+* \par         Details
+*              The private timer runs at half the CPU clock, the same rate as the global timer.
+*              interrupt_init() must have been called first.
+*
+* \param[in]   unTickRateHz     - tick rate, e.g. TICK_RATE_HZ
+* \param[in]   pfnHandler       - called from the timer interrupt on every tick (may be NULL)
+* \param[in]   *pCallbackRef    - argument passed to pfnHandler
+*
+* \retval      XST_SUCCESS or XST_FAILURE
+*/
+{
+	XScuTimer_Config *pConfig;
+
+	pConfig = XScuTimer_LookupConfig(XPAR_XSCUTIMER_0_DEVICE_ID);
+	if(pConfig == NULL)
+		return(XST_FAILURE);
+	if(XScuTimer_CfgInitialize(&g_xTickTimer, pConfig, pConfig->BaseAddr) != XST_SUCCESS)
+		return(XST_FAILURE);
+
+	g_pfnTickHandler = pfnHandler;
+	g_pTickCallbackRef = pCallbackRef;
+
+	XScuTimer_EnableAutoReload(&g_xTickTimer);
+	XScuTimer_LoadTimer(&g_xTickTimer, (u32)(TICKS_PER_SECOND / unTickRateHz) - 1);
+	if(interrupt_connect(XPAR_SCUTIMER_INTR, (Xil_InterruptHandler)tick_timer_isr, NULL) != XST_SUCCESS)
+		return(XST_FAILURE);
+	XScuTimer_EnableInterrupt(&g_xTickTimer);
+	XScuTimer_Start(&g_xTickTimer);
+	return(XST_SUCCESS);
+}
+
+int tick_timer_set_rate(u32 unTickRateHz)
+/**
+* \brief       Change the rate of a running tick, or stop it.
+* \par         Details
+*              Every tick is a wakeup from WFI, so loops that sleep until an event slow the tick down
+*              while they wait and restore TICK_RATE_HZ afterwards.
+*
+* \param[in]   unTickRateHz     - new tick rate, 0 to stop the tick
+*
+* \retval      XST_SUCCESS, or XST_FAILURE if tick_timer_start() has not succeeded
+*/
+{
+	if(g_xTickTimer.IsReady != XIL_COMPONENT_IS_READY)
+		return(XST_FAILURE);
+	XScuTimer_Stop(&g_xTickTimer);
+	if(unTickRateHz == 0)
+		return(XST_SUCCESS);
+	XScuTimer_LoadTimer(&g_xTickTimer, (u32)(TICKS_PER_SECOND / unTickRateHz) - 1);
+	XScuTimer_Start(&g_xTickTimer);
+	return(XST_SUCCESS);
+}
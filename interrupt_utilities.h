@@ -0,0 +1,65 @@
+/** \file interrupt_utilities.h **********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: interrupt_utilities.h
+ *         Description: Interrupt controller (GIC) setup and a periodic tick
+ *                      from the Cortex-A9 private timer, for code that must
+ *                      keep running while the main loop is busy or blocked.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef INTERRUPT_UTILITIES_H_
+#define INTERRUPT_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "xscugic.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+
+#define TICK_RATE_HZ 1000               //!< Rate of the private timer tick
+
+typedef void (*TickHandler)(void *pCallbackRef);
+
+extern XScuGic g_xInterruptController;
+extern volatile u32 g_unTickCount;
+
+int interrupt_init(void);
+int interrupt_connect(u32 unInterruptId, Xil_InterruptHandler pfnHandler, void *pCallbackRef);
+int tick_timer_start(u32 unTickRateHz, TickHandler pfnHandler, void *pCallbackRef);
+int tick_timer_set_rate(u32 unTickRateHz);
+
+static inline u32 interrupt_disable(void)
+/**
+* \brief       Mask IRQs and return the previous CPSR for interrupt_restore();  pairs nest.
+*/
+{
+	u32 unCpsr = mfcpsr();
+
+	mtcpsr(unCpsr | XIL_EXCEPTION_IRQ);
+	return(unCpsr);
+}
+
+static inline void interrupt_restore(u32 unCpsr)
+/**
+* \brief       Put the IRQ mask back as interrupt_disable() found it.
+*/
+{
+	mtcpsr((mfcpsr() & ~XIL_EXCEPTION_IRQ) | (unCpsr & XIL_EXCEPTION_IRQ));
+}
+
+#endif /* INTERRUPT_UTILITIES_H_ */
@@ -2,6 +2,15 @@
 
 #include "led_utilities.h"
 #include "delays.h"
+#include "interrupt_utilities.h"
+#include "memory_sections.h"
+#include <string.h>
+
+// led_engine_tick() is normally run from the tick timer interrupt.  The setters mask IRQs
+// while they update the engine so the interrupt never sees a half written state, and put the
+// mask back as they found it, so they may be called with IRQs already masked.
+#define LED_ENGINE_LOCK()       u32 unLockCpsr = interrupt_disable()
+#define LED_ENGINE_UNLOCK()     interrupt_restore(unLockCpsr)
 //#include "print_utilities.h"
 //#include "maximPMOD.h"
 
@@ -16,6 +25,9 @@ void led_knight_rider(XGpio *pLED_GPIO, int nNumberOfTimes)
 *              The Digilent NEXYS-3 and Zedboard have 8 green LEDs located above the toggle switches.
 *              This function blinks them back/forth (a bit like the KITT car from Knight Rider)
 *
+* \n           This blocks for the whole animation; led_engine_play(&xEngine, g_axLedKnightRider, ...)
+*              shows the same sweep from led_engine_tick() instead.
+*
 * \param[in]   *pLED_GPIO    - address of the GPIO peripheral driving the LEDs in MicroBlaze memory map
 *
 * \retval      None
@@ -35,15 +47,237 @@ void led_knight_rider(XGpio *pLED_GPIO, int nNumberOfTimes)
 			delay(ABOUT_ONE_SECOND / 15);
 		}
 
-		for(j=0;j<8;j++)  // Scroll the LEDs up
+		for(j=0;j<8;j++)  // Scroll the LEDs down
 		{
-			uchLedStatus = 8 >> j;
+			uchLedStatus = 0x80 >> j;
 				XGpio_DiscreteWrite(pLED_GPIO, 1, uchLedStatus);
 				delay(ABOUT_ONE_SECOND / 15);
 		}
 	}
 }
 
+// Same sweep as led_knight_rider(), one LED at a time up and back down
+const struct maximLedFrame g_axLedKnightRider[] =
+{
+	{ 0x01, 66 }, { 0x02, 66 }, { 0x04, 66 }, { 0x08, 66 },
+	{ 0x10, 66 }, { 0x20, 66 }, { 0x40, 66 }, { 0x80, 66 },
+	{ 0x40, 66 }, { 0x20, 66 }, { 0x10, 66 }, { 0x08, 66 },
+	{ 0x04, 66 }, { 0x02, 66 }
+};
+const int g_nLedKnightRiderFrames = sizeof(g_axLedKnightRider) / sizeof(g_axLedKnightRider[0]);
+
+static void led_engine_apply_pattern(struct maximLedEngine *pEngine, u8 uchPattern)
+/**
+* \brief       Light the LEDs in uchPattern at the engine brightness, all others off.
+*/
+{
+	int i;
+
+	pEngine->uchPattern = uchPattern;
+	for(i=0;i<LED_COUNT;i++)
+		pEngine->auchLevel[i] = ((uchPattern >> i) & 0x01) ? pEngine->uchBrightness : 0;
+}
+
+void led_engine_init(struct maximLedEngine *pEngine, XGpio *pLED_GPIO)
+/**
+* \brief       Initialize the LED engine with all LEDs off.
+* \par         Details
+*              The GPIO must already be initialized and set to outputs.  With pLED_GPIO == NULL
+*              (no LEDs in the hardware design) the engine runs but never touches a GPIO.
+*
+* \param[out]  *pEngine      - LED engine instance
+* \param[in]   *pLED_GPIO    - GPIO peripheral driving the LEDs
+*
+* \retval      None
+*/
+{
+	memset(pEngine, 0, sizeof(*pEngine));
+	pEngine->pLED_GPIO = pLED_GPIO;
+	pEngine->nMode = LED_MODE_STATIC;
+	pEngine->uchBrightness = LED_PWM_LEVELS - 1;
+	if(pLED_GPIO != NULL)
+		XGpio_DiscreteWrite(pLED_GPIO, 1, 0x00);
+}
+
+void led_engine_set_pattern(struct maximLedEngine *pEngine, u8 uchPattern)
+/**
+* \brief       Show a fixed pattern (stops any animation or bar-graph).
+*
+* \param[in]   *pEngine      - LED engine instance
+* \param[in]   uchPattern    - bit n lights LED n
+*
+* \retval      None
+*/
+{
+	LED_ENGINE_LOCK();
+	pEngine->nMode = LED_MODE_STATIC;
+	led_engine_apply_pattern(pEngine, uchPattern);
+	LED_ENGINE_UNLOCK();
+}
+
+void led_engine_set_brightness(struct maximLedEngine *pEngine, u8 uchLevel)
+/**
+* \brief       Set the brightness used for static patterns and animations.
+*
+* \param[in]   *pEngine      - LED engine instance
+* \param[in]   uchLevel      - 0 (off) .. LED_PWM_LEVELS-1 (full on)
+*
+* \retval      None
+*/
+{
+	if(uchLevel > LED_PWM_LEVELS - 1)
+		uchLevel = LED_PWM_LEVELS - 1;
+	LED_ENGINE_LOCK();
+	pEngine->uchBrightness = uchLevel;
+	if(pEngine->nMode != LED_MODE_BARGRAPH)
+		led_engine_apply_pattern(pEngine, pEngine->uchPattern);
+	LED_ENGINE_UNLOCK();
+}
+
+void led_engine_set_pwm(struct maximLedEngine *pEngine, int nEnable)
+/**
+* \brief       Turn the software PWM on or off.
+* \par         Details
+*              The PWM needs the tick at TICK_RATE_HZ to look steady.  While the tick runs slower
+*              (see tick_timer_set_rate()) it is turned off, and each LED is simply on or off.
+*
+* \param[in]   *pEngine      - LED engine instance
+* \param[in]   nEnable       - FALSE while the tick is slowed down
+*
+* \retval      None
+*/
+{
+	LED_ENGINE_LOCK();
+	pEngine->uchPwmHold = !nEnable;
+	pEngine->uchPwmPhase = 0;
+	LED_ENGINE_UNLOCK();
+}
+
+void led_engine_play(struct maximLedEngine *pEngine, const struct maximLedFrame *pFrames, int nFrameCount, int nLoop)
+/**
+* \brief       Start playing a frame table from led_engine_tick().
+*
+* \param[in]   *pEngine      - LED engine instance
+* \param[in]   *pFrames      - frame table, must stay valid while it plays
+* \param[in]   nFrameCount   - number of frames in the table
+* \param[in]   nLoop         - TRUE to repeat, FALSE to hold the last frame
+*
+* \retval      None
+*/
+{
+	if(nFrameCount <= 0)
+		return;
+	LED_ENGINE_LOCK();
+	pEngine->nMode = LED_MODE_ANIMATION;
+	pEngine->pFrames = pFrames;
+	pEngine->nFrameCount = nFrameCount;
+	pEngine->nFrameIndex = 0;
+	pEngine->nLoop = nLoop;
+	pEngine->unFrameStartMs = get_time_ms();
+	led_engine_apply_pattern(pEngine, pFrames[0].uchPattern);
+	LED_ENGINE_UNLOCK();
+}
+
+void led_engine_set_bargraph(struct maximLedEngine *pEngine, s16 nTemp, s16 nLowAlarm, s16 nHighAlarm)
+/**
+* \brief       Show the temperature as a bar-graph between the Tlow and Thigh setpoints.
+* \par         Details
+*              Tlow (or below) is all LEDs off, Thigh (or above) is all LEDs on.  In between, the
+*              LEDs fill up from LD0 and the topmost lit LED is dimmed in proportion, giving
+*              LED_COUNT * (LED_PWM_LEVELS - 1) visible steps.  Call it whenever a new reading is taken.
+*
+* \param[in]   *pEngine      - LED engine instance
+* \param[in]   nTemp         - current temperature, 1/16 degC
+* \param[in]   nLowAlarm     - Tlow setpoint (empty gauge), 1/16 degC
+* \param[in]   nHighAlarm    - Thigh setpoint (full gauge), 1/16 degC
+*
+* \retval      None
+*/
+{
+	int i;
+	int nSteps;
+	int nMaxSteps = LED_COUNT * (LED_PWM_LEVELS - 1);
+
+	if(nHighAlarm <= nLowAlarm || nTemp <= nLowAlarm)
+		nSteps = (nTemp >= nHighAlarm) ? nMaxSteps : 0;
+	else if(nTemp >= nHighAlarm)
+		nSteps = nMaxSteps;
+	else
+		nSteps = ((int)(nTemp - nLowAlarm) * nMaxSteps) / (int)(nHighAlarm - nLowAlarm);
+
+	LED_ENGINE_LOCK();
+	pEngine->nMode = LED_MODE_BARGRAPH;
+	pEngine->uchPattern = 0;
+	for(i=0;i<LED_COUNT;i++)
+	{
+		if(nSteps >= LED_PWM_LEVELS - 1)
+		{
+			pEngine->auchLevel[i] = LED_PWM_LEVELS - 1;
+			nSteps -= LED_PWM_LEVELS - 1;
+		}
+		else
+		{
+			pEngine->auchLevel[i] = (u8)nSteps;
+			nSteps = 0;
+		}
+		if(pEngine->auchLevel[i] != 0)
+			pEngine->uchPattern |= (u8)(1 << i);
+	}
+	LED_ENGINE_UNLOCK();
+}
+
+__fast_text void led_engine_tick(struct maximLedEngine *pEngine, u32 unNowMs)
+/**
+* \brief       Advance the LED engine by one tick.
+* \par         Details
+*              Call this periodically, normally from the tick timer interrupt (tick_timer_start()),
+*              or from the main loop in builds without interrupts.  Each call advances the animation if the current frame has expired and steps the software
+*              PWM by one phase, so the PWM period is (LED_PWM_LEVELS - 1) ticks.  The GPIO is only
+*              written when the output actually changes.
+*
+* \param[in]   *pEngine      - LED engine instance
+* \param[in]   unNowMs       - current time, e.g. get_time_ms()
+*
+* \retval      None
+*/
+{
+	int i;
+	u8 uchOutput=0;
+	u16 uDurationMs;
 
+	if(pEngine->nMode == LED_MODE_ANIMATION)
+	{
+		uDurationMs = pEngine->pFrames[pEngine->nFrameIndex].uDurationMs;
+		while(unNowMs - pEngine->unFrameStartMs >= uDurationMs)
+		{
+			if(pEngine->nFrameIndex + 1 < pEngine->nFrameCount)
+				pEngine->nFrameIndex++;
+			else if(pEngine->nLoop)
+				pEngine->nFrameIndex = 0;
+			else
+			{
+				// Hold the last frame as a static pattern
+				pEngine->nMode = LED_MODE_STATIC;
+				break;
+			}
+			pEngine->unFrameStartMs += uDurationMs;
+			uDurationMs = pEngine->pFrames[pEngine->nFrameIndex].uDurationMs;
+			led_engine_apply_pattern(pEngine, pEngine->pFrames[pEngine->nFrameIndex].uchPattern);
+		}
+	}
 
+	for(i=0;i<LED_COUNT;i++)
+	{
+		if(pEngine->uchPwmHold ? (pEngine->auchLevel[i] >= LED_PWM_LEVELS / 2) : (pEngine->uchPwmPhase < pEngine->auchLevel[i]))
+			uchOutput |= (u8)(1 << i);
+	}
+	pEngine->uchPwmPhase++;
+	if(pEngine->uchPwmPhase >= LED_PWM_LEVELS - 1)
+		pEngine->uchPwmPhase = 0;
 
+	if(uchOutput != pEngine->uchOutput && pEngine->pLED_GPIO != NULL)
+	{
+		pEngine->uchOutput = uchOutput;
+		XGpio_DiscreteWrite(pEngine->pLED_GPIO, 1, uchOutput);
+	}
+}
@@ -68,6 +68,7 @@
 #include "xparameters.h"    
 #include "xgpio.h"          
 #include "xgpio_l.h"        
+#include "mmio_utilities.h"
 //#include "maximPMOD.h"
 #endif /* UTILITIES_H_ */
 
@@ -87,5 +88,46 @@
 // @return:						0 if successful, nonzero otherwise.  Note -- error checking not completed.
 //====================================================================================================
 
+#define LED_COUNT 8                     //!< Number of LEDs driven by the GPIO (Zedboard LD0..LD7)
+#define LED_PWM_LEVELS 8                //!< Software PWM brightness levels, 0 = off .. LED_PWM_LEVELS-1 = full on
+
+#define LED_MODE_STATIC 0               //!< LED engine mode:  fixed pattern
+#define LED_MODE_ANIMATION 1            //!< LED engine mode:  play a frame table
+#define LED_MODE_BARGRAPH 2             //!< LED engine mode:  temperature gauge between Tlow and Thigh
+
+struct maximLedFrame                    //!< One step of an LED animation
+{
+	u8 uchPattern;                      //!< bit n lights LED n
+	u16 uDurationMs;                    //!< how long the frame is shown, must not be 0
+};
+
+struct maximLedEngine                   //!< State of the tick driven LED engine
+{
+	XGpio *pLED_GPIO;
+	int nMode;
+	u8 uchPattern;                      //!< logical pattern currently shown
+	u8 auchLevel[LED_COUNT];            //!< per LED brightness, 0..LED_PWM_LEVELS-1
+	u8 uchBrightness;                   //!< brightness used for static and animation patterns
+	u8 uchPwmPhase;
+	u8 uchPwmHold;                       //!< TRUE: no PWM, LEDs at half brightness or more are fully on
+	u8 uchOutput;                       //!< last value written to the GPIO
+	const struct maximLedFrame *pFrames;
+	int nFrameCount;
+	int nFrameIndex;
+	int nLoop;
+	u32 unFrameStartMs;
+};
+
+extern const struct maximLedFrame g_axLedKnightRider[];
+extern const int g_nLedKnightRiderFrames;
+
 void delay(int nStopValue);
 void led_knight_rider(XGpio *pLED_GPIO, int nNumberOfTimes);
+
+void led_engine_init(struct maximLedEngine *pEngine, XGpio *pLED_GPIO);
+void led_engine_set_pattern(struct maximLedEngine *pEngine, u8 uchPattern);
+void led_engine_set_brightness(struct maximLedEngine *pEngine, u8 uchLevel);
+void led_engine_set_pwm(struct maximLedEngine *pEngine, int nEnable);
+void led_engine_play(struct maximLedEngine *pEngine, const struct maximLedFrame *pFrames, int nFrameCount, int nLoop);
+void led_engine_set_bargraph(struct maximLedEngine *pEngine, s16 nTemp, s16 nLowAlarm, s16 nHighAlarm);
+void led_engine_tick(struct maximLedEngine *pEngine, u32 unNowMs);
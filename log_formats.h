@@ -0,0 +1,41 @@
+/** \file log_formats.h ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: log_formats.h
+ *         Description: Format string table for the deferred logger.  The
+ *                      firmware only stores the index of an entry; the host
+ *                      tool (tools/log_decode.c) includes this same file to
+ *                      turn the index back into text.
+ *
+ *                      Append new entries at the end so that captures taken
+ *                      with older firmware still decode correctly.  Arguments
+ *                      are stored as u32, so only integer conversions
+ *                      (%d %u %x and friends) may be used.
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef LOG_FORMATS_H_
+#define LOG_FORMATS_H_
+
+#define LOG_FORMAT_TABLE(X) \
+	X(LOG_ID_NONE,              "") \
+	X(LOG_ID_SPI_BEGIN,         "SpiRW base=%08x bytes=%u cs_high=%u") \
+	X(LOG_ID_SPI_BYTE,          "Write %02x; Read %02x") \
+	X(LOG_ID_SPI_END,           "SpiRW done") \
+	X(LOG_ID_MAX31723_CONFIG,   "MAX31723 config=%02x") \
+	X(LOG_ID_MAX31723_READ,     "MAX31723 reg=%02x raw=%d (1/16 degC)") \
+	X(LOG_ID_MAX31723_ALARM,    "MAX31723 alarm reg=%02x raw=%d (1/16 degC)") \
+	X(LOG_ID_CMD_LINE,          "Command #%u executed, errors=%u") \
+	X(LOG_ID_THERMOSTAT_START,  "Thermostat tlow=%d thigh=%d (1/16 degC) tout_irq=%u") \
+	X(LOG_ID_THERMOSTAT_EVENT,  "Thermostat event=%u raw=%d (1/16 degC)") \
+	X(LOG_ID_SPI_UNALIGNED,     "SpiRW base=%08x bytes=%u refused: not whole words")
+
+#define LOG_FORMAT_ENUM(id, fmt) id,
+
+enum maximLogFormatId
+{
+	LOG_FORMAT_TABLE(LOG_FORMAT_ENUM)
+	LOG_ID_COUNT
+};
+
+#endif /* LOG_FORMATS_H_ */
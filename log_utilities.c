@@ -0,0 +1,154 @@
+/** \file log_utilities.c ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: log_utilities.c
+ *         Description: Deferred binary logger.  A log call stores a format
+ *                      id, up to three raw u32 arguments and a global timer
+ *                      timestamp into a RAM ring buffer; no formatting is done
+ *                      on the target.  The buffer is drained as hex records
+ *                      over the UART and formatted by tools/log_decode.c.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "xbasic_types.h"
+#include "uart_utilities.h"
+#include "log_utilities.h"
+#include "memory_sections.h"
+
+__fast_bss struct maximLogRing g_xLogRing;
+
+
+static void log_print_entry(u32 unSequence, const struct maximLogEntry *pEntry)
+/**
+* \brief       Print one entry as a hex record understood by tools/log_decode.c.
+* \par         Details
+*              Record layout (all fields hex):
+* \n           LOG <sequence> <timestamp> <format id> <arg count> <arg0> <arg1> <arg2>
+*              The record is 59 characters, less than the 64 byte UART Tx FIFO.
+*
+* \param[in]   unSequence   - running entry number, gaps mean entries were overwritten
+* \param[in]   *pEntry      - entry to print
+*
+* \retval      None
+*/
+{
+	printf("LOG %08lx %08lx %04x %x %08lx %08lx %08lx\r\n",
+			(unsigned long)unSequence, (unsigned long)pEntry->unTimestamp,
+			(unsigned int)pEntry->uFormatId, (unsigned int)pEntry->uchArgCount,
+			(unsigned long)pEntry->aunArgs[0], (unsigned long)pEntry->aunArgs[1],
+			(unsigned long)pEntry->aunArgs[2]);
+}
+
+static int log_take(u32 *punSequence, struct maximLogEntry *pEntry)
+/**
+* \brief       Copy out and remove the oldest entry.
+* \par         Details
+*              log_write() advances the tail itself when the ring is full, from interrupt context
+*              too, so the copy and the tail update are made with IRQs masked;  the copy is then
+*              printed with IRQs enabled, while the slot may already hold a newer entry.
+*
+* \retval      FALSE if the ring was empty
+*/
+{
+	u32 unCpsr = interrupt_disable();
+	int nTaken = FALSE;
+
+	if(g_xLogRing.unHead != g_xLogRing.unTail)
+	{
+		*punSequence = g_xLogRing.unTail;
+		*pEntry = g_xLogRing.axEntries[g_xLogRing.unTail & (LOG_RING_SIZE - 1)];
+		g_xLogRing.unTail++;
+		nTaken = TRUE;
+	}
+	interrupt_restore(unCpsr);
+	return(nTaken);
+}
+
+void log_clear(void)
+/**
+* \brief       Discard all pending entries and reset the lost entry counter.
+*
+* \retval      None
+*/
+{
+	u32 unCpsr = interrupt_disable();
+
+	g_xLogRing.unTail = g_xLogRing.unHead;
+	g_xLogRing.unLost = 0;
+	interrupt_restore(unCpsr);
+}
+
+u32 log_pending(void)
+/**
+* \brief       Number of entries waiting to be drained.
+*
+* \retval      Pending entry count
+*/
+{
+	return(g_xLogRing.unHead - g_xLogRing.unTail);
+}
+
+int log_drain(u32 unUartAddress, int nMaxEntries)
+/**
+* \brief       Lazily drain the log without stalling the caller.
+* \par         Details
+*              An entry is only printed while the UART Tx FIFO is empty, so the record fits in
+*              the FIFO and printf() returns without waiting on the line.  Call it from an idle
+*              loop; it sends at most nMaxEntries records per call.
+*
+* \param[in]   unUartAddress    - address of the UART the records are printed on
+* \param[in]   nMaxEntries      - most records to send in this call
+*
+* \retval      Number of records sent
+*/
+{
+	struct maximLogEntry xEntry;
+	int nSent=0;
+	u32 unSequence;
+
+	while(nSent < nMaxEntries && log_pending() != 0 && checkUartTxEmpty(unUartAddress))
+	{
+		if(!log_take(&unSequence, &xEntry))
+			break;
+		log_print_entry(unSequence, &xEntry);
+		fflush(stdout);
+		nSent++;
+	}
+	return(nSent);
+}
+
+u32 log_dump(void)
+/**
+* \brief       Print every pending entry now, waiting on the UART as needed.
+*
+* \retval      Number of records sent
+*/
+{
+	struct maximLogEntry xEntry;
+	u32 unSent=0;
+	u32 unSequence;
+
+	while(log_take(&unSequence, &xEntry))
+	{
+		log_print_entry(unSequence, &xEntry);
+		unSent++;
+	}
+	fflush(stdout);
+	return(unSent);
+}
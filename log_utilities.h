@@ -0,0 +1,113 @@
+/** \file log_utilities.h ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: log_utilities.h
+ *         Description: Deferred binary logger.  A log call stores a format
+ *                      id, up to three raw u32 arguments and a global timer
+ *                      timestamp into a RAM ring buffer; no formatting is done
+ *                      on the target.  The buffer is drained as hex records
+ *                      over the UART and formatted by tools/log_decode.c.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef LOG_UTILITIES_H_
+#define LOG_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "xil_io.h"
+#include "xtime_l.h"
+#include "interrupt_utilities.h"
+#include "log_formats.h"
+
+#ifndef LOG_ENABLED
+#define LOG_ENABLED 1                   //!< Set to 0 (e.g. -DLOG_ENABLED=0) to compile all log calls out
+#endif
+#ifndef LOG_SPI_BYTES
+#define LOG_SPI_BYTES 0                 //!< 1 to log every SPI byte (LOG_ID_SPI_BYTE);  costs a timer read per byte
+#endif
+
+#define LOG_RING_SIZE 1024              //!< Number of entries in the ring buffer.  Must be a power of two.
+#define LOG_MAX_ARGS 3                  //!< Raw arguments stored per entry
+
+// Lower 32 bits of the Cortex-A9 global timer: a single register read, TICKS_PER_SECOND ticks per second
+#define LOG_TIMESTAMP() Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_COUNTER_LOWER_OFFSET)
+
+struct maximLogEntry                    //!< One deferred log record (20 bytes)
+{
+	u32 unTimestamp;
+	u16 uFormatId;
+	u8 uchArgCount;
+	u8 uchReserved;
+	u32 aunArgs[LOG_MAX_ARGS];
+};
+
+struct maximLogRing                     //!< Ring buffer; the oldest entries are overwritten when full
+{
+	u32 unHead;                         //!< Total number of entries ever written
+	u32 unTail;                         //!< Total number of entries drained or overwritten
+	u32 unLost;                         //!< Entries overwritten before they could be drained
+	struct maximLogEntry axEntries[LOG_RING_SIZE];
+};
+
+extern struct maximLogRing g_xLogRing;
+
+static inline void log_write(u16 uFormatId, u8 uchArgCount, u32 unArg0, u32 unArg1, u32 unArg2)
+/**
+* \brief       Store one log entry.  Called through the LOGn() macros.
+* \par         Details
+*              Only stores and index updates with IRQs masked, so an interrupt handler may log
+*              while the main loop does:  each entry is claimed and filled as one step.
+*/
+{
+	struct maximLogEntry *pEntry;
+	u32 unCpsr = interrupt_disable();
+
+	if(g_xLogRing.unHead - g_xLogRing.unTail == LOG_RING_SIZE)
+	{
+		g_xLogRing.unTail++;
+		g_xLogRing.unLost++;
+	}
+	pEntry = &g_xLogRing.axEntries[g_xLogRing.unHead & (LOG_RING_SIZE - 1)];
+	pEntry->unTimestamp = LOG_TIMESTAMP();
+	pEntry->uFormatId = uFormatId;
+	pEntry->uchArgCount = uchArgCount;
+	pEntry->aunArgs[0] = unArg0;
+	pEntry->aunArgs[1] = unArg1;
+	pEntry->aunArgs[2] = unArg2;
+	g_xLogRing.unHead++;
+	interrupt_restore(unCpsr);
+}
+
+#if LOG_ENABLED
+#define LOG0(id)            log_write((id), 0, 0, 0, 0)
+#define LOG1(id, a)         log_write((id), 1, (u32)(a), 0, 0)
+#define LOG2(id, a, b)      log_write((id), 2, (u32)(a), (u32)(b), 0)
+#define LOG3(id, a, b, c)   log_write((id), 3, (u32)(a), (u32)(b), (u32)(c))
+#else
+#define LOG0(id)            do { } while(0)
+#define LOG1(id, a)         do { (void)(a); } while(0)
+#define LOG2(id, a, b)      do { (void)(a); (void)(b); } while(0)
+#define LOG3(id, a, b, c)   do { (void)(a); (void)(b); (void)(c); } while(0)
+#endif
+
+void log_clear(void);
+u32 log_pending(void);
+int log_drain(u32 unUartAddress, int nMaxEntries);
+u32 log_dump(void);
+
+#endif /* LOG_UTILITIES_H_ */
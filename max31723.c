@@ -68,25 +68,113 @@
 #include "uart_utilities.h"
 #include "print_utilities.h"
 #include "spi_utilities.h"
+#include "spi_fixed.h"
+#include "fixed_point_utilities.h"
 #include "string.h"
 #include "max31723_utilities.h"
 #include "max31723.h"
 #include "led_utilities.h"
-//#include "oled_utilities.h"
+#include "command_utilities.h"
+#include "interrupt_utilities.h"
+#include "acquisition_utilities.h"
+#include "sample_store.h"
+#include "max31723_cache.h"
+#include "thermostat_utilities.h"
+#include "adaptive_sampling.h"
+#include "sensor_array.h"
+#include "max31855_utilities.h"
+#include "spi_backend.h"
+#include "amp_utilities.h"
+#include "memory_sections.h"
+#include "mmu_utilities.h"
+#include "profile_utilities.h"
+#include "oled_utilities.h"
+#include "report_filter.h"
 #include "delays.h"
 
+__fast_bss static struct maximLedEngine g_xLedEngine;    // Zedboard LEDs, used as a live temperature gauge
+__fast_bss static struct maximSampleStore g_xSampleStore; // Menu and command readings, with running statistics
+__fast_bss static struct maximMax31723Cache g_xSensorCache; // Every menu and command read of the MAX31723 goes through this
+
+#ifndef SENSOR_ARRAY_TABLE
+#define SENSOR_ARRAY_TABLE { XPAR_AXI_QUAD_SPI_0_BASEADDR, 0 }  // (controller, slave select) of each MAX31723 read by SCAN
+#endif
+static const struct maximSensorArrayEntry g_axSensorTable[] = { SENSOR_ARRAY_TABLE };
+static struct maximSensorArray g_xSensorArray;
+
+#ifndef THERMOCOUPLE_SLAVE
+#define THERMOCOUPLE_SLAVE -1   // AXI Quad SPI slave select of a MAX31855 (slave 1 is the QSPI flash), -1 for none
+#endif
+#if THERMOCOUPLE_SLAVE >= 0
+static struct maximMax31855 g_xThermocouple;  // Polled at its 10 Hz conversion rate by command mode, read by TC
+#define THERMOCOUPLE (&g_xThermocouple)
+#else
+#define THERMOCOUPLE NULL
+#endif
+
+__fast_bss static struct maximReportFilter g_xLedReport;    // Report-on-change filters of the display sinks
+__fast_bss static struct maximReportFilter g_xOledReport;
+
+__fast_text static void led_tick_handler(void *pCallbackRef)
+{
+	led_engine_tick((struct maximLedEngine *)pCallbackRef, get_time_ms());
+}
+
+static void publish_reading(s16 nTemp, s16 nLowAlarm, s16 nHighAlarm, int displayCelsius)
+/**
+* \brief       Show a reading on the LED bargraph and, once it is initialised, the OLED.
+* \par         Details
+*              Both displays hold what they show, so each is only rewritten when its filter
+*              reports a change or an alarm zone crossing.
+*/
+{
+	u32 unNow = get_time_ms();
+
+	if(report_filter_offer(&g_xLedReport, nTemp, nLowAlarm, nHighAlarm, unNow) != REPORT_NONE)
+		led_engine_set_bargraph(&g_xLedEngine, nTemp, nLowAlarm, nHighAlarm);
+	if(g_structureOLED.font != NULL && report_filter_offer(&g_xOledReport, nTemp, nLowAlarm, nHighAlarm, unNow) != REPORT_NONE)
+		printOLED_31723(nTemp, displayCelsius);
+}
+
+static void read_temperature(s16 *pnTemp)
+/**
+* \brief       Temperature for the menu, which may wait:  after a configuration change the cache has no
+*              result until the first conversion at the new configuration completes.
+*/
+{
+	while(max31723_cache_read_raw(&g_xSensorCache, pnTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+		;
+}
+
 int main()
 
 {
 	int nMenuState = 0;
 	u8 uchInput=0;
 	int menuActive=TRUE;
-	float fTemp=0.0f;
+	s16 nTemp=0;
 	int displayCelsius=TRUE;
 	int i;
-	float fHighAlarmSetting=0.0f;
-	float fLowAlarmSetting=0.0f;
+	s16 nHighAlarmSetting=0;
+	s16 nLowAlarmSetting=0;
 	int Status;
+	struct maximCommandInterface xCommandInterface;
+	static struct maximThermostatMonitor xThermostat;
+	int nThermostatEvent;
+	static struct maximAdaptiveSampler xSampler;
+	u32 unLastPeriodMs;
+	struct maximReportConfig xReportConfig;
+	struct maximReportFilter xUartReport;
+	int nReportReasons;
+	int nInterruptsReady=FALSE;
+	u32 unLastCommandReadCount=0;
+	int nBootMode=BOOT_MODE_DEFAULT;
+#if !AMP_ENABLED
+	__fast_bss static struct maximAcquisition xAcquisition;
+#endif
+#ifdef XPAR_AXI_GPIO_LED_DEVICE_ID
+	static XGpio xLedGpio;
+#endif
 	//float temperature;
 	//float previous_temperature;
 
@@ -98,6 +186,11 @@ int main()
 	//cs Set the active port type to SPI
 	//cs max_set_PMOD_port(g_nActivePMODPort, PMOD_PORT_TYPE_SPI);
 
+	// Copy the __fast_ code and data to OCM before anything uses them, then set up the memory map
+	ocm_sections_init();
+	mmu_init();
+	prof_init();
+
 	// ------------------- SPI related functions --------------------- //
 	// Initialize the SPI driver
 	SPI_ConfigPtr = XSpi_LookupConfig(XPAR_AXI_QUAD_SPI_0_DEVICE_ID);
@@ -113,8 +206,86 @@ int main()
 	Status = XSpi_SelfTest(&SpiInstance);
 	if (Status != XST_SUCCESS) return XST_FAILURE;
 
-	// Run loopback test only in case of standard SPI mode.
-	if (SpiInstance.SpiMode != XSP_STANDARD_MODE) return XST_SUCCESS;
+	// SpiRW() packs bytes into words on cores built wider than 8 bits;  the MAX31723 driver's
+	// transfers are specialized for SPI_FIXED_WORD_BYTES at compile time
+	spi_set_transfer_width(SPI_ConfigPtr->BaseAddress, SpiInstance.DataWidth);
+	if (SpiInstance.DataWidth != SPI_FIXED_WORD_BYTES * 8)
+		printf("\r\nSPI core is %d bits wide, fixed transfers are built for %d\r\n",
+				(int)SpiInstance.DataWidth, SPI_FIXED_WORD_BYTES * 8);
+
+	// The MAX31723 is slave 0 with an active high CE.  The SPI mode (C_SPI_MODE) is only used by
+	// the flash commands to pick their read and program opcodes;  in dual and quad mode the core
+	// supports SPI modes 0 and 3 only, so MAX31723 transfers (mode 1) need a standard mode core
+	spi_set_slave_polarity(SPI_ConfigPtr->BaseAddress, 0, TRUE);
+	if (SpiInstance.SpiMode != XSP_STANDARD_MODE)
+		printf("\r\nSPI core in %s mode, MAX31723 transfers need standard mode\r\n",
+				(SpiInstance.SpiMode == XSP_QUAD_MODE) ? "quad" : "dual");
+
+	// ------------------- LED gauge, updated from the tick interrupt ----------- //
+#ifdef XPAR_AXI_GPIO_LED_DEVICE_ID
+	XGpio_Initialize(&xLedGpio, XPAR_AXI_GPIO_LED_DEVICE_ID);
+	XGpio_SetDataDirection(&xLedGpio, 1, 0x00);	// Set the LED peripheral to outputs
+	led_engine_init(&g_xLedEngine, &xLedGpio);
+#else
+	led_engine_init(&g_xLedEngine, NULL);
+#endif
+	if(interrupt_init() == XST_SUCCESS)
+		nInterruptsReady = (tick_timer_start(TICK_RATE_HZ, led_tick_handler, &g_xLedEngine) == XST_SUCCESS);
+	led_engine_play(&g_xLedEngine, g_axLedKnightRider, g_nLedKnightRiderFrames, TRUE);  // until the first reading
+#if SPI_BACKEND_INTERRUPTS
+	if(nInterruptsReady)
+	{
+#ifdef XPAR_FABRIC_AXI_QUAD_SPI_0_IP2INTC_IRPT_INTR
+		spi_backend_attach_interrupt(XPAR_AXI_QUAD_SPI_0_BASEADDR, XPAR_FABRIC_AXI_QUAD_SPI_0_IP2INTC_IRPT_INTR);
+#endif
+#if defined(XPAR_XSPIPS_0_BASEADDR) && defined(XPAR_XSPIPS_0_INTR)
+		spi_backend_attach_interrupt(XPAR_XSPIPS_0_BASEADDR, XPAR_XSPIPS_0_INTR);
+#endif
+#if defined(XPAR_XSPIPS_1_BASEADDR) && defined(XPAR_XSPIPS_1_INTR)
+		spi_backend_attach_interrupt(XPAR_XSPIPS_1_BASEADDR, XPAR_XSPIPS_1_INTR);
+#endif
+	}
+#endif
+
+	mmu_report(XPAR_AXI_QUAD_SPI_0_BASEADDR);
+	sample_store_init(&g_xSampleStore);
+	report_default_config(&xReportConfig);
+	xReportConfig.unMaxSilenceMs = 0;
+	report_filter_init(&g_xLedReport, &xReportConfig);
+	report_filter_init(&g_xOledReport, &xReportConfig);
+
+	// ------------------- Boot mode selection ----------------------------------- //
+	printf("\r\nPress H for headless acquisition or M for the menu (default %s)\r\n",
+			(BOOT_MODE_DEFAULT == BOOT_MODE_HEADLESS) ? "headless" : "menu");
+	if(receive_byte_with_timeout(XPAR_XUARTPS_0_BASEADDR, BOOT_SELECT_TIMEOUT, &uchInput))
+	{
+		if(uchInput == 'H' || uchInput == 'h')
+			nBootMode = BOOT_MODE_HEADLESS;
+		else if(uchInput == 'M' || uchInput == 'm')
+			nBootMode = BOOT_MODE_MENU;
+	}
+	if(nBootMode == BOOT_MODE_HEADLESS)
+	{
+		// Runs until 'Q', then falls through to the menu
+#if AMP_ENABLED
+		amp_run_headless(XPAR_XUARTPS_0_BASEADDR, XPAR_AXI_QUAD_SPI_0_BASEADDR,
+				ACQ_DEFAULT_CONFIGURATION, ACQ_DEFAULT_PERIOD_US);
+#else
+		acq_init(&xAcquisition, XPAR_AXI_QUAD_SPI_0_BASEADDR, XPAR_XUARTPS_0_BASEADDR,
+				ACQ_DEFAULT_CONFIGURATION, ACQ_DEFAULT_PERIOD_US, NULL);
+		acq_run_headless(&xAcquisition);
+#endif
+	}
+	uchInput = 0;
+
+	// One configuration write for the whole session;  the headless loops above write their own.
+	// The array sensors are shut down between scans, except the cached one (slave 0 by default).
+	sensor_array_init(&g_xSensorArray, g_axSensorTable, sizeof(g_axSensorTable) / sizeof(g_axSensorTable[0]),
+			MAX31723_CONFIG_RESOLUTION_12BIT);
+	max31723_cache_init(&g_xSensorCache, XPAR_AXI_QUAD_SPI_0_BASEADDR, MAX31723_CONFIG_12BIT_CONTINUOUS);
+#if THERMOCOUPLE_SLAVE >= 0
+	max_MAX31855_init(&g_xThermocouple, XPAR_AXI_QUAD_SPI_0_BASEADDR, THERMOCOUPLE_SLAVE);
+#endif
 	
 	// --------------------------------------------------------------------------//
 	// Main Loop 
@@ -127,25 +298,35 @@ int main()
 			case 0:
 				menu_cls();
 				printf("MAX31723 Digital Thermometer:\r\n\r\n");
-				//max_MAX31723_get_temp(&fLowAlarmSetting, g_unActivePeripheralAddressSPI, MAX31723_LOW_ALARM_READ);
-				max_MAX31723_get_temp(&fLowAlarmSetting, XPAR_AXI_QUAD_SPI_0_BASEADDR, MAX31723_LOW_ALARM_READ);
-				//max_MAX31723_get_temp(&fHighAlarmSetting, g_unActivePeripheralAddressSPI, MAX31723_HIGH_ALARM_READ);
-				max_MAX31723_get_temp(&fHighAlarmSetting, XPAR_AXI_QUAD_SPI_0_BASEADDR, MAX31723_HIGH_ALARM_READ);
+				// Served from the cache;  the part is only read after a setpoint was written
+				max31723_cache_read_raw(&g_xSensorCache, &nLowAlarmSetting, MAX31723_LOW_ALARM_READ);
+				max31723_cache_read_raw(&g_xSensorCache, &nHighAlarmSetting, MAX31723_HIGH_ALARM_READ);
 				printf("Last temp reading = ");
-				printf_temp(fTemp,displayCelsius,TRUE);
+				printf_temp_q4(nTemp,displayCelsius,TRUE);
 				printf("Low Alarm Setpoint = ");
-				printf_temp(fLowAlarmSetting,displayCelsius,TRUE);
+				printf_temp_q4(nLowAlarmSetting,displayCelsius,TRUE);
 				printf("High Alarm Setpoint = ");
-				printf_temp(fHighAlarmSetting,displayCelsius,TRUE);
+				printf_temp_q4(nHighAlarmSetting,displayCelsius,TRUE);
+#if THERMOCOUPLE_SLAVE >= 0
+				max_MAX31855_poll(&g_xThermocouple, get_time_us());
+				printf("Thermocouple = ");
+				if(g_xThermocouple.xLast.uchFaults)
+					printf("fault %s\r\n", max_MAX31855_fault_name(g_xThermocouple.xLast.uchFaults));
+				else
+					printf_temp_q4(g_xThermocouple.xLast.nProbe,displayCelsius,TRUE);
+#endif
 				menu_print_line();
 
 				printf("1.  Retrieve ( 1)    temp reading\r\n");
 				printf("2.  Retrieve (20)    temp reading(s)\r\n");
-				printf("3.  Retrieve temp indefinitely\r\n");
+				printf("3.  Retrieve temp indefinitely (adaptive rate)\r\n");
 				printf("4.  Directly enter low alarm setpoint\r\n");
 				printf("5.  Directly enter high alarm setpoint\r\n");
 
 				printf("6.  Toggle display degC / degF\r\n");
+				printf("7.  Scripted command mode (type EXIT to leave)\r\n");
+				printf("8.  Reading statistics\r\n");
+				printf("0.  Alarm monitor (sleeps until TOUT fires)\r\n");
 				printf("\r\n9.  Return to main menu\r\n");
 				menu_print_prompt();
 				nMenuState = 1;
@@ -156,10 +337,56 @@ int main()
 				nMenuState = uchInput+10;
 				break;
 
+			case 10:
+				printf("\r\nMonitoring %s, any key to exit:\r\n",
+						thermostat_init(&xThermostat, &g_xSensorCache, nLowAlarmSetting, nHighAlarmSetting,
+								THERMOSTAT_HEARTBEAT_MS) ? "TOUT interrupts" : "heartbeat only");
+				menu_print_line();
+				fflush(stdout);
+				// Leave TOUT as the only frequent wakeup:  the LEDs go without PWM at the slow tick
+				if(nInterruptsReady)
+				{
+					led_engine_set_pwm(&g_xLedEngine, FALSE);
+					tick_timer_set_rate(THERMOSTAT_TICK_RATE_HZ);
+				}
+				while(checkUartEmpty(XPAR_XUARTPS_0_BASEADDR))
+				{
+					if(nInterruptsReady)
+						THERMOSTAT_WAIT();
+					nThermostatEvent = thermostat_poll(&xThermostat, &nTemp);
+					if(nThermostatEvent == THERMOSTAT_EVENT_NONE)
+						continue;
+					sample_store_add_raw(&g_xSampleStore, nTemp, 0);
+					publish_reading(nTemp, nLowAlarmSetting, nHighAlarmSetting, displayCelsius);
+					if(nThermostatEvent == THERMOSTAT_EVENT_HIGH)
+						printf("ALARM HIGH  ");
+					else if(nThermostatEvent == THERMOSTAT_EVENT_LOW)
+						printf("ALARM CLEAR ");
+					else
+						printf("            ");
+					printf_temp_q4(nTemp,displayCelsius,TRUE);
+					fflush(stdout);
+				}
+				menu_retrieve_keypress(XPAR_XUARTPS_0_BASEADDR);
+				if(nInterruptsReady)
+				{
+					tick_timer_set_rate(TICK_RATE_HZ);
+					led_engine_set_pwm(&g_xLedEngine, TRUE);
+				}
+				thermostat_stop(&xThermostat);
+				printf("%lu alarm events, %lu TOUT interrupts, %lu heartbeats\r\n",
+						(unsigned long)xThermostat.unEventCount, (unsigned long)xThermostat.unInterruptCount,
+						(unsigned long)xThermostat.unHeartbeatCount);
+				printf("Hit any key to continue:\r\n");
+				fflush(stdout);
+				menu_retrieve_keypress(XPAR_XUARTPS_0_BASEADDR);
+				nMenuState = 0;
+				break;
 			case 11:
-				max_MAX31723_get_temp(&fTemp, XPAR_AXI_QUAD_SPI_0_BASEADDR,MAX31723_TEMP_READ);
+				read_temperature(&nTemp);
+				sample_store_add_raw(&g_xSampleStore, nTemp, 0);
+				publish_reading(nTemp, nLowAlarmSetting, nHighAlarmSetting, displayCelsius);
 				//print_seven_segment_temperature(fTemp,displayCelsius);
-				//printOLED_31723(fTemp);
 				nMenuState = 0;
 				break;
 			case 12:
@@ -167,11 +394,12 @@ int main()
 				fflush(stdout);
 				for(i=0;i<20;i++)
 				{
-					max_MAX31723_get_temp(&fTemp, XPAR_AXI_QUAD_SPI_0_BASEADDR,MAX31723_TEMP_READ);
+					read_temperature(&nTemp);
+					sample_store_add_raw(&g_xSampleStore, nTemp, 0);
+					publish_reading(nTemp, nLowAlarmSetting, nHighAlarmSetting, displayCelsius);
 					printf("%d of 20 samples = ",i+1);
-					printf_temp(fTemp,displayCelsius,TRUE);
+					printf_temp_q4(nTemp,displayCelsius,TRUE);
 					//print_seven_segment_temperature(fTemp,displayCelsius);
-					//printOLED_31723(fTemp);
 					delay(ABOUT_ONE_SECOND / 2);
 				}
 				nMenuState=0;
@@ -180,25 +408,67 @@ int main()
 				printf("Hit any key to exit:\r\n");
 				menu_print_line();
 				fflush(stdout);
+				// The period follows dT/dt:  full rate while the temperature moves, down to one
+				// one-shot conversion every few seconds while it is stable.  Only readings that changed,
+				// crossed a setpoint or follow a period change are printed.
+				adaptive_init(&xSampler, &g_xSensorCache, NULL);
+				report_filter_init(&xUartReport, NULL);
+				unLastPeriodMs = 0;
 				while(checkUartEmpty(XPAR_XUARTPS_0_BASEADDR))
 				{
-					max_MAX31723_get_temp(&fTemp, XPAR_AXI_QUAD_SPI_0_BASEADDR,MAX31723_TEMP_READ);
-					printf_temp(fTemp,displayCelsius,TRUE);
+					if(!adaptive_poll(&xSampler, &nTemp))
+					{
+						if(nInterruptsReady)
+							THERMOSTAT_WAIT();
+						continue;
+					}
+					sample_store_add_raw(&g_xSampleStore, nTemp, 0);
+					publish_reading(nTemp, nLowAlarmSetting, nHighAlarmSetting, displayCelsius);
 					//print_seven_segment_temperature(fTemp,displayCelsius);
-					//printOLED_31723(fTemp);
-					delay(ABOUT_ONE_SECOND/2);
+
+					if(xSampler.unPeriodMs != unLastPeriodMs)
+						report_filter_force(&xUartReport);
+					nReportReasons = report_filter_offer(&xUartReport, nTemp, nLowAlarmSetting, nHighAlarmSetting, get_time_ms());
+					if(nReportReasons == REPORT_NONE)
+						continue;
+					printf_temp_q4(nTemp,displayCelsius,FALSE);
+					if(nReportReasons & REPORT_ZONE)
+					{
+						if(xUartReport.uchZone == REPORT_ZONE_HIGH)
+							printf("   above Thigh");
+						else if(xUartReport.uchZone == REPORT_ZONE_LOW)
+							printf("   below Tlow");
+						else
+							printf("   back in range");
+					}
+					if(xSampler.unPeriodMs != unLastPeriodMs)
+					{
+						printf("   (every %lu ms)", (unsigned long)xSampler.unPeriodMs);
+						unLastPeriodMs = xSampler.unPeriodMs;
+					}
+					printf("\r\n");
+					fflush(stdout);
 				}
 				menu_retrieve_keypress(XPAR_XUARTPS_0_BASEADDR);
+				adaptive_stop(&xSampler);
+				printf("\r\n%lu samples, %lu from one-shot conversions, %lu printed\r\n",
+						(unsigned long)xSampler.unSampleCount, (unsigned long)xSampler.unOneShotCount,
+						(unsigned long)xUartReport.unReported);
+				printf("\r\n");
+				sample_store_print(&g_xSampleStore, displayCelsius);
+				printf("Hit any key to continue:\r\n");
+				fflush(stdout);
+				menu_retrieve_keypress(XPAR_XUARTPS_0_BASEADDR);
 				nMenuState=0;
 				break;
 			case 14:
-				fLowAlarmSetting = (float)menu_get_direct_entry(XPAR_XUARTPS_0_BASEADDR,7);
-				max_MAX31723_set_alarm(fLowAlarmSetting,XPAR_AXI_QUAD_SPI_0_BASEADDR,MAX31723_LOW_ALARM_WRITE);
+				nLowAlarmSetting = (s16)q4_clamp(Q4_FROM_INT(menu_get_direct_entry(XPAR_XUARTPS_0_BASEADDR,7)), MAX31723_TEMP_MIN_Q4, MAX31723_TEMP_MAX_Q4);
+				max31723_cache_set_alarm(&g_xSensorCache, nLowAlarmSetting, MAX31723_LOW_ALARM_WRITE);
 				nMenuState=0;
 				break;
 			case 15:
-				fHighAlarmSetting = (float)menu_get_direct_entry(XPAR_XUARTPS_0_BASEADDR,7);
-				max_MAX31723_set_alarm(fHighAlarmSetting,XPAR_AXI_QUAD_SPI_0_BASEADDR,MAX31723_HIGH_ALARM_WRITE);
+				nHighAlarmSetting = (s16)q4_clamp(Q4_FROM_INT(menu_get_direct_entry(XPAR_XUARTPS_0_BASEADDR,7)), MAX31723_TEMP_MIN_Q4, MAX31723_TEMP_MAX_Q4);
+				max31723_cache_set_alarm(&g_xSensorCache, nHighAlarmSetting, MAX31723_HIGH_ALARM_WRITE);
 				nMenuState=0;
 				break;
 			case 16:
@@ -207,10 +477,39 @@ int main()
 				else
 					displayCelsius=TRUE;
 				//print_seven_segment_temperature(fTemp,displayCelsius);
-				//printOLED_31723(fTemp);
+				report_filter_force(&g_xOledReport);
+				publish_reading(nTemp, nLowAlarmSetting, nHighAlarmSetting, displayCelsius);
 
 				nMenuState = 0;
 				break;
+			case 17:
+				printf("\r\nOK COMMAND MODE\r\n");
+				fflush(stdout);
+				cmd_init(&xCommandInterface, XPAR_XUARTPS_0_BASEADDR, &g_xSensorCache, &g_xSampleStore, &g_xSensorArray,
+						THERMOCOUPLE);
+				xCommandInterface.uchSpiMode = SpiInstance.SpiMode;
+				unLastCommandReadCount = 0;
+				while(cmd_poll(&xCommandInterface))
+				{
+					if(xCommandInterface.unReadCount != unLastCommandReadCount)
+					{
+						unLastCommandReadCount = xCommandInterface.unReadCount;
+						nTemp = xCommandInterface.nLastTemp;
+						publish_reading(nTemp, xCommandInterface.nLowAlarm, xCommandInterface.nHighAlarm, displayCelsius);
+					}
+				}
+				nMenuState = 0;
+				break;
+			case 18:
+				printf("\r\n");
+				sample_store_print(&g_xSampleStore, displayCelsius);
+				printf("\r\nR to reset the statistics, any other key to return:\r\n");
+				fflush(stdout);
+				uchInput = menu_retrieve_keypress(XPAR_XUARTPS_0_BASEADDR);
+				if(uchInput == 'R')
+					sample_store_init(&g_xSampleStore);
+				nMenuState = 0;
+				break;
 			case 19:
 				menuActive=FALSE;
 				break;
@@ -75,6 +75,13 @@
 #define MENU_MAX31723 66            //!< MAX31723 menu selected by pressing "B"
 #define MENU_SET_ACTIVE_PMOD 69		//!< Change active PMOD Port by pressing "E"
 
+#define BOOT_MODE_MENU 0            //!< Start the interactive menu
+#define BOOT_MODE_HEADLESS 1        //!< Start headless acquisition (see acquisition_utilities.h)
+#ifndef BOOT_MODE_DEFAULT
+#define BOOT_MODE_DEFAULT BOOT_MODE_MENU    //!< Mode used when no key is pressed at boot
+#endif
+#define BOOT_SELECT_TIMEOUT 20      //!< Time allowed to choose the boot mode, in tenths of a second
+
 #define KEYPRESS_ARROW_UP 240       //!< Assign up-arrow an extended ascii code which won't be used elsewhere
 #define KEYPRESS_ARROW_DOWN 241     //!< Assign up-arrow an extended ascii code which won't be used elsewhere
 #define KEYPRESS_ARROW_LEFT 242     //!< Assign up-arrow an extended ascii code which won't be used elsewhere
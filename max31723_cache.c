@@ -0,0 +1,152 @@
+/** \file max31723_cache.c ***************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: max31723_cache.c
+ *         Description: Register cache in front of the MAX31723 driver.  The
+ *                      menu, command interface, LEDs and displays read the
+ *                      sensor through one cache, so a value is fetched over
+ *                      SPI at most once per validity period however many
+ *                      consumers ask for it.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "max31723_utilities.h"
+#include "max31723_cache.h"
+#include "register_map.h"
+#include "log_utilities.h"
+#include "memory_sections.h"
+
+
+static const u8 g_auchCacheRegisters[MAX31723_CACHE_ENTRIES] =  // g_xMax31723Device register of each entry
+{
+	MAX31723_REG_TEMP, MAX31723_REG_LOW_ALARM, MAX31723_REG_HIGH_ALARM
+};
+
+static int max31723_cache_entry(u8 uchRegister)
+/**
+* \brief       Cache entry of a read or write register address.
+*/
+{
+	if(uchRegister == MAX31723_LOW_ALARM_READ || uchRegister == MAX31723_LOW_ALARM_WRITE)
+		return(MAX31723_CACHE_LOW_ALARM);
+	if(uchRegister == MAX31723_HIGH_ALARM_READ || uchRegister == MAX31723_HIGH_ALARM_WRITE)
+		return(MAX31723_CACHE_HIGH_ALARM);
+	return(MAX31723_CACHE_TEMP);
+}
+
+void max31723_cache_init(struct maximMax31723Cache *pCache, u32 unPeripheralAddressSPI, u8 uchConfiguration)
+/**
+* \brief       Empty the cache and write the MAX31723 configuration once.
+*
+* \param[out]  *pCache                  - cache instance
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral the MAX31723 is attached to (slave 0)
+* \param[in]   uchConfiguration         - configuration byte, normally MAX31723_CONFIG_12BIT_CONTINUOUS
+*
+* \retval      None
+*/
+{
+	memset(pCache, 0, sizeof(*pCache));
+	pCache->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	regmap_init(&pCache->xRegisters, &g_xMax31723Device, unPeripheralAddressSPI, 0);
+	max31723_cache_configure(pCache, uchConfiguration);
+}
+
+int max31723_cache_configure(struct maximMax31723Cache *pCache, u8 uchConfiguration)
+/**
+* \brief       Write the configuration register and restart the temperature validity period.
+* \par         Details
+*              The register map invalidates the temperature and sets its validity period to the
+*              conversion time of the new resolution.  Until the first conversion at the new
+*              configuration has completed, temperature reads return MAX31723_CACHE_NOT_READY.
+*
+* \param[in]   *pCache              - cache instance
+* \param[in]   uchConfiguration     - configuration byte
+*
+* \retval      Always True
+*/
+{
+	LOG1(LOG_ID_MAX31723_CONFIG, uchConfiguration);
+	regmap_write(&pCache->xRegisters, MAX31723_REG_CONFIG, uchConfiguration);
+	pCache->uchConfiguration = uchConfiguration;
+	return(TRUE);
+}
+
+__fast_text int max31723_cache_read_raw(struct maximMax31723Cache *pCache, s16 *pnTemp, u8 uchTemperatureRegister)
+/**
+* \brief       Cached max_MAX31723_read_raw().
+* \par         Details
+*              The part is only read when the register is not in the register map or is older than
+*              its validity period.  It never waits:  a temperature read too soon after
+*              max31723_cache_configure() returns the last temperature and MAX31723_CACHE_NOT_READY,
+*              and callers poll again later.
+*
+* \param[in]   *pCache                  - cache instance
+* \param[out]  *pnTemp                  - value in 1/16 degC
+* \param[in]   uchTemperatureRegister   - MAX31723_TEMP_READ, MAX31723_LOW_ALARM_READ or MAX31723_HIGH_ALARM_READ
+*
+* \retval      TRUE if the value came from the cache, FALSE if the part was read, or MAX31723_CACHE_NOT_READY
+*/
+{
+	int nEntry = max31723_cache_entry(uchTemperatureRegister);
+	s32 lValue;
+	int nResult;
+
+	nResult = regmap_read(&pCache->xRegisters, &g_auchCacheRegisters[nEntry], 1, &lValue);
+	if(nResult == REGMAP_NOT_READY)
+	{
+		*pnTemp = (s16)lValue;
+		return(MAX31723_CACHE_NOT_READY);
+	}
+	if(nResult == 0)
+	{
+		pCache->axEntries[nEntry].unHits++;
+		*pnTemp = (s16)lValue;
+		return(TRUE);
+	}
+	LOG2(LOG_ID_MAX31723_READ, uchTemperatureRegister, lValue);
+	pCache->axEntries[nEntry].unMisses++;
+	*pnTemp = (s16)lValue;
+	return(FALSE);
+}
+
+int max31723_cache_set_alarm(struct maximMax31723Cache *pCache, s16 nTemp, u8 uchAlarmType)
+/**
+* \brief       Write an alarm setpoint through the register map, which invalidates it.
+*
+* \param[in]   *pCache          - cache instance
+* \param[in]   nTemp            - set point in 1/16 degC
+* \param[in]   uchAlarmType     - MAX31723_LOW_ALARM_WRITE or MAX31723_HIGH_ALARM_WRITE
+*
+* \retval      FALSE if the register map could not write the setpoint (see regmap_write())
+*/
+{
+	LOG2(LOG_ID_MAX31723_ALARM, uchAlarmType, nTemp);
+	return(regmap_write(&pCache->xRegisters, g_auchCacheRegisters[max31723_cache_entry(uchAlarmType)], nTemp));
+}
+
+void max31723_cache_invalidate(struct maximMax31723Cache *pCache)
+/**
+* \brief       Drop every cached register, e.g. after the part was written without going through the cache.
+*
+* \retval      None
+*/
+{
+	regmap_invalidate(&pCache->xRegisters);
+}
@@ -0,0 +1,78 @@
+/** \file max31723_cache.h ***************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: max31723_cache.h
+ *         Description: Register cache in front of the MAX31723 driver.  The
+ *                      menu, command interface, LEDs and displays read the
+ *                      sensor through one cache, so a value is fetched over
+ *                      SPI at most once per validity period however many
+ *                      consumers ask for it.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX31723_CACHE_H_
+#define MAX31723_CACHE_H_
+
+#include "xbasic_types.h"
+#include "max31723_utilities.h"
+#include "register_map.h"
+
+#define MAX31723_CACHE_TEMP 0           //!< Entry for MAX31723_TEMP_READ
+#define MAX31723_CACHE_LOW_ALARM 1      //!< Entry for MAX31723_LOW_ALARM_READ
+#define MAX31723_CACHE_HIGH_ALARM 2     //!< Entry for MAX31723_HIGH_ALARM_READ
+#define MAX31723_CACHE_ENTRIES 3
+
+#define MAX31723_CACHE_NOT_READY -1     //!< max31723_cache_read_raw():  no conversion at the new configuration yet
+
+/*
+ * Validity
+ *
+ *   temperature     one conversion time of the configured resolution (a new result cannot exist sooner);
+ *                   after max31723_cache_configure() none until the first conversion has completed, and
+ *                   reads return MAX31723_CACHE_NOT_READY with the last temperature instead of waiting
+ *   Tlow, Thigh     until written through max31723_cache_set_alarm() or invalidated
+ *
+ * The values live in a register_map.c map of g_xMax31723Device, so the REG command and the typed
+ * readers below share one cache:  a register read by either is a hit for the other, and a write
+ * through either invalidates it for both.  Writes go to the part, so the next read returns what the
+ * part stored.  Code that writes the part directly (headless acquisition, the CPU1 sampler) must call
+ * max31723_cache_invalidate() afterwards.  Timestamps come from get_time_us(), so a validity period
+ * must stay below the 71 minute wrap of that counter.
+ */
+
+struct maximMax31723CacheEntry          //!< Statistics of one typed reader
+{
+	u32 unHits;
+	u32 unMisses;                       //!< reads that went to the part
+};
+
+struct maximMax31723Cache
+{
+	u32 unPeripheralAddressSPI;
+	u8 uchConfiguration;                //!< configuration byte last written
+	struct maximRegisterMap xRegisters; //!< MAX31723 on slave 0;  holds every cached value
+	struct maximMax31723CacheEntry axEntries[MAX31723_CACHE_ENTRIES];
+};
+
+void max31723_cache_init(struct maximMax31723Cache *pCache, u32 unPeripheralAddressSPI, u8 uchConfiguration);
+int max31723_cache_configure(struct maximMax31723Cache *pCache, u8 uchConfiguration);
+int max31723_cache_read_raw(struct maximMax31723Cache *pCache, s16 *pnTemp, u8 uchTemperatureRegister);
+int max31723_cache_set_alarm(struct maximMax31723Cache *pCache, s16 nTemp, u8 uchAlarmType);
+void max31723_cache_invalidate(struct maximMax31723Cache *pCache);
+
+#endif /* MAX31723_CACHE_H_ */
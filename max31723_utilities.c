@@ -66,52 +66,73 @@
 #include "max31723.h"
 #include "delays.h"
 #include "spi_utilities.h"
+#include "log_utilities.h"
+#include "memory_sections.h"
+#include "profile_utilities.h"
+#include "spi_fixed.h"
+#include "fixed_point_utilities.h"
 //#include "math.h"
 
+// Transfers to the MAX31723:  slave 0, CPHA=1, CPOL=0, active high CE (see spi_fixed.h).  The other
+// select lines stay at the idle levels declared with spi_set_slave_polarity(), so sensor_array.h
+// parts on the same controller are not selected with it
+SPI_FIXED_DEVICE(max31723_spi, 0, 1, 0, TRUE)
+
+// Frame lengths in whole words.  The extra bytes of a read are the next registers;  those of a
+// configuration write land on the read-only temperature registers, which ignore them.
+#define MAX31723_FIXED_FRAME(nNumBytes) SPI_ALIGN_BYTES(nNumBytes, SPI_FIXED_WORD_BYTES)
+
 
 
 
 int max_MAX31723_set_alarm(float fTemp, u32 unPeripheralAddressSPI, u8 uchAlarmType)
 /**
+* \brief       Set one of the MAX31723 temperature alarms from a float.  See max_MAX31723_set_alarm_raw().
+*
+* \param[in]   fTemp                    - set point temperature in degrees C, rounded to 1/16 degC
+*
+* \retval      Always True
+*/
+{
+	return(max_MAX31723_set_alarm_raw(q4_from_float(fTemp), unPeripheralAddressSPI, uchAlarmType));
+}
+
+int max_MAX31723_set_alarm_raw(s16 nTemp, u32 unPeripheralAddressSPI, u8 uchAlarmType)
+/**
 * \brief       Set one of the MAX31723 temperature alarms.  
 * \par         Details
 *              This function sets either the high or low temperature alarms in the MAX31723.  The
-*              units for these settings are degrees centigrade.
+*              setpoint is written at the full 1/16 degC resolution of the alarm registers, so it
+*              reads back unchanged.
+* \n           On a core wider than 8 bits the 3 byte write would be padded into the register
+*              after the alarm, so the frame starts one register early instead and ends on the
+*              alarm MSB:  ahead of THIGH that is the read-only temperature MSB, ahead of TLOW it
+*              is the THIGH MSB, which is read first and written back unchanged.
 *
-* \param[in]   fTemp                    - set point temperature in degrees C
+* \param[in]   nTemp                    - set point temperature in 1/16 degC (Q12.4)
 * \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral in Microblaze memory map
-* \param[in]   uchAlarmType             - True = PSAVE mode on, False = PSAVE mode off
+* \param[in]   uchAlarmType             - MAX31723_LOW_ALARM_WRITE or MAX31723_HIGH_ALARM_WRITE
 *
 * \retval      Always True
 */
 {
-	u8 auchOutputBuffer[3];
-	u8 auchReadBuffer[3];
-	int nTemp=0;
-	float fTempValue=0.0f;
+	static const u8 auchHighMsbRead[4] = { MAX31723_HIGH_ALARM_READ + 1, 0x00, 0x00, 0x00 };
+	u8 auchOutputBuffer[4];
+	u8 auchReadBuffer[4];
+	int nRegisterByte=0;
 	int nReturnVal=TRUE;
 	int nValueToWrite=0;
 
 	auchOutputBuffer[0]=0;
 	auchOutputBuffer[1]=0;
 	auchOutputBuffer[2]=0;
-	auchReadBuffer[0]=0;
-	auchReadBuffer[1]=0;
-	auchReadBuffer[2]=0;
 
 	// The upper and lower boundaries for the part are -55.0 to 125.0 degC
-	fTempValue = fTemp;
-	if(fTempValue >= 125.0f)
-		fTempValue = 125.0f;
-	else if(fTempValue <= -55.0f)
-		fTempValue = -55.0f;
+	nValueToWrite = q4_clamp(nTemp, MAX31723_TEMP_MIN_Q4, MAX31723_TEMP_MAX_Q4);
 
 	// The 31723 temperature readings are signed 12 bits long, and each bit represents 1/16th of a degree C
 	// bits[11:4] fill the MSB byte
 	// bits[3:0] fill the LSB byte upper nibble
-	//fTempValue = fTempValue  * 16.0f;
-	nValueToWrite = (int)fTempValue;
-	nValueToWrite = nValueToWrite << 4;
 
 	// #define MAX31723_LOW_ALARM_WRITE 0x85
 	// #define MAX31723_HIGH_ALARM_WRITE 0x83
@@ -121,54 +142,83 @@ int max_MAX31723_set_alarm(float fTemp, u32 unPeripheralAddressSPI, u8 uchAlarmT
 	else
 		auchOutputBuffer[0] = MAX31723_HIGH_ALARM_WRITE;
 
-	nTemp = (nValueToWrite & 0xFF0);
-	nTemp = nTemp >> 4;
-	auchOutputBuffer[2] = (u8)nTemp;  // MSB byte is 2nd
+	nRegisterByte = (nValueToWrite & 0xFF0);
+	nRegisterByte = nRegisterByte >> 4;
+	auchOutputBuffer[2] = (u8)nRegisterByte;  // MSB byte is 2nd
 
-	nTemp = (nValueToWrite & 0x000F);			//  mask off the LSB bits
-	nTemp = nTemp << 4;  						//  We only have 4 bits remaining of our 12 bit word,
+	nRegisterByte = (nValueToWrite & 0x000F);			//  mask off the LSB bits
+	nRegisterByte = nRegisterByte << 4;  						//  We only have 4 bits remaining of our 12 bit word,
 												//  the lower nibble needs to be shifted to the upper nibble
-	auchOutputBuffer[1] = (u8)nTemp;
+	auchOutputBuffer[1] = (u8)nRegisterByte;
+	LOG2(LOG_ID_MAX31723_ALARM, auchOutputBuffer[0], nValueToWrite);
 
-	SpiRW(unPeripheralAddressSPI,1,0,(u8*)&auchOutputBuffer,(u8*)&auchReadBuffer,3,1);  // send
+	if(SPI_FIXED_WORD_BYTES == 1)
+	{
+		max31723_spi_write(unPeripheralAddressSPI,auchOutputBuffer,3);  // send
+		return(nReturnVal);
+	}
+
+	auchOutputBuffer[3] = auchOutputBuffer[2];
+	auchOutputBuffer[2] = auchOutputBuffer[1];
+	auchOutputBuffer[1] = 0x00;     // read-only temperature MSB ahead of THIGH
+	if(uchAlarmType==MAX31723_LOW_ALARM_WRITE)
+	{
+		max31723_spi_rw(unPeripheralAddressSPI,auchHighMsbRead,auchReadBuffer,4);
+		auchOutputBuffer[1] = auchReadBuffer[1];    // THIGH MSB, unchanged
+	}
+	auchOutputBuffer[0] = (u8)(auchOutputBuffer[0] - 1);
+	max31723_spi_write(unPeripheralAddressSPI,auchOutputBuffer,4);  // send
 
 	return(nReturnVal);
 }
 
-int max_MAX31723_get_temp(float *fTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister)
+int max_MAX31723_configure(u32 unPeripheralAddressSPI, u8 uchConfiguration)
 /**
-* \brief       Retrieve one of the the 12-bit temperature registers from the MAX31723 as a floating point (deg C)  
+* \brief       Write the MAX31723 configuration/status register.
 * \par         Details
-*              This function reads any of the three temperature registers in the MAX31723.  These registers are
-*              the Temperature, Thigh Alarm and Tlow Alarm.  the register to be read is specified buy the input
-*              parameter uchTemperatureRegister which should be set to one of the three constants:
-* \n           MAX31723_LOW_ALARM_READ, MAX31723_HIGH_ALARM_READ or MAX31723_TEMP_READ
+*              Conversions run in the background once the part is configured for continuous mode,
+*              so this only needs to be called once (or when the resolution/mode changes).
+*              The first result at the new resolution is available one conversion time later.
 *
-* \param[out]  *fTemp                   - temperature reading is stored at fTemp
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral in Microblaze memory map
+* \param[in]   uchConfiguration         - configuration byte, e.g. MAX31723_CONFIG_12BIT_CONTINUOUS
+*
+* \retval      Always True
+*/
+{
+	u8 auchOutputBuffer[4] = { 0 };
+
+	auchOutputBuffer[0] = MAX31723_CONFIG_WRITE; // Configuration/status register
+	auchOutputBuffer[1] = uchConfiguration;
+	LOG1(LOG_ID_MAX31723_CONFIG, uchConfiguration);
+	max31723_spi_write(unPeripheralAddressSPI,auchOutputBuffer,MAX31723_FIXED_FRAME(2));  // send
+
+	return(TRUE);
+}
+
+__fast_text int max_MAX31723_read_raw(s16 *pnTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister)
+/**
+* \brief       Read one of the 12-bit temperature registers from an already configured MAX31723.
+* \par         Details
+*              The register value is returned as a sign extended count of 1/16 degC, with no
+*              floating point conversion.  The value is the last completed conversion.
+*
+* \param[out]  *pnTemp                  - temperature in 1/16 degC is stored at pnTemp
 * \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral in Microblaze memory map
 * \param[in]   uchTemperatureRegister   - The register to be read
 *
 * \retval      Always True
 */
 {
-	u8 auchOutputBuffer[3];
-	u8 auchReadBuffer[3];
+	u8 auchOutputBuffer[4];
+	u8 auchReadBuffer[4];
 	int nTemp=0;
-	float fTempValue=0.0f;
 	int nReturnVal=TRUE;
 
 	auchReadBuffer[0]=0;
 	auchReadBuffer[1]=0;
 	auchReadBuffer[2]=0;
 
-	// Setup the 31723 to continuously make temp readings
-	auchOutputBuffer[0] = 0x80; // Configuration/status register
-	auchOutputBuffer[1] = 0x06; // Default settings, except use 12 bit resolution (instead of 9) and continuously make temp conversions
-	SpiRW(unPeripheralAddressSPI,1,0,(u8*)&auchOutputBuffer,(u8*)&auchReadBuffer,2,1);  // send
-
-	// wait a half a second so that the (now 12-bit) temp sensor readings propagate to the SPI interface
-	delay(ABOUT_ONE_SECOND/2);
-
 	// Read the LSB and MSB temperature registers
 	if(uchTemperatureRegister == MAX31723_LOW_ALARM_READ)
 		auchOutputBuffer[0] = MAX31723_LOW_ALARM_READ; 	// 0x05 = (low) alarm register
@@ -179,19 +229,176 @@ int max_MAX31723_get_temp(float *fTemp, u32 unPeripheralAddressSPI, u8 uchTemper
 
 	auchOutputBuffer[1] = 0x00; // Since this is a read register address, these extra bytes are are ignored by the 31723
 	auchOutputBuffer[2] = 0x00; // Since this is a read register address, these extra bytes are are ignored by the 31723
-	SpiRW(unPeripheralAddressSPI,1,0,(u8*)&auchOutputBuffer,(u8*)&auchReadBuffer,3,1);  // send
-
-	// convert to approximate floating point
-	nTemp = 0;
-	nTemp = (int)auchReadBuffer[2];
-	nTemp = nTemp << 4;
-	nTemp |= (int)((auchReadBuffer[1] & 0xF0)>>4);
-	if((nTemp & 0x00000800)==0x00000800) // is the 12bit bit set?  If so, set the other bits for the 2s complement negative value
-		nTemp |= 0xFFFFF000;
-
-	fTempValue = (float)nTemp;
-	fTempValue = fTempValue / 16.0f;
-	*fTemp = fTempValue;
+	auchOutputBuffer[3] = 0x00;
+	max31723_spi_rw(unPeripheralAddressSPI,auchOutputBuffer,auchReadBuffer,MAX31723_FIXED_FRAME(3));  // send
+
+	// assemble the 12 bit two's complement value
+	nTemp = max_MAX31723_decode_raw(auchReadBuffer);
+	LOG2(LOG_ID_MAX31723_READ, auchOutputBuffer[0], nTemp);
+
+	*pnTemp = (s16)nTemp;
+	return(nReturnVal);
+}
+
+int max_MAX31723_configure_slave(u32 unPeripheralAddressSPI, int nSlave, u8 uchConfiguration)
+/**
+* \brief       max_MAX31723_configure() for a MAX31723 on any slave select line.
+* \par         Details
+*              Goes through SpiRWSlave(), so the other select lines of the controller stay at the
+*              idle level declared with spi_set_slave_polarity().
+*
+* \param[in]   unPeripheralAddressSPI   - address of the SPI controller
+* \param[in]   nSlave                   - slave select line of the part
+* \param[in]   uchConfiguration         - configuration byte, e.g. MAX31723_CONFIG_12BIT_CONTINUOUS
+*
+* \retval      Always True
+*/
+{
+	u8 auchOutputBuffer[4] = { 0 };
+	u8 auchReadBuffer[4];
+
+	auchOutputBuffer[0] = MAX31723_CONFIG_WRITE;
+	auchOutputBuffer[1] = uchConfiguration;
+	LOG1(LOG_ID_MAX31723_CONFIG, uchConfiguration);
+	SpiRWSlave(unPeripheralAddressSPI, nSlave, 1, 0, auchOutputBuffer, auchReadBuffer,
+			SPI_ALIGN_BYTES(2, spi_word_bytes(unPeripheralAddressSPI)), TRUE);
+
+	return(TRUE);
+}
+
+int max_MAX31723_read_raw_slave(s16 *pnTemp, u32 unPeripheralAddressSPI, int nSlave, u8 uchTemperatureRegister)
+/**
+* \brief       max_MAX31723_read_raw() for a MAX31723 on any slave select line.
+*
+* \param[out]  *pnTemp                  - temperature in 1/16 degC is stored at pnTemp
+* \param[in]   unPeripheralAddressSPI   - address of the SPI controller
+* \param[in]   nSlave                   - slave select line of the part
+* \param[in]   uchTemperatureRegister   - MAX31723_TEMP_READ, MAX31723_LOW_ALARM_READ or MAX31723_HIGH_ALARM_READ
+*
+* \retval      Always True
+*/
+{
+	u8 auchOutputBuffer[4] = { 0 };
+	u8 auchReadBuffer[4];
+
+	auchOutputBuffer[0] = uchTemperatureRegister;
+	SpiRWSlave(unPeripheralAddressSPI, nSlave, 1, 0, auchOutputBuffer, auchReadBuffer,
+			SPI_ALIGN_BYTES(3, spi_word_bytes(unPeripheralAddressSPI)), TRUE);
+
+	*pnTemp = max_MAX31723_decode_raw(auchReadBuffer);
+	LOG2(LOG_ID_MAX31723_READ, auchOutputBuffer[0], *pnTemp);
+	return(TRUE);
+}
+
+int max_MAX31723_read_temp(float *fTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister)
+/**
+* \brief       Read one of the 12-bit temperature registers from an already configured MAX31723.
+* \par         Details
+*              Same as max_MAX31723_get_temp(), but without rewriting the configuration register and
+*              waiting for a new conversion.  The value returned is the last completed conversion.
+*
+* \param[out]  *fTemp                   - temperature reading is stored at fTemp
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral in Microblaze memory map
+* \param[in]   uchTemperatureRegister   - The register to be read
+*
+* \retval      Always True
+*/
+{
+	s16 nTemp=0;
+	int nReturnVal;
+
+	nReturnVal = max_MAX31723_read_raw(&nTemp, unPeripheralAddressSPI, uchTemperatureRegister);
+
+	*fTemp = q4_to_float(nTemp);
+	return(nReturnVal);
+}
+
+u32 max_MAX31723_conversion_time_ms(u8 uchConfiguration)
+/**
+* \brief       Maximum conversion time for the resolution selected in a configuration byte.
+* \par         Details
+*              In continuous mode a new result is available once per conversion time, so sampling
+*              faster than this only returns repeated values.
+*
+* \param[in]   uchConfiguration         - configuration byte (R1:R0 in bits 2:1)
+*
+* \retval      Conversion time in milliseconds (25, 50, 100 or 200)
+*/
+{
+	return(MAX31723_CONVERSION_MS_9BIT << ((uchConfiguration & MAX31723_CONFIG_RESOLUTION_MASK) >> 1));
+}
+
+static u32 max_MAX31723_conversion_time_us(u32 unConfiguration)
+{
+	return(max_MAX31723_conversion_time_ms((u8)unConfiguration) * 1000);
+}
+
+// Temperature and setpoints:  LSB holds the fraction in bits 7:4, MSB the integer degrees
+static const struct maximRegisterDesc g_axMax31723Registers[] =
+{
+	{ "CONFIG", MAX31723_CONFIG_READ,     1, REGMAP_READ | REGMAP_WRITE | REGMAP_CONFIG, 0, 8 },
+	{ "TEMP",   MAX31723_TEMP_READ,       2, REGMAP_READ | REGMAP_VOLATILE | REGMAP_SIGNED | REGMAP_LSB_FIRST, 4, 12 },
+	{ "THIGH",  MAX31723_HIGH_ALARM_READ, 2, REGMAP_READ | REGMAP_WRITE | REGMAP_SIGNED | REGMAP_LSB_FIRST, 4, 12 },
+	{ "TLOW",   MAX31723_LOW_ALARM_READ,  2, REGMAP_READ | REGMAP_WRITE | REGMAP_SIGNED | REGMAP_LSB_FIRST, 4, 12 },
+};
+
+const struct maximDeviceDesc g_xMax31723Device =
+{
+	"MAX31723",
+	1, 0, TRUE,                         // CPHA=1, CPOL=0, CE active high
+	TRUE, 0x00, 0x80, TRUE,             // address byte, bit 7 set for writes, auto-increment
+	7,
+	max_MAX31723_conversion_time_us,
+	g_axMax31723Registers, sizeof(g_axMax31723Registers) / sizeof(g_axMax31723Registers[0])
+};
+
+int max_MAX31723_get_temp(float *fTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister)
+/**
+* \brief       Float adapter for max_MAX31723_get_raw().
+*
+* \param[out]  *fTemp                   - temperature reading in degrees C is stored at fTemp
+*
+* \retval      Always True
+*/
+{
+	s16 nTemp=0;
+	int nReturnVal;
+
+	nReturnVal = max_MAX31723_get_raw(&nTemp, unPeripheralAddressSPI, uchTemperatureRegister);
+	*fTemp = q4_to_float(nTemp);
+	return(nReturnVal);
+}
+
+int max_MAX31723_get_raw(s16 *pnTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister)
+/**
+* \brief       Retrieve one of the the 12-bit temperature registers from the MAX31723 in 1/16 deg C
+* \par         Details
+*              This function reads any of the three temperature registers in the MAX31723.  These registers are
+*              the Temperature, Thigh Alarm and Tlow Alarm.  the register to be read is specified buy the input
+*              parameter uchTemperatureRegister which should be set to one of the three constants:
+* \n           MAX31723_LOW_ALARM_READ, MAX31723_HIGH_ALARM_READ or MAX31723_TEMP_READ
+* \n           The part is reconfigured and a full conversion is waited out on every call.  Use
+*              max_MAX31723_configure() once and then max_MAX31723_read_raw() when that delay is not wanted.
+*
+* \param[out]  *pnTemp                  - temperature reading in 1/16 degC (Q12.4) is stored at pnTemp
+* \param[in]   unPeripheralAddressSPI   - address of the SPI peripheral in Microblaze memory map
+* \param[in]   uchTemperatureRegister   - The register to be read
+*
+* \retval      Always True
+*/
+{
+	int nReturnVal;
+	PROF_BEGIN(PROF_MAX31723_GET_TEMP);
+
+	// Setup the 31723 to continuously make temp readings
+	// Default settings, except use 12 bit resolution (instead of 9) and continuously make temp conversions
+	max_MAX31723_configure(unPeripheralAddressSPI, MAX31723_CONFIG_12BIT_CONTINUOUS);
+
+	// wait a half a second so that the (now 12-bit) temp sensor readings propagate to the SPI interface
+	delay(ABOUT_ONE_SECOND/2);
+
+	nReturnVal = max_MAX31723_read_raw(pnTemp, unPeripheralAddressSPI, uchTemperatureRegister);
+	PROF_END(PROF_MAX31723_GET_TEMP);
 	return(nReturnVal);
 }
 
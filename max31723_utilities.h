@@ -67,6 +67,7 @@
 #include "xbasic_types.h"
 #include "xspi_l.h"
 #include "stdio.h"
+#include "register_map.h"
 //#include "maximPMOD.h"
 
 #define MAX31723_TEMP_READ 0x01         //!< Read address for Temperature LSB register (MSB=0x02)
@@ -74,9 +75,58 @@
 #define MAX31723_HIGH_ALARM_READ 0x03   //!< Read address for High Temperature Alarm LSB register (MSB=0x04)
 #define MAX31723_LOW_ALARM_WRITE 0x85   //!< Write address for Low Temperature Alarm LSB register (MSB=0x86)
 #define MAX31723_HIGH_ALARM_WRITE 0x83  //!< Write address for High Temperature Alarm LSB register (MSB=0x84)
+#define MAX31723_CONFIG_READ 0x00       //!< Read address for Configuration/Status register
+#define MAX31723_CONFIG_WRITE 0x80      //!< Write address for Configuration/Status register
+
+#define MAX31723_CONFIG_12BIT_CONTINUOUS 0x06   //!< Configuration: 12 bit resolution, continuous conversions
+#define MAX31723_CONFIG_RESOLUTION_MASK 0x06    //!< Configuration bits R1:R0
+#define MAX31723_CONFIG_RESOLUTION_9BIT 0x00    //!< R1:R0 for  9 bit (0.5 degC) conversions
+#define MAX31723_CONFIG_RESOLUTION_10BIT 0x02   //!< R1:R0 for 10 bit (0.25 degC) conversions
+#define MAX31723_CONFIG_RESOLUTION_11BIT 0x04   //!< R1:R0 for 11 bit (0.125 degC) conversions
+#define MAX31723_CONFIG_RESOLUTION_12BIT 0x06   //!< R1:R0 for 12 bit (0.0625 degC) conversions
+#define MAX31723_CONFIG_SHUTDOWN 0x01           //!< SD:  stop conversions
+#define MAX31723_CONFIG_TM_INTERRUPT 0x08       //!< TM:  TOUT in interrupt mode (0 = comparator mode)
+#define MAX31723_CONFIG_ONE_SHOT 0x10           //!< 1SHOT:  one conversion while shut down
+#define MAX31723_CONVERSION_MS_9BIT 25          //!< Max conversion time at 9 bits, doubles with each extra bit
+#define MAX31723_TEMP_MIN_Q4 (-55 * 16)         //!< Lowest alarm setpoint, -55 degC in 1/16 degC
+#define MAX31723_TEMP_MAX_Q4 (125 * 16)         //!< Highest alarm setpoint, +125 degC in 1/16 degC
+
+#define MAX31723_REG_CONFIG 0                   //!< g_xMax31723Device register indices
+#define MAX31723_REG_TEMP 1
+#define MAX31723_REG_HIGH_ALARM 2
+#define MAX31723_REG_LOW_ALARM 3
+
+extern const struct maximDeviceDesc g_xMax31723Device;  //!< MAX31723 for register_map.c
 
 //extern XGpio g_xGpioPmodPortC;
 
+int max_MAX31723_configure(u32 unPeripheralAddressSPI, u8 uchConfiguration);
+int max_MAX31723_read_raw(s16 *pnTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister);
+u32 max_MAX31723_conversion_time_ms(u8 uchConfiguration);
+int max_MAX31723_get_raw(s16 *pnTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister);
+int max_MAX31723_set_alarm_raw(s16 nTemp, u32 unPeripheralAddressSPI, u8 uchAlarmType);
+
+static inline s16 max_MAX31723_decode_raw(const u8 *auchReadBuffer)
+/**
+* \brief       Sign extended 12-bit value of the LSB/MSB register pair read after the address byte.
+*/
+{
+	int nTemp;
+
+	nTemp = (int)auchReadBuffer[2];
+	nTemp = nTemp << 4;
+	nTemp |= (int)((auchReadBuffer[1] & 0xF0)>>4);
+	if((nTemp & 0x00000800)==0x00000800) // is the 12bit bit set?  If so, set the other bits for the 2s complement negative value
+		nTemp |= 0xFFFFF000;
+	return((s16)nTemp);
+}
+
+// Same transfers for a part on any slave select line (see sensor_array.h)
+int max_MAX31723_configure_slave(u32 unPeripheralAddressSPI, int nSlave, u8 uchConfiguration);
+int max_MAX31723_read_raw_slave(s16 *pnTemp, u32 unPeripheralAddressSPI, int nSlave, u8 uchTemperatureRegister);
+
+// float adapters over the Q12.4 functions above
+int max_MAX31723_read_temp(float *fTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister);
 int max_MAX31723_get_temp(float *fTemp, u32 unPeripheralAddressSPI, u8 uchTemperatureRegister);
 int max_MAX31723_set_alarm(float fTemp, u32 unPeripheralAddressSPI, u8 uchAlarmType);
 
@@ -0,0 +1,141 @@
+/** \file max31855_utilities.c ***********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: max31855_utilities.c
+ *         Description: MAX31855 cold-junction compensated thermocouple to
+ *                      digital converter.  The part has no registers to
+ *                      address:  every select shifts out one 32-bit frame,
+ *                      read here as a register_map.c device in one burst.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "register_map.h"
+#include "max31855_utilities.h"
+
+static u32 max_MAX31855_conversion_time_us(u32 unConfiguration)
+{
+	(void)unConfiguration;
+	return(MAX31855_CONVERSION_US);
+}
+
+static const struct maximRegisterDesc g_axMax31855Registers[] =
+{
+	{ "PROBE",    0, 2, REGMAP_READ | REGMAP_VOLATILE | REGMAP_SIGNED, 2, 14 },
+	{ "FAULT",    1, 1, REGMAP_READ | REGMAP_VOLATILE, 0, 1 },
+	{ "INTERNAL", 2, 2, REGMAP_READ | REGMAP_VOLATILE | REGMAP_SIGNED, 4, 12 },
+	{ "FAULTS",   3, 1, REGMAP_READ | REGMAP_VOLATILE, 0, 3 },
+};
+
+const struct maximDeviceDesc g_xMax31855Device =
+{
+	"MAX31855",
+	0, 0, FALSE,                        // CPHA=0, CPOL=0, CS active low
+	FALSE, 0x00, 0x00, FALSE,           // read only frame, no address
+	4,
+	max_MAX31855_conversion_time_us,
+	g_axMax31855Registers, sizeof(g_axMax31855Registers) / sizeof(g_axMax31855Registers[0])
+};
+
+
+int max_MAX31855_init(struct maximMax31855 *pSensor, u32 unPeripheralAddressSPI, int nSlave)
+/**
+* \brief       Attach to a MAX31855.  The part converts continuously, so there is nothing to configure.
+*
+* \param[out]  *pSensor                 - sensor instance
+* \param[in]   unPeripheralAddressSPI   - SPI controller the part is on
+* \param[in]   nSlave                   - its slave select line
+*
+* \retval      TRUE
+*/
+{
+	memset(pSensor, 0, sizeof(*pSensor));
+	return(regmap_init(&pSensor->xRegisters, &g_xMax31855Device, unPeripheralAddressSPI, nSlave));
+}
+
+int max_MAX31855_read(struct maximMax31855 *pSensor, struct maximMax31855Reading *pReading)
+/**
+* \brief       Read and decode one frame (a single 4-byte transaction).
+* \par         Details
+*              A frame read less than one conversion time after the previous one is served from
+*              the register map and returned again.  With a fault the probe temperature is not
+*              meaningful, but the cold junction temperature still is.
+*
+* \param[in]   *pSensor     - sensor instance
+* \param[out]  *pReading    - decoded frame
+*
+* \retval      TRUE when no fault bit is set
+*/
+{
+	static const u8 auchFrame[] = { MAX31855_REG_PROBE, MAX31855_REG_FAULT, MAX31855_REG_INTERNAL, MAX31855_REG_FAULTS };
+	s32 alValues[4];
+
+	regmap_read(&pSensor->xRegisters, auchFrame, 4, alValues);
+	pReading->nProbe = (s16)(alValues[0] * 4);
+	pReading->nInternal = (s16)alValues[2];
+	pReading->uchFaults = (u8)(alValues[3] & MAX31855_FAULT_MASK);
+	// D16 without a fault bit would be a floating or missing MISO;  report it as open
+	if(alValues[1] && pReading->uchFaults == 0)
+		pReading->uchFaults = MAX31855_FAULT_OC;
+	pReading->unTimestampUs = pSensor->xRegisters.aunReadTimeUs[MAX31855_REG_PROBE];
+
+	pSensor->xLast = *pReading;
+	pSensor->uchValid = TRUE;
+	pSensor->unReadCount++;
+	if(pReading->uchFaults)
+		pSensor->unFaultCount++;
+	return(pReading->uchFaults == 0);
+}
+
+int max_MAX31855_poll(struct maximMax31855 *pSensor, u32 unNowUs)
+/**
+* \brief       Read a new frame into xLast if one conversion time has passed since the last.
+* \par         Details
+*              Costs one time comparison when nothing is due, and one 4-byte transaction at the
+*              ~10 Hz conversion rate otherwise;  it never waits for the part.
+*
+* \param[in]   *pSensor     - sensor instance
+* \param[in]   unNowUs      - get_time_us()
+*
+* \retval      TRUE when xLast was updated
+*/
+{
+	struct maximMax31855Reading xReading;
+
+	if(pSensor->uchValid && unNowUs - pSensor->xLast.unTimestampUs < MAX31855_CONVERSION_US)
+		return(FALSE);
+	max_MAX31855_read(pSensor, &xReading);
+	return(TRUE);
+}
+
+const char *max_MAX31855_fault_name(u8 uchFaults)
+/**
+* \brief       Name of the most significant fault in a reading, for messages.
+*
+* \retval      "OC", "SCG", "SCV" or "NONE"
+*/
+{
+	if(uchFaults & MAX31855_FAULT_OC)
+		return("OC");
+	if(uchFaults & MAX31855_FAULT_SCG)
+		return("SCG");
+	if(uchFaults & MAX31855_FAULT_SCV)
+		return("SCV");
+	return("NONE");
+}
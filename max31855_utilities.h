@@ -0,0 +1,80 @@
+/** \file max31855_utilities.h ***********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: max31855_utilities.h
+ *         Description: MAX31855 cold-junction compensated thermocouple to
+ *                      digital converter.  The part has no registers to
+ *                      address:  every select shifts out one 32-bit frame,
+ *                      read here as a register_map.c device in one burst.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX31855_UTILITIES_H_
+#define MAX31855_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "register_map.h"
+
+#define MAX31855_FAULT_OC 0x01          //!< thermocouple open
+#define MAX31855_FAULT_SCG 0x02         //!< thermocouple shorted to GND
+#define MAX31855_FAULT_SCV 0x04         //!< thermocouple shorted to VCC
+#define MAX31855_FAULT_MASK 0x07
+#define MAX31855_CONVERSION_US 100000   //!< Max conversion time;  the frame holds a new result about every 100 ms
+
+#define MAX31855_REG_PROBE 0            //!< g_xMax31855Device register indices
+#define MAX31855_REG_FAULT 1
+#define MAX31855_REG_INTERNAL 2
+#define MAX31855_REG_FAULTS 3
+
+/*
+ * Frame, MSB first:  D31:18 probe temperature (14 bit, 0.25 degC), D16 any fault, D15:4 cold
+ * junction temperature (12 bit, 0.0625 degC), D2 SCV, D1 SCG, D0 OC.  Both temperatures are
+ * returned in 1/16 degC (Q12.4) like the MAX31723 readings;  the probe range, -2048 to +2047.75
+ * degC, fills an s16 exactly.
+ *
+ * max_MAX31855_poll() reads at most one frame per conversion time and never waits, so it can
+ * run from any loop that also services the MAX31723.  The part uses CPOL=0, CPHA=0 and an
+ * active low select;  on the AXI Quad SPI it shares the bus with the active high MAX31723 CE
+ * (see spi_set_slave_polarity()).
+ */
+
+struct maximMax31855Reading             //!< One decoded frame
+{
+	s16 nProbe;                         //!< thermocouple temperature, 1/16 degC
+	s16 nInternal;                      //!< cold junction temperature, 1/16 degC
+	u8 uchFaults;                       //!< MAX31855_FAULT_..., 0 when the probe reading is valid
+	u32 unTimestampUs;                  //!< get_time_us() of the read
+};
+
+struct maximMax31855                    //!< One MAX31855 and its latest reading
+{
+	struct maximRegisterMap xRegisters;
+	struct maximMax31855Reading xLast;
+	u32 unReadCount;
+	u32 unFaultCount;                   //!< frames with a fault bit set
+	u8 uchValid;                        //!< xLast holds a reading
+};
+
+extern const struct maximDeviceDesc g_xMax31855Device;  //!< MAX31855 for register_map.c
+
+int max_MAX31855_init(struct maximMax31855 *pSensor, u32 unPeripheralAddressSPI, int nSlave);
+int max_MAX31855_read(struct maximMax31855 *pSensor, struct maximMax31855Reading *pReading);
+int max_MAX31855_poll(struct maximMax31855 *pSensor, u32 unNowUs);
+const char *max_MAX31855_fault_name(u8 uchFaults);
+
+#endif /* MAX31855_UTILITIES_H_ */
@@ -0,0 +1,56 @@
+/** \file memory_sections.c **************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: memory_sections.c
+ *         Description: Startup copy of the OCM code and data sections
+ *                      (see memory_sections.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xil_cache.h"
+#include "memory_sections.h"
+
+#if OCM_FAST_SECTIONS
+// Defined in lscript.ld
+extern char __ocm_text_start[], __ocm_text_end[], __ocm_text_load[];
+extern char __ocm_data_start[], __ocm_data_end[], __ocm_data_load[];
+extern char __ocm_bss_start[], __ocm_bss_end[];
+#endif
+
+
+void ocm_sections_init(void)
+/**
+* \brief       Copy .ocm_text and .ocm_data from their DDR load addresses to OCM and clear .ocm_bss.
+* \par         Details
+*              The copied code goes through the data cache, so the data cache is flushed and the
+*              instruction cache invalidated before any __fast_text function is called.  This
+*              function itself stays in DDR.
+*
+* \retval      None
+*/
+{
+#if OCM_FAST_SECTIONS
+	memcpy(__ocm_text_start, __ocm_text_load, __ocm_text_end - __ocm_text_start);
+	memcpy(__ocm_data_start, __ocm_data_load, __ocm_data_end - __ocm_data_start);
+	memset(__ocm_bss_start, 0, __ocm_bss_end - __ocm_bss_start);
+
+	Xil_DCacheFlush();
+	Xil_ICacheInvalidate();
+#endif
+}
@@ -0,0 +1,55 @@
+/** \file memory_sections.h **************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: memory_sections.h
+ *         Description: Placement of latency critical code and data in the
+ *                      on-chip memory (ps7_ram_0) instead of DDR.
+ *
+ *                      __fast_text   function, runs from OCM
+ *                      __fast_data   initialized variable, lives in OCM
+ *                      __fast_bss    zero initialized variable, lives in OCM
+ *
+ *                      The sections are linked to OCM with load addresses in
+ *                      DDR (see .ocm_text, .ocm_data and .ocm_bss in
+ *                      lscript.ld); ocm_sections_init() copies them over and
+ *                      must be the first thing main() does.  Building with
+ *                      OCM_FAST_SECTIONS=0 leaves everything in DDR, which is
+ *                      the "before" case for the LATENCY command.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef MEMORY_SECTIONS_H_
+#define MEMORY_SECTIONS_H_
+
+#ifndef OCM_FAST_SECTIONS
+#define OCM_FAST_SECTIONS 1             //!< 0 keeps __fast_ code and data in DDR
+#endif
+
+#if OCM_FAST_SECTIONS
+#define __fast_text __attribute__((section(".ocm_text"), noinline))
+#define __fast_data __attribute__((section(".ocm_data")))
+#define __fast_bss __attribute__((section(".ocm_bss")))
+#else
+#define __fast_text
+#define __fast_data
+#define __fast_bss
+#endif
+
+void ocm_sections_init(void);
+
+#endif /* MEMORY_SECTIONS_H_ */
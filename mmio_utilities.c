@@ -0,0 +1,289 @@
+/** \file mmio_utilities.c ***************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: mmio_utilities.c
+ *         Description: Optional MMIO access counting and tracing (see
+ *                      mmio_utilities.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+// The real XGpio_DiscreteWrite() is called from here, so the header must not redirect it
+#define MMIO_UTILITIES_IMPLEMENTATION
+
+#include <stdio.h>
+#include <string.h>
+#include "xbasic_types.h"
+#include "xil_io.h"
+#include "xgpio.h"
+#include "xgpio_l.h"
+#include "delays.h"
+#include "mmio_utilities.h"
+
+#if MMIO_TRACE_ENABLED
+
+struct maximMmioState g_xMmio;
+
+
+static struct maximMmioSite *mmio_find_site(const char *sFile, int nLine)
+/**
+* \brief       Look up or register the site for a source line.
+*
+* \retval      Site, or NULL when the table is full
+*/
+{
+	struct maximMmioSite *pSite;
+	int i;
+
+	for(i=0;i<g_xMmio.nSites;i++)
+	{
+		pSite = &g_xMmio.axSites[i];
+		if(pSite->unLine == (u32)nLine && strcmp(pSite->sFile, sFile) == 0)
+			return(pSite);
+	}
+	if(g_xMmio.nSites == MMIO_MAX_SITES)
+		return(NULL);
+	pSite = &g_xMmio.axSites[g_xMmio.nSites];
+	pSite->sFile = sFile;
+	pSite->unLine = (u32)nLine;
+	pSite->unReads = 0;
+	pSite->unWrites = 0;
+	g_xMmio.nSites++;
+	return(pSite);
+}
+
+static struct maximMmioRegion *mmio_find_region(u32 unAddress)
+{
+	struct maximMmioRegion *pRegion;
+	u32 unBaseAddress = unAddress & ~0xFFFUL;
+	int i;
+
+	for(i=0;i<g_xMmio.nRegions;i++)
+	{
+		if(g_xMmio.axRegions[i].unBaseAddress == unBaseAddress)
+			return(&g_xMmio.axRegions[i]);
+	}
+	if(g_xMmio.nRegions == MMIO_MAX_REGIONS)
+		return(NULL);
+	pRegion = &g_xMmio.axRegions[g_xMmio.nRegions];
+	memset(pRegion, 0, sizeof(*pRegion));
+	pRegion->unBaseAddress = unBaseAddress;
+	g_xMmio.nRegions++;
+	return(pRegion);
+}
+
+static void mmio_count(struct maximMmioSite **ppSite, const char *sFile, int nLine, u32 unAddress,
+		u32 unValue, int nWrite)
+/**
+* \brief       Count one access and append it to the trace if armed.
+*
+* \param[in,out] **ppSite   - the caller's cached site, filled in on its first access
+* \param[in]   *sFile       - __FILE__ of the access
+* \param[in]   nLine        - __LINE__ of the access
+* \param[in]   unAddress    - register address
+* \param[in]   unValue      - value read or written
+* \param[in]   nWrite       - TRUE for a write
+*
+* \retval      None
+*/
+{
+	struct maximMmioSite *pSite;
+	struct maximMmioRegion *pRegion;
+	struct maximMmioEvent *pEvent;
+	u32 unOffset = (unAddress & 0xFFF) / 4;
+
+	if(*ppSite == NULL)
+		*ppSite = mmio_find_site(sFile, nLine);
+	pSite = *ppSite;
+	pRegion = mmio_find_region(unAddress);
+
+	if(nWrite)
+	{
+		g_xMmio.ullWrites++;
+		if(pSite != NULL)
+			pSite->unWrites++;
+		if(pRegion != NULL && unOffset < MMIO_REGION_OFFSETS)
+			pRegion->aunWrites[unOffset]++;
+		else if(pRegion != NULL)
+			pRegion->unOtherWrites++;
+	}
+	else
+	{
+		g_xMmio.ullReads++;
+		if(pSite != NULL)
+			pSite->unReads++;
+		if(pRegion != NULL && unOffset < MMIO_REGION_OFFSETS)
+			pRegion->aunReads[unOffset]++;
+		else if(pRegion != NULL)
+			pRegion->unOtherReads++;
+	}
+	if(pSite == NULL)
+		g_xMmio.unSitesLost++;
+	if(pRegion == NULL)
+		g_xMmio.unRegionsLost++;
+
+	if(!g_xMmio.nTraceArmed)
+		return;
+	if(g_xMmio.unTraceCount == MMIO_TRACE_DEPTH)
+	{
+		g_xMmio.unTraceLost++;
+		return;
+	}
+	pEvent = &g_xMmio.axTrace[g_xMmio.unTraceCount++];
+	pEvent->unTimestamp = (u32)get_time_ticks();
+	pEvent->unAddress = unAddress;
+	pEvent->unValue = unValue;
+	pEvent->uchSite = (pSite != NULL) ? (u8)(pSite - g_xMmio.axSites) : MMIO_MAX_SITES;
+	pEvent->uchWrite = (u8)nWrite;
+}
+
+u32 mmio_in32(struct maximMmioSite **ppSite, const char *sFile, int nLine, u32 unAddress)
+/**
+* \brief       Counted Xil_In32().  Called through MMIO_IN32().
+*/
+{
+	u32 unValue = Xil_In32(unAddress);
+
+	mmio_count(ppSite, sFile, nLine, unAddress, unValue, FALSE);
+	return(unValue);
+}
+
+void mmio_out32(struct maximMmioSite **ppSite, const char *sFile, int nLine, u32 unAddress, u32 unValue)
+/**
+* \brief       Counted Xil_Out32().  Called through MMIO_OUT32().
+*/
+{
+	Xil_Out32(unAddress, unValue);
+	mmio_count(ppSite, sFile, nLine, unAddress, unValue, TRUE);
+}
+
+void mmio_gpio_write(struct maximMmioSite **ppSite, const char *sFile, int nLine, XGpio *pGpio,
+		unsigned unChannel, u32 unData)
+/**
+* \brief       Counted XGpio_DiscreteWrite().  The driver makes one write to the channel's data
+*              register, which is what is counted.
+*/
+{
+	XGpio_DiscreteWrite(pGpio, unChannel, unData);
+	mmio_count(ppSite, sFile, nLine, (u32)pGpio->BaseAddress + (unChannel - 1) * XGPIO_CHAN_OFFSET + XGPIO_DATA_OFFSET,
+			unData, TRUE);
+}
+
+void mmio_reset(void)
+/**
+* \brief       Clear all counters and the trace, and disarm the trace.
+* \par         Details
+*              Registered sites are kept (their callers cache the pointers); only their counts
+*              are cleared.
+*
+* \retval      None
+*/
+{
+	int i;
+
+	g_xMmio.ullReads = 0;
+	g_xMmio.ullWrites = 0;
+	g_xMmio.unSitesLost = 0;
+	g_xMmio.unRegionsLost = 0;
+	for(i=0;i<g_xMmio.nSites;i++)
+	{
+		g_xMmio.axSites[i].unReads = 0;
+		g_xMmio.axSites[i].unWrites = 0;
+	}
+	g_xMmio.nRegions = 0;
+	g_xMmio.nTraceArmed = FALSE;
+	g_xMmio.unTraceCount = 0;
+	g_xMmio.unTraceLost = 0;
+}
+
+void mmio_trace_start(void)
+/**
+* \brief       Empty the trace and record the next MMIO_TRACE_DEPTH accesses.
+*
+* \retval      None
+*/
+{
+	g_xMmio.nTraceArmed = FALSE;
+	g_xMmio.unTraceCount = 0;
+	g_xMmio.unTraceLost = 0;
+	g_xMmio.nTraceArmed = TRUE;
+}
+
+void mmio_report(void)
+/**
+* \brief       Print the per-offset, per-site and total counters in the format described in
+*              mmio_utilities.h.
+*
+* \retval      None
+*/
+{
+	const struct maximMmioRegion *pRegion;
+	const struct maximMmioSite *pSite;
+	int i, j;
+
+	for(i=0;i<g_xMmio.nRegions;i++)
+	{
+		pRegion = &g_xMmio.axRegions[i];
+		for(j=0;j<MMIO_REGION_OFFSETS;j++)
+		{
+			if(pRegion->aunReads[j] == 0 && pRegion->aunWrites[j] == 0)
+				continue;
+			printf("MMIO REGION 0x%08lx OFF 0x%02x RD=%lu WR=%lu\r\n", (unsigned long)pRegion->unBaseAddress,
+					j * 4, (unsigned long)pRegion->aunReads[j], (unsigned long)pRegion->aunWrites[j]);
+		}
+		if(pRegion->unOtherReads != 0 || pRegion->unOtherWrites != 0)
+			printf("MMIO REGION 0x%08lx OFF OTHER RD=%lu WR=%lu\r\n", (unsigned long)pRegion->unBaseAddress,
+					(unsigned long)pRegion->unOtherReads, (unsigned long)pRegion->unOtherWrites);
+	}
+	for(i=0;i<g_xMmio.nSites;i++)
+	{
+		pSite = &g_xMmio.axSites[i];
+		if(pSite->unReads != 0 || pSite->unWrites != 0)
+			printf("MMIO SITE %s:%lu RD=%lu WR=%lu\r\n", pSite->sFile, (unsigned long)pSite->unLine,
+					(unsigned long)pSite->unReads, (unsigned long)pSite->unWrites);
+	}
+	printf("MMIO TOTAL RD=%llu WR=%llu SITES_LOST=%lu REGIONS_LOST=%lu\r\n", (unsigned long long)g_xMmio.ullReads,
+			(unsigned long long)g_xMmio.ullWrites, (unsigned long)g_xMmio.unSitesLost,
+			(unsigned long)g_xMmio.unRegionsLost);
+	fflush(stdout);
+}
+
+u32 mmio_trace_dump(void)
+/**
+* \brief       Disarm the trace and print it, oldest access first.
+*
+* \retval      Number of accesses printed
+*/
+{
+	const struct maximMmioEvent *pEvent;
+	const struct maximMmioSite *pSite;
+	u32 i;
+
+	g_xMmio.nTraceArmed = FALSE;
+	for(i=0;i<g_xMmio.unTraceCount;i++)
+	{
+		pEvent = &g_xMmio.axTrace[i];
+		pSite = (pEvent->uchSite < MMIO_MAX_SITES) ? &g_xMmio.axSites[pEvent->uchSite] : NULL;
+		printf("MMIO T %lu %c 0x%08lx 0x%08lx %s:%lu\r\n", (unsigned long)pEvent->unTimestamp,
+				pEvent->uchWrite ? 'W' : 'R', (unsigned long)pEvent->unAddress, (unsigned long)pEvent->unValue,
+				(pSite != NULL) ? pSite->sFile : "?", (pSite != NULL) ? (unsigned long)pSite->unLine : 0UL);
+	}
+	fflush(stdout);
+	return(g_xMmio.unTraceCount);
+}
+
+#endif /* MMIO_TRACE_ENABLED */
@@ -0,0 +1,126 @@
+/** \file mmio_utilities.h ***************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: mmio_utilities.h
+ *         Description: Optional MMIO access counting and tracing.  With
+ *                      MMIO_TRACE_ENABLED=1, XSpi_ReadReg / XSpi_WriteReg
+ *                      (spi_utilities.h) and XGpio_DiscreteWrite go through
+ *                      the functions below, which count every access per
+ *                      register offset and per call site and can record a
+ *                      bounded trace.  With MMIO_TRACE_ENABLED=0 (default)
+ *                      the register macros are plain Xil_In32 / Xil_Out32
+ *                      and nothing here is compiled in.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef MMIO_UTILITIES_H_
+#define MMIO_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "xgpio.h"
+
+#ifndef MMIO_TRACE_ENABLED
+#define MMIO_TRACE_ENABLED 0            //!< 1 (e.g. -DMMIO_TRACE_ENABLED=1) counts SPI register and GPIO accesses
+#endif
+
+#define MMIO_MAX_SITES 32               //!< Distinct call sites counted; later ones only go to the totals
+#define MMIO_MAX_REGIONS 4              //!< Peripherals (4 KB pages) with per-offset counters
+#define MMIO_REGION_OFFSETS 32          //!< Offsets 0x00-0x7C counted one by one, higher ones together
+#define MMIO_TRACE_DEPTH 512            //!< Accesses recorded after MMIO TRACE; later ones are only counted
+
+/*
+ * Report (mmio_report()):
+ *
+ *   MMIO REGION 0x<base> OFF 0x<offset>|OTHER RD=<n> WR=<n>     one line per offset accessed
+ *   MMIO SITE <file>:<line> RD=<n> WR=<n>                       one line per call site
+ *   MMIO TOTAL RD=<n> WR=<n> SITES_LOST=<n> REGIONS_LOST=<n>
+ *
+ * Trace (mmio_trace_dump()), oldest first:
+ *
+ *   MMIO T <timer ticks, low 32 bits> R|W 0x<address> 0x<value> <file>:<line>
+ *
+ * Counting is not reentrant:  an access from an interrupt handler that lands inside one from the
+ * main loop may be missed in the per-offset or per-site counters.
+ */
+
+struct maximMmioSite                    //!< Accesses made from one source line
+{
+	const char *sFile;
+	u32 unLine;
+	u32 unReads;
+	u32 unWrites;
+};
+
+struct maximMmioRegion                  //!< Accesses to one peripheral, by register offset
+{
+	u32 unBaseAddress;
+	u32 aunReads[MMIO_REGION_OFFSETS];
+	u32 aunWrites[MMIO_REGION_OFFSETS];
+	u32 unOtherReads;
+	u32 unOtherWrites;
+};
+
+struct maximMmioEvent                   //!< One traced access (16 bytes)
+{
+	u32 unTimestamp;
+	u32 unAddress;
+	u32 unValue;
+	u8 uchSite;                         //!< index into axSites, MMIO_MAX_SITES if the site was not registered
+	u8 uchWrite;
+	u16 uReserved;
+};
+
+struct maximMmioState
+{
+	u64 ullReads;                       //!< every counted read, including unregistered sites
+	u64 ullWrites;
+	int nSites;
+	u32 unSitesLost;                    //!< accesses from sites that did not fit in axSites
+	int nRegions;
+	u32 unRegionsLost;                  //!< accesses to peripherals that did not fit in axRegions
+	int nTraceArmed;
+	u32 unTraceCount;
+	u32 unTraceLost;                    //!< accesses made while armed after the trace was full
+	struct maximMmioSite axSites[MMIO_MAX_SITES];
+	struct maximMmioRegion axRegions[MMIO_MAX_REGIONS];
+	struct maximMmioEvent axTrace[MMIO_TRACE_DEPTH];
+};
+
+extern struct maximMmioState g_xMmio;
+
+// Each expansion owns a static slot caching its site, so the site lookup runs once per source line
+#define MMIO_SITE_SLOT() ({ static struct maximMmioSite *pMmioSite_; &pMmioSite_; })
+
+#define MMIO_IN32(Address)              mmio_in32(MMIO_SITE_SLOT(), __FILE__, __LINE__, (u32)(Address))
+#define MMIO_OUT32(Address, Value)      mmio_out32(MMIO_SITE_SLOT(), __FILE__, __LINE__, (u32)(Address), (u32)(Value))
+
+#if MMIO_TRACE_ENABLED && !defined(MMIO_UTILITIES_IMPLEMENTATION)
+#define XGpio_DiscreteWrite(InstancePtr, Channel, Data) \
+	mmio_gpio_write(MMIO_SITE_SLOT(), __FILE__, __LINE__, (InstancePtr), (Channel), (Data))
+#endif
+
+u32 mmio_in32(struct maximMmioSite **ppSite, const char *sFile, int nLine, u32 unAddress);
+void mmio_out32(struct maximMmioSite **ppSite, const char *sFile, int nLine, u32 unAddress, u32 unValue);
+void mmio_gpio_write(struct maximMmioSite **ppSite, const char *sFile, int nLine, XGpio *pGpio,
+		unsigned unChannel, u32 unData);
+void mmio_reset(void);
+void mmio_trace_start(void);
+void mmio_report(void);
+u32 mmio_trace_dump(void);
+
+#endif /* MMIO_UTILITIES_H_ */
@@ -0,0 +1,209 @@
+/** \file mmu_utilities.c ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: mmu_utilities.c
+ *         Description: Explicit memory map setup for CPU0:  PL AXI peripherals
+ *                      as Device memory, L1/L2 caches and prefetch on for
+ *                      code and data, and a report of the attributes that are
+ *                      actually in effect.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+#include "delays.h"
+#include "mmu_utilities.h"
+
+extern u32 MMUTable[];      // 4096 section descriptors, from the BSP's translation_table.S
+
+
+#if defined(__arm__)
+static u32 mmu_read_sctlr(void)
+{
+	u32 unValue;
+	__asm__ __volatile__("mrc p15, 0, %0, c1, c0, 0" : "=r"(unValue));
+	return(unValue);
+}
+
+static u32 mmu_read_actlr(void)
+{
+	u32 unValue;
+	__asm__ __volatile__("mrc p15, 0, %0, c1, c0, 1" : "=r"(unValue));
+	return(unValue);
+}
+
+static void mmu_write_actlr(u32 unValue)
+{
+	__asm__ __volatile__("mcr p15, 0, %0, c1, c0, 1\n\tisb" : : "r"(unValue) : "memory");
+}
+
+static void mmu_invalidate_tlb(void)
+{
+	__asm__ __volatile__("mcr p15, 0, %0, c8, c7, 0\n\tdsb\n\tisb" : : "r"(0) : "memory");
+}
+#else
+static u32 mmu_read_sctlr(void) { return(0); }
+static u32 mmu_read_actlr(void) { return(0); }
+static void mmu_write_actlr(u32 unValue) { (void)unValue; }
+static void mmu_invalidate_tlb(void) { }
+#endif
+
+static const char *mmu_cache_policy(u32 unPolicy)
+/**
+* \brief       Name of a 2 bit cache policy encoding (C:B, or TEX[1:0] for the outer policy).
+*/
+{
+	static const char *asPolicy[4] = { "NC", "WB-WA", "WT", "WB" };
+	return(asPolicy[unPolicy & 0x03]);
+}
+
+static void mmu_print_section(const char *sName, u32 unAddress)
+/**
+* \brief       Print the decoded section descriptor that maps unAddress.
+*/
+{
+	u32 unEntry = mmu_section_attributes(unAddress);
+	u32 unTex = (unEntry >> 12) & 0x07;
+	u32 unCB = (unEntry >> 2) & 0x03;
+	char sType[32];
+
+	if((unEntry & 0x03) != 0x02)
+		snprintf(sType, sizeof(sType), "not a section");
+	else if(unTex & 0x04)
+		snprintf(sType, sizeof(sType), "Normal in=%s out=%s", mmu_cache_policy(unCB), mmu_cache_policy(unTex));
+	else if(unTex == 0 && unCB == 0)
+		snprintf(sType, sizeof(sType), "Strongly-ordered");
+	else if((unTex == 0 && unCB == 1) || (unTex == 2 && unCB == 0))
+		snprintf(sType, sizeof(sType), "Device");
+	else if(unTex == 1 && unCB == 0)
+		snprintf(sType, sizeof(sType), "Normal NC");
+	else if(unTex == 1 && unCB == 3)
+		snprintf(sType, sizeof(sType), "Normal WB-WA");
+	else
+		snprintf(sType, sizeof(sType), "Normal %s", (unCB == 2) ? "WT" : "WB");
+
+	printf("  %-10s 0x%08lx  %08lx  %-22s S=%lu XN=%lu\r\n", sName, (unsigned long)unAddress,
+			(unsigned long)unEntry, sType, (unsigned long)((unEntry >> 16) & 1), (unsigned long)((unEntry >> 4) & 1));
+}
+
+void mmu_init(void)
+/**
+* \brief       Set up the CPU0 memory map and caches.
+* \par         Details
+*              - PL AXI range (MMU_PL_AXI_START..MMU_PL_AXI_END):  Device, execute never.  The BSP
+*                maps it strongly-ordered, which stalls on every register write; Device memory keeps
+*                accesses in program order but lets writes be buffered.
+*              - Low OCM:  normal write-back, or non-cacheable with MMU_OCM_NONCACHEABLE.
+*              - L1 I/D caches on, L1 and L2 prefetch on, L2 cache on with instruction and data
+*                prefetch and double linefill.
+*
+*              The descriptors are rewritten in place, cleaned to memory as one range and the TLB
+*              invalidated once, rather than paying a full cache flush per section through
+*              Xil_SetTlbAttributes().  Call once at boot on CPU0, before CPU1 is released:  the L2
+*              cache is briefly disabled while its prefetch setting changes.
+*
+* \retval      None
+*/
+{
+	u32 unSection;
+
+	for(unSection = MMU_PL_AXI_START / MMU_SECTION_SIZE; unSection <= MMU_PL_AXI_END / MMU_SECTION_SIZE; unSection++)
+		MMUTable[unSection] = (unSection * MMU_SECTION_SIZE) | MMU_ATTR_DEVICE | MMU_ATTR_XN;
+#if MMU_OCM_NONCACHEABLE
+	MMUTable[0] = MMU_ATTR_NORMAL_NONCACHEABLE;
+#endif
+	Xil_DCacheFlushRange((INTPTR)&MMUTable[0], 4096 * sizeof(u32));
+	mmu_invalidate_tlb();
+
+	Xil_ICacheEnable();
+	Xil_DCacheEnable();
+	mmu_write_actlr(mmu_read_actlr() | MMU_ACTLR_L1_PREFETCH | MMU_ACTLR_L2_PREFETCH_HINT);
+
+	Xil_L2CacheDisable();
+	Xil_Out32(MMU_L2CC_BASEADDR + MMU_L2CC_PREFETCH_CONTROL,
+			Xil_In32(MMU_L2CC_BASEADDR + MMU_L2CC_PREFETCH_CONTROL) | MMU_L2CC_PREFETCH_ENABLE);
+	Xil_L2CacheEnable();
+}
+
+u32 mmu_section_attributes(u32 unAddress)
+/**
+* \brief       Section descriptor currently mapping unAddress.
+*
+* \param[in]   unAddress    - any address
+*
+* \retval      The raw first level descriptor
+*/
+{
+	return(MMUTable[unAddress / MMU_SECTION_SIZE]);
+}
+
+void mmu_report(u32 unPeripheralAddressSPI)
+/**
+* \brief       Print the effective cache and memory attribute setup, and what it costs.
+* \par         Details
+*              After the control register and descriptor dump, two timing loops show the two kinds
+*              of cost separately:  MMU_MEASURE_COUNT reads of the SPI status register (MMIO bound)
+*              and MMU_MEASURE_COUNT float conversions with snprintf (CPU and cache bound).
+*
+* \param[in]   unPeripheralAddressSPI   - SPI peripheral whose status register is read
+*
+* \retval      None
+*/
+{
+	u32 unSctlr = mmu_read_sctlr();
+	u32 unActlr = mmu_read_actlr();
+	u64 ullStart, ullMmioTicks, ullFormatTicks;
+	volatile u32 unSink;
+	char sBuffer[16];
+	int i;
+
+	printf("MMU/cache setup:\r\n");
+	printf("  SCTLR %08lx  MMU=%lu D-cache=%lu I-cache=%lu branch-prediction=%lu\r\n", (unsigned long)unSctlr,
+			(unsigned long)(unSctlr & 1), (unsigned long)((unSctlr >> 2) & 1),
+			(unsigned long)((unSctlr >> 12) & 1), (unsigned long)((unSctlr >> 11) & 1));
+	printf("  ACTLR %08lx  L1-prefetch=%lu L2-prefetch-hint=%lu SMP=%lu\r\n", (unsigned long)unActlr,
+			(unsigned long)((unActlr >> 2) & 1), (unsigned long)((unActlr >> 1) & 1), (unsigned long)((unActlr >> 6) & 1));
+	printf("  L2CC  control=%08lx prefetch=%08lx\r\n",
+			(unsigned long)Xil_In32(MMU_L2CC_BASEADDR + MMU_L2CC_CONTROL),
+			(unsigned long)Xil_In32(MMU_L2CC_BASEADDR + MMU_L2CC_PREFETCH_CONTROL));
+
+	mmu_print_section("DDR", 0x00100000);
+	mmu_print_section("OCM low", 0x00000000);
+	mmu_print_section("OCM high", 0xFFFF0000);
+	mmu_print_section("PL SPI", unPeripheralAddressSPI);
+	mmu_print_section("PS UART", XPAR_XUARTPS_0_BASEADDR);
+
+	ullStart = get_time_ticks();
+	for(i=0;i<MMU_MEASURE_COUNT;i++)
+		unSink = Xil_In32(unPeripheralAddressSPI + 0x64);
+	ullMmioTicks = get_time_ticks() - ullStart;
+
+	ullStart = get_time_ticks();
+	for(i=0;i<MMU_MEASURE_COUNT;i++)
+		snprintf(sBuffer, sizeof(sBuffer), "%.4f", (float)i / 16.0f);
+	ullFormatTicks = get_time_ticks() - ullStart;
+	(void)unSink;
+
+	printf("  cost    MMIO read %lu ns, float format %lu ns\r\n",
+			(unsigned long)(ullMmioTicks * 1000000000ULL / TICKS_PER_SECOND / MMU_MEASURE_COUNT),
+			(unsigned long)(ullFormatTicks * 1000000000ULL / TICKS_PER_SECOND / MMU_MEASURE_COUNT));
+	fflush(stdout);
+}
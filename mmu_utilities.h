@@ -0,0 +1,61 @@
+/** \file mmu_utilities.h ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: mmu_utilities.h
+ *         Description: Explicit memory map setup for CPU0:  PL AXI peripherals
+ *                      as Device memory, L1/L2 caches and prefetch on for
+ *                      code and data, and a report of the attributes that are
+ *                      actually in effect.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef MMU_UTILITIES_H_
+#define MMU_UTILITIES_H_
+
+#include "xbasic_types.h"
+
+// Short descriptor section attributes (TEX remap off)
+#define MMU_ATTR_STRONGLY_ORDERED 0x00C02   //!< TEX=000 C=0 B=0, AP=11
+#define MMU_ATTR_DEVICE 0x00C06             //!< TEX=000 C=0 B=1 (shareable device), AP=11
+#define MMU_ATTR_NORMAL_NONCACHEABLE 0x14DE2    //!< TEX=100 C=0 B=0, S=1, domain 15, AP=11
+#define MMU_ATTR_NORMAL_WB_WA 0x15DE6       //!< TEX=101 C=0 B=1 (inner and outer write-back write-allocate), S=1
+#define MMU_ATTR_XN 0x00010                 //!< Execute never
+
+#define MMU_SECTION_SIZE 0x100000           //!< One short descriptor section, 1 MB
+#define MMU_PL_AXI_START 0x40000000         //!< First PL AXI GP0 section
+#define MMU_PL_AXI_END 0xBFFFFFFF           //!< Last byte of PL AXI GP1
+
+#ifndef MMU_OCM_NONCACHEABLE
+#define MMU_OCM_NONCACHEABLE 0              //!< 1 maps the low OCM section (and the __fast_ sections in it) non-cacheable
+#endif
+
+#define MMU_L2CC_BASEADDR 0xF8F02000        //!< L2C-310 cache controller
+#define MMU_L2CC_CONTROL 0x100              //!< bit 0:  L2 enabled
+#define MMU_L2CC_PREFETCH_CONTROL 0xF60     //!< bit 28 data prefetch, bit 29 instruction prefetch, bit 30 double linefill
+#define MMU_L2CC_PREFETCH_ENABLE 0x70000000
+
+#define MMU_ACTLR_L2_PREFETCH_HINT 0x02     //!< Cortex-A9 ACTLR bit 1
+#define MMU_ACTLR_L1_PREFETCH 0x04          //!< Cortex-A9 ACTLR bit 2
+
+#define MMU_MEASURE_COUNT 1000              //!< Iterations of each mmu_report() timing loop
+
+void mmu_init(void);
+u32 mmu_section_attributes(u32 unAddress);
+void mmu_report(u32 unPeripheralAddressSPI);
+
+#endif /* MMU_UTILITIES_H_ */
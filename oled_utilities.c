@@ -60,11 +60,19 @@
  *
  ***************************************************************************/
 
+#include <string.h>
 #include "oled_utilities.h"
 #include "delays.h"
 #include "max31723.h"
+#include "max31855_utilities.h"
+#include "memory_sections.h"
+#include "profile_utilities.h"
+#include "fixed_point_utilities.h"
 //#include "maximPMOD.h"
 
+__fast_bss struct maximOLEDDisplay g_structureOLED;     // frame buffers are rewritten on every display update
+__fast_bss char g_tempString[32];
+
 #define OLED_VBAT 0x20
 #define OLED_VDD 0x10;
 #define OLED_RESET_B 0x08
@@ -260,6 +268,24 @@ void displayOLEDBuffer(u8 *pauchBuffer)
 * \param[in]   *pauchBuffer          - pointer to an u8 array used for the OLED pixel buffer
 * \retval      None
 */
+{
+	PROF_BEGIN(PROF_OLED_DISPLAY);
+	displayOLEDPages(pauchBuffer, 0, 4);
+	PROF_END(PROF_OLED_DISPLAY);
+}
+
+void displayOLEDPages(u8 *pauchBuffer, int nFirstPage, int nPageCount)
+/**
+* \brief       Copies some of the 128 byte pages of the display buffer into the OLED display
+* \par         Details
+*              Same as displayOLEDBuffer(), but only pages nFirstPage .. nFirstPage+nPageCount-1 are sent,
+*              for updates that only touch one or two text lines.
+*
+* \param[in]   *pauchBuffer          - pointer to an u8 array used for the OLED pixel buffer (all 4 pages)
+* \param[in]   nFirstPage            - first page to send (0..3)
+* \param[in]   nPageCount            - number of pages to send
+* \retval      None
+*/
 {
 	int column=0;
 	int page=0;
@@ -283,8 +309,8 @@ void displayOLEDBuffer(u8 *pauchBuffer)
 	// Write 4 pages worth of data
 	// Note that the SSD1306 controller can handle 128x64 displays, but the OLED
 	// used on zedboard is only 128x32.  Data is provided to the display as (4) pages of 128 bytes each.
-	p = pauchBuffer;
-	for(page=0;page<4;page++)
+	p = pauchBuffer + (nFirstPage * 128);
+	for(page=nFirstPage;page<nFirstPage+nPageCount && page<4;page++)
 	{
 		// Enable Command Mode (shut off data mode)
 		g_structureOLED.portStatus &= ~OLED_DATA_COMMAND_B;
@@ -420,6 +446,7 @@ void flipAndCopyDisplayBuffer(u8 *pauchSourceBuffer, u8 *pauchDestinationBuffer)
 	u8 uchTempWord1;
 	u8 uchTempWord2;
 	u8 uchTempWord3;
+	PROF_BEGIN(PROF_OLED_FLIP);
 
 	for(y=0;y<4;y++)
 	{
@@ -436,10 +463,65 @@ void flipAndCopyDisplayBuffer(u8 *pauchSourceBuffer, u8 *pauchDestinationBuffer)
 			pauchDestinationBuffer[((y*128)+x)] = uchTempWord3;
 		}
 	}
+	PROF_END(PROF_OLED_FLIP);
 }
 
 
 
+void printOLED_31723(s16 nTemp, int displayCelsius)
+/**
+* \brief       Prints the MAX31723 temperature to the OLED
+* \par         Details
+*              Both lines are drawn into the buffer first, so the display is sent once.  Integer
+*              formatting only, to 0.1 degree.
+*
+* \param[in]   nTemp           - temperature in 1/16 degC (Q12.4)
+* \param[in]   displayCelsius  - true = degrees C, false = degrees F
+* \retval      None
+*/
+{
+	char sText[Q4_MAX_TEXT];
+
+	clearOLEDBuffer(g_structureOLED.writeBuffer);
+	printfToBufferOLED(0,0,"Temperature:");
+	q4_format(sText, displayCelsius ? nTemp : q4_celsius_to_fahrenheit(nTemp), 1);
+	sprintf(g_tempString,"%s deg %c",sText,displayCelsius ? 'C' : 'F');
+	printfToBufferOLED(0,1,g_tempString);
+	flipAndCopyDisplayBuffer(g_structureOLED.writeBuffer, g_structureOLED.flippedBuffer);
+	displayOLEDBuffer(g_structureOLED.flippedBuffer);
+}
+
+void printOLED_31855(s16 nInternalTemp, s16 nProbeTemp, u8 uchFaults, int displayCelsius)
+/**
+* \brief       Prints the MAX31855 thermocouple and cold junction temperatures to the OLED
+* \par         Details
+*              The probe line shows the fault instead of a temperature when one is set.
+*
+* \param[in]   nInternalTemp   - cold junction temperature in 1/16 degC (Q12.4)
+* \param[in]   nProbeTemp      - thermocouple temperature in 1/16 degC (Q12.4)
+* \param[in]   uchFaults       - MAX31855_FAULT_... bits of the reading
+* \param[in]   displayCelsius  - true = degrees C, false = degrees F
+* \retval      None
+*/
+{
+	char sText[Q4_MAX_TEXT];
+
+	clearOLEDBuffer(g_structureOLED.writeBuffer);
+	if(uchFaults)
+		sprintf(g_tempString,"TC: fault %s",max_MAX31855_fault_name(uchFaults));
+	else
+	{
+		q4_format(sText, displayCelsius ? nProbeTemp : q4_celsius_to_fahrenheit(nProbeTemp), 1);
+		sprintf(g_tempString,"TC: %s deg %c",sText,displayCelsius ? 'C' : 'F');
+	}
+	printfToBufferOLED(0,0,g_tempString);
+	q4_format(sText, displayCelsius ? nInternalTemp : q4_celsius_to_fahrenheit(nInternalTemp), 1);
+	sprintf(g_tempString,"CJ: %s deg %c",sText,displayCelsius ? 'C' : 'F');
+	printfToBufferOLED(0,1,g_tempString);
+	flipAndCopyDisplayBuffer(g_structureOLED.writeBuffer, g_structureOLED.flippedBuffer);
+	displayOLEDBuffer(g_structureOLED.flippedBuffer);
+}
+
 void printOLED_44000Lux(float fLuxReading)
 /**
 * \brief       Prints the MAX44000 Lux data to the OLED
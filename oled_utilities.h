@@ -70,6 +70,7 @@
 #include "xparameters.h"    
 #include "xgpio.h"          
 #include "xgpio_l.h"        
+#include "mmio_utilities.h"
 //#include "maximPMOD.h"
 #endif /* UTILITIES_H_ */
 
@@ -84,19 +85,20 @@ struct maximOLEDDisplay
 	u8 *font;
 };
 
-struct maximOLEDDisplay g_structureOLED;
-char g_tempString[32];
+extern struct maximOLEDDisplay g_structureOLED;
+extern char g_tempString[32];
 
 void initializeOLED(u8 *pFont);
 void sendOLEDSPI(u8 uchDataToWrite);
 void clearOLEDBuffer(u8 *pauchBuffer);
 void displayOLEDBuffer(u8 *pauchBuffer);
+void displayOLEDPages(u8 *pauchBuffer, int nFirstPage, int nPageCount);
 void putCharOLED(int x, int y, char chCharacter);
 void printfToBufferOLED(int x, int y,char *chString);
 void printfToOLED(int x, int y,char *chString);
 void flipAndCopyDisplayBuffer(u8 *pauchSourceBuffer, u8 *pauchDestinationBuffer);
-void printOLED_31855(float fInternalTemp,float fProbeTemp, int displayCelsius);
-void printOLED_31723(float fTemp);
+void printOLED_31855(s16 nInternalTemp, s16 nProbeTemp, u8 uchFaults, int displayCelsius);
+void printOLED_31723(s16 nTemp, int displayCelsius);
 //void printOLED_3231M(struct maximDateTime t, float fTemp);
 void printOLED_44000Lux(float fLuxReading);
 void printOLED_44000Prox(float fProxReading);
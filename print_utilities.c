@@ -62,6 +62,8 @@
 
 #include "stdio.h"
 #include "xbasic_types.h"
+#include "profile_utilities.h"
+#include "fixed_point_utilities.h"
 //#include "maximPMOD.h"
 
 void print_asterisks(int nQuantity)
@@ -78,26 +80,46 @@ void print_asterisks(int nQuantity)
 		printf("*");
 }
 
-void printf_temp(float fTemp, u8 uchPrintCelsius, u8 uchAddCarriageReturn)
+void printf_temp_q4(s16 nTemp, u8 uchPrintCelsius, u8 uchAddCarriageReturn)
 /**
 * \brief       Print temperature as xx.x as degrees F or C
 * \par         Details
 *              This function prints the temperature with .1 degree resolution in either degrees
 * \n           Celsius (uchPrintCelsius==TRUE) -or- Fahrenheit (uchPrintCelsius==FALSE)
+* \n           The conversion and formatting use integer arithmetic only.
 *
-* \param[in]   fTemp                   - temperature to print in celsius
+* \param[in]   nTemp                   - temperature to print in 1/16 degrees celsius (Q12.4)
 * \param[in]   uchPrintCelsius         - true = print as celsius, false = print as fahrenheit
 * \param[in]   uchAddCarriageReturn    - true = add a carriage return
 *
 * \retval      None
 */
 {
+	char sText[Q4_MAX_TEXT];
+	PROF_BEGIN(PROF_PRINTF_TEMP);
 	if(uchPrintCelsius==TRUE)
-		printf("%.1f deg C",fTemp);
+	{
+		q4_format(sText, nTemp, 1);
+		printf("%s deg C",sText);
+	}
 	else
-		printf("%.1f deg F",((fTemp*1.8f)+32.0f));
+	{
+		q4_format(sText, q4_celsius_to_fahrenheit(nTemp), 1);
+		printf("%s deg F",sText);
+	}
 	if(uchAddCarriageReturn==TRUE)
 		printf("\r\n");
+	PROF_END(PROF_PRINTF_TEMP);
+}
+
+void printf_temp(float fTemp, u8 uchPrintCelsius, u8 uchAddCarriageReturn)
+/**
+* \brief       Float adapter for printf_temp_q4();  fTemp is rounded to 1/16 degree first.
+*
+* \retval      None
+*/
+{
+	printf_temp_q4(q4_from_float(fTemp), uchPrintCelsius, uchAddCarriageReturn);
 }
 
 void menu_cls()
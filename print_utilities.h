@@ -88,6 +88,7 @@
 
 void print_asterisks(int nQuantity);
 void printf_temp(float fTemp, u8 uchPrintCelsius, u8 uchAddCarriageReturn);
+void printf_temp_q4(s16 nTemp, u8 uchPrintCelsius, u8 uchAddCarriageReturn);
 
 void menu_cls();
 void menu_print_maxim_banner();
@@ -0,0 +1,124 @@
+/** \file profile_utilities.c ************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: profile_utilities.c
+ *         Description: Cycle accurate profiling with the Cortex-A9 PMU
+ *                      (see profile_utilities.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include "xbasic_types.h"
+#include "profile_utilities.h"
+
+#define PROF_SITE_NAME(id, name) name,
+
+static const char *g_asProfSiteNames[PROF_SITE_COUNT] =
+{
+	PROF_SITE_TABLE(PROF_SITE_NAME)
+};
+
+struct maximProfSite g_axProfSites[PROF_SITE_COUNT];
+
+
+void prof_init(void)
+/**
+* \brief       Enable the PMU cycle counter and event counters 0 and 1, and clear all sites.
+* \par         Details
+*              The cycle counter counts every CPU cycle (no /64 divider) and wraps after about
+*              6 s at 667 MHz; a single region must be shorter than that.
+*
+* \retval      None
+*/
+{
+#if !PROF_HOST
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 5" : : "r"(0));                 // PMSELR = 0
+	__asm__ __volatile__("isb\n\tmcr p15, 0, %0, c9, c13, 1" : : "r"(PROF_EVENT_0)); // PMXEVTYPER
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 5" : : "r"(1));                 // PMSELR = 1
+	__asm__ __volatile__("isb\n\tmcr p15, 0, %0, c9, c13, 1" : : "r"(PROF_EVENT_1));
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 0" : : "r"(0x07));              // PMCR:  E, reset events, reset cycles
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 1" : : "r"(0x80000003));        // PMCNTENSET:  cycles, events 0 and 1
+	__asm__ __volatile__("isb" ::: "memory");
+#endif
+	prof_reset();
+}
+
+void prof_record(int nSite, const struct maximProfStamp *pBegin)
+/**
+* \brief       Add the region that started at *pBegin to the accumulators of nSite.  Called through PROF_END().
+*
+* \param[in]   nSite        - site id from PROF_SITE_TABLE
+* \param[in]   *pBegin      - counter values taken by PROF_BEGIN()
+*
+* \retval      None
+*/
+{
+	struct maximProfStamp xEnd;
+	struct maximProfSite *pSite = &g_axProfSites[nSite];
+	u32 unCycles;
+
+	prof_stamp(&xEnd);
+	unCycles = xEnd.unCycles - pBegin->unCycles;
+
+	if(pSite->unCount == 0 || unCycles < pSite->unMinCycles)
+		pSite->unMinCycles = unCycles;
+	if(unCycles > pSite->unMaxCycles)
+		pSite->unMaxCycles = unCycles;
+	pSite->ullTotalCycles += unCycles;
+	pSite->aullTotalEvents[0] += xEnd.aunEvents[0] - pBegin->aunEvents[0];
+	pSite->aullTotalEvents[1] += xEnd.aunEvents[1] - pBegin->aunEvents[1];
+	pSite->unCount++;
+}
+
+void prof_reset(void)
+/**
+* \brief       Clear the accumulators of all sites.
+*
+* \retval      None
+*/
+{
+	memset(g_axProfSites, 0, sizeof(g_axProfSites));
+}
+
+void prof_report(void)
+/**
+* \brief       Print one line per site that has been hit.
+* \par         Details
+*              Format:  PROF <name> count=<n> min=<c> max=<c> mean=<c> ev03=<n> ev61=<n>
+* \n           c is CPU cycles (nanoseconds on the host build); the event columns are per call means.
+*
+* \retval      None
+*/
+{
+	int i;
+	struct maximProfSite *pSite;
+
+	for(i=0;i<PROF_SITE_COUNT;i++)
+	{
+		pSite = &g_axProfSites[i];
+		if(pSite->unCount == 0)
+			continue;
+		printf("PROF %s count=%lu min=%lu max=%lu mean=%lu ev%02x=%lu ev%02x=%lu\r\n", g_asProfSiteNames[i],
+				(unsigned long)pSite->unCount, (unsigned long)pSite->unMinCycles,
+				(unsigned long)pSite->unMaxCycles, (unsigned long)(pSite->ullTotalCycles / pSite->unCount),
+				PROF_EVENT_0, (unsigned long)(pSite->aullTotalEvents[0] / pSite->unCount),
+				PROF_EVENT_1, (unsigned long)(pSite->aullTotalEvents[1] / pSite->unCount));
+	}
+	fflush(stdout);
+}
@@ -0,0 +1,126 @@
+/** \file profile_utilities.h ************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: profile_utilities.h
+ *         Description: Cycle accurate profiling with the Cortex-A9 PMU.
+ *
+ *                      PROF_BEGIN(id) / PROF_END(id) bracket a region in one
+ *                      scope; each completed region adds its cycle count and
+ *                      PMU event counts to the accumulators of site id.  Sites
+ *                      are listed once in PROF_SITE_TABLE.  Host builds
+ *                      (PROF_HOST, the default when not compiling for ARM)
+ *                      count nanoseconds from clock_gettime() instead of
+ *                      cycles, and no events.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef PROFILE_UTILITIES_H_
+#define PROFILE_UTILITIES_H_
+
+#include "xbasic_types.h"
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 1               //!< 0 compiles PROF_BEGIN / PROF_END out
+#endif
+
+#ifndef PROF_HOST
+#if defined(__arm__)
+#define PROF_HOST 0
+#else
+#define PROF_HOST 1                     //!< clock_gettime() instead of the PMU
+#endif
+#endif
+
+#if PROF_HOST
+#include <time.h>
+#endif
+
+#define PROF_EVENT_0 0x03               //!< PMU event counter 0:  L1 data cache refill
+#define PROF_EVENT_1 0x61               //!< PMU event counter 1:  cycles stalled on a data cache linefill
+
+/*
+ * Profiled sites.  New entries may go anywhere; the names are only used in the report.
+ */
+#define PROF_SITE_TABLE(X) \
+	X(PROF_SPI_RW,              "SpiRW") \
+	X(PROF_SPI_FIXED,           "spi_fixed") \
+	X(PROF_MAX31723_GET_TEMP,   "max_MAX31723_get_raw") \
+	X(PROF_OLED_DISPLAY,        "displayOLEDBuffer") \
+	X(PROF_OLED_FLIP,           "flipAndCopyDisplayBuffer") \
+	X(PROF_PRINTF_TEMP,         "printf_temp")
+
+#define PROF_SITE_ENUM(id, name) id,
+
+enum maximProfSiteId
+{
+	PROF_SITE_TABLE(PROF_SITE_ENUM)
+	PROF_SITE_COUNT
+};
+
+struct maximProfStamp                   //!< Counter values at PROF_BEGIN
+{
+	u32 unCycles;
+	u32 aunEvents[2];
+};
+
+struct maximProfSite                    //!< Accumulators of one site
+{
+	u32 unCount;
+	u32 unMinCycles;
+	u32 unMaxCycles;
+	u64 ullTotalCycles;
+	u64 aullTotalEvents[2];
+};
+
+extern struct maximProfSite g_axProfSites[PROF_SITE_COUNT];
+
+static inline void prof_stamp(struct maximProfStamp *pStamp)
+/**
+* \brief       Read the cycle and event counters.  Called through PROF_BEGIN().
+*/
+{
+#if PROF_HOST
+	struct timespec xNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	pStamp->unCycles = (u32)((u64)xNow.tv_sec * 1000000000ULL + (u64)xNow.tv_nsec);
+	pStamp->aunEvents[0] = 0;
+	pStamp->aunEvents[1] = 0;
+#else
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 5" : : "r"(0));         // PMSELR = 0
+	__asm__ __volatile__("isb\n\tmrc p15, 0, %0, c9, c13, 2" : "=r"(pStamp->aunEvents[0]));
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 5" : : "r"(1));         // PMSELR = 1
+	__asm__ __volatile__("isb\n\tmrc p15, 0, %0, c9, c13, 2" : "=r"(pStamp->aunEvents[1]));
+	__asm__ __volatile__("mrc p15, 0, %0, c9, c13, 0" : "=r"(pStamp->unCycles));  // PMCCNTR last, closest to the region
+#endif
+}
+
+#if PROFILE_ENABLED
+#define PROF_BEGIN(id)  struct maximProfStamp xProfStamp_##id; prof_stamp(&xProfStamp_##id)
+#define PROF_END(id)    prof_record((id), &xProfStamp_##id)
+#else
+#define PROF_BEGIN(id)  do { } while(0)
+#define PROF_END(id)    do { } while(0)
+#endif
+
+void prof_init(void);
+void prof_record(int nSite, const struct maximProfStamp *pBegin);
+void prof_reset(void);
+void prof_report(void);
+
+#endif /* PROFILE_UTILITIES_H_ */
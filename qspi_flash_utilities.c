@@ -0,0 +1,250 @@
+/** \file qspi_flash_utilities.c **********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: qspi_flash_utilities.c
+ *         Description: Serial NOR flash on the AXI Quad SPI controller (see
+ *                      qspi_flash_utilities.h).
+ *
+ *                      Every command is one SpiRWv() transaction:  the
+ *                      command, address and dummy bytes from a small header
+ *                      buffer followed by the caller's data buffer, under one
+ *                      slave select, so data is never copied.  In dual and quad mode
+ *                      the core decodes the command byte and switches lanes
+ *                      for the data phase itself, so the byte stream is the
+ *                      same in every mode.  Quad commands need the flash's
+ *                      quad enable bit set (non-volatile on most parts, set
+ *                      by default on the Micron parts the core targets).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "spi_utilities.h"
+#include "qspi_flash_utilities.h"
+
+#define QSPI_FLASH_HEADER_BYTES (1 + 3 + QSPI_FLASH_DUMMY_BYTES)   //!< Largest command + address + dummy phase
+
+
+static void qspi_flash_header(u8 *auchHeader, u8 uchCommand, u32 unAddress)
+{
+	auchHeader[0] = uchCommand;
+	auchHeader[1] = (u8)(unAddress >> 16);
+	auchHeader[2] = (u8)(unAddress >> 8);
+	auchHeader[3] = (u8)unAddress;
+}
+
+static int qspi_flash_transaction(struct maximQspiFlash *pFlash, const struct spiSegment *axSegments, int nSegments)
+{
+	return(SpiRWv(pFlash->unPeripheralAddressSPI, pFlash->nSlave, 0, 0, axSegments, nSegments, FALSE));
+}
+
+static int qspi_flash_transfer(struct maximQspiFlash *pFlash, u8 *auchWrite, u8 *auchRead, int nLength)
+{
+	// Mode 0, active low select:  the dual and quad modes of the core only support modes 0 and 3
+	return(SpiRWSlave(pFlash->unPeripheralAddressSPI, pFlash->nSlave, 0, 0, auchWrite, auchRead, nLength, FALSE));
+}
+
+static int qspi_flash_command(struct maximQspiFlash *pFlash, u8 uchCommand)
+{
+	return(qspi_flash_transfer(pFlash, &uchCommand, NULL, 1));
+}
+
+static int qspi_flash_wait_ready(struct maximQspiFlash *pFlash, u32 unTimeoutMs)
+/**
+* \brief       Poll the status register until the write in progress bit clears.
+*
+* \retval      TRUE when ready, FALSE on timeout
+*/
+{
+	u32 unStart = get_time_ms();
+
+	while(qspi_flash_read_status(pFlash) & QSPI_FLASH_STATUS_WIP)
+	{
+		if(get_time_ms() - unStart > unTimeoutMs)
+			return(FALSE);
+	}
+	return(TRUE);
+}
+
+int qspi_flash_init(struct maximQspiFlash *pFlash, u32 unPeripheralAddressSPI, int nSlave, u8 uchSpiMode)
+/**
+* \brief       Pick the read and program commands for the core's mode and read the JEDEC ID.
+*
+* \param[out]  *pFlash                  - flash instance
+* \param[in]   unPeripheralAddressSPI   - SPI controller the flash is attached to
+* \param[in]   nSlave                   - slave select line of the flash
+* \param[in]   uchSpiMode               - QSPI_FLASH_MODE_..., the SpiMode of the initialized XSpi instance
+*
+* \retval      TRUE if a device answered (ID neither all 0x00 nor all 0xFF), FALSE also when the
+*              controller is wider than 8 bits
+*/
+{
+	memset(pFlash, 0, sizeof(*pFlash));
+	pFlash->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	pFlash->nSlave = nSlave;
+	pFlash->uchSpiMode = uchSpiMode;
+	if(spi_word_bytes(unPeripheralAddressSPI) != 1)
+		return(FALSE);
+	spi_set_slave_polarity(unPeripheralAddressSPI, nSlave, FALSE);
+
+	if(uchSpiMode == QSPI_FLASH_MODE_QUAD)
+	{
+		pFlash->uchReadCommand = QSPI_FLASH_CMD_QUAD_READ;
+		pFlash->uchProgramCommand = QSPI_FLASH_CMD_QUAD_PAGE_PROGRAM;
+	}
+	else if(uchSpiMode == QSPI_FLASH_MODE_DUAL)
+	{
+		pFlash->uchReadCommand = QSPI_FLASH_CMD_DUAL_READ;
+		pFlash->uchProgramCommand = QSPI_FLASH_CMD_PAGE_PROGRAM;   // dual input program is not common to all parts
+	}
+	else
+	{
+		pFlash->uchReadCommand = QSPI_FLASH_CMD_FAST_READ;
+		pFlash->uchProgramCommand = QSPI_FLASH_CMD_PAGE_PROGRAM;
+	}
+
+	qspi_flash_read_id(pFlash, pFlash->auchId);
+	if((pFlash->auchId[0] == 0x00 && pFlash->auchId[1] == 0x00 && pFlash->auchId[2] == 0x00)
+			|| (pFlash->auchId[0] == 0xFF && pFlash->auchId[1] == 0xFF && pFlash->auchId[2] == 0xFF))
+		return(FALSE);
+	return(TRUE);
+}
+
+int qspi_flash_read_id(struct maximQspiFlash *pFlash, u8 *auchId)
+/**
+* \brief       Read the 3 byte JEDEC ID.
+*
+* \param[in]   *pFlash      - flash instance
+* \param[out]  *auchId      - manufacturer, memory type, capacity
+*
+* \retval      Always TRUE
+*/
+{
+	u8 auchWrite[4] = { QSPI_FLASH_CMD_READ_ID, 0, 0, 0 };
+	u8 auchRead[4];
+
+	qspi_flash_transfer(pFlash, auchWrite, auchRead, 4);
+	memcpy(auchId, &auchRead[1], 3);
+	return(TRUE);
+}
+
+u8 qspi_flash_read_status(struct maximQspiFlash *pFlash)
+/**
+* \brief       Read the status register.
+*
+* \retval      QSPI_FLASH_STATUS_... bits
+*/
+{
+	u8 auchWrite[2] = { QSPI_FLASH_CMD_READ_STATUS, 0 };
+	u8 auchRead[2];
+
+	qspi_flash_transfer(pFlash, auchWrite, auchRead, 2);
+	return(auchRead[1]);
+}
+
+int qspi_flash_read(struct maximQspiFlash *pFlash, u32 unAddress, u8 *auchData, int nLength)
+/**
+* \brief       Read nLength bytes from unAddress with the mode's read command.
+* \par         Details
+*              One command reads any length:  the flash keeps incrementing the address for as
+*              long as the select stays asserted, and the data lands directly in auchData.
+*
+* \param[in]   *pFlash      - flash instance
+* \param[in]   unAddress    - 24 bit start address
+* \param[out]  *auchData    - nLength bytes
+* \param[in]   nLength      - bytes to read
+*
+* \retval      TRUE if read, FALSE if the controller refused the transaction
+*/
+{
+	u8 auchHeader[QSPI_FLASH_HEADER_BYTES] = { 0 };
+	struct spiSegment axSegments[2] =
+	{
+		{ auchHeader, NULL, QSPI_FLASH_HEADER_BYTES, SPI_SEG_DISCARD_RX },  // command, address, dummy
+		{ NULL, auchData, nLength, SPI_SEG_ZERO_TX }
+	};
+
+	if(nLength <= 0)
+		return(TRUE);
+	qspi_flash_header(auchHeader, pFlash->uchReadCommand, unAddress);
+	return(qspi_flash_transaction(pFlash, axSegments, 2) == 0);
+}
+
+int qspi_flash_program(struct maximQspiFlash *pFlash, u32 unAddress, const u8 *auchData, int nLength)
+/**
+* \brief       Program nLength bytes at unAddress (the area must have been erased).
+* \par         Details
+*              Commands are split at page boundaries, where the flash would wrap.  Each is
+*              preceded by a write enable and waited out;  the data is sent from auchData.
+*
+* \param[in]   *pFlash      - flash instance
+* \param[in]   unAddress    - 24 bit start address
+* \param[in]   *auchData    - nLength bytes
+* \param[in]   nLength      - bytes to program
+*
+* \retval      TRUE if done, FALSE if a page program was refused or timed out
+*/
+{
+	u8 auchHeader[4];
+	struct spiSegment axSegments[2];
+	int nChunk;
+
+	axSegments[0].auchWriteBuf = auchHeader;
+	axSegments[0].auchReadBuf = NULL;
+	axSegments[0].nNumBytes = 4;
+	axSegments[0].uchFlags = SPI_SEG_DISCARD_RX;
+	axSegments[1].auchReadBuf = NULL;
+	axSegments[1].uchFlags = SPI_SEG_DISCARD_RX;
+	while(nLength > 0)
+	{
+		nChunk = QSPI_FLASH_PAGE_SIZE - (int)(unAddress % QSPI_FLASH_PAGE_SIZE);
+		if(nChunk > nLength)
+			nChunk = nLength;
+
+		if(qspi_flash_command(pFlash, QSPI_FLASH_CMD_WRITE_ENABLE) != 0)
+			return(FALSE);
+		qspi_flash_header(auchHeader, pFlash->uchProgramCommand, unAddress);
+		axSegments[1].auchWriteBuf = auchData;
+		axSegments[1].nNumBytes = nChunk;
+		if(qspi_flash_transaction(pFlash, axSegments, 2) != 0 || !qspi_flash_wait_ready(pFlash, QSPI_FLASH_PROGRAM_TIMEOUT_MS))
+			return(FALSE);
+
+		auchData += nChunk;
+		unAddress += nChunk;
+		nLength -= nChunk;
+	}
+	return(TRUE);
+}
+
+int qspi_flash_erase_sector(struct maximQspiFlash *pFlash, u32 unAddress)
+/**
+* \brief       Erase the 4 KB sector containing unAddress.
+*
+* \retval      TRUE if done, FALSE if refused or on timeout
+*/
+{
+	u8 auchWrite[4];
+
+	if(qspi_flash_command(pFlash, QSPI_FLASH_CMD_WRITE_ENABLE) != 0)
+		return(FALSE);
+	qspi_flash_header(auchWrite, QSPI_FLASH_CMD_SECTOR_ERASE, unAddress);
+	if(qspi_flash_transfer(pFlash, auchWrite, NULL, 4) != 0)
+		return(FALSE);
+	return(qspi_flash_wait_ready(pFlash, QSPI_FLASH_ERASE_TIMEOUT_MS));
+}
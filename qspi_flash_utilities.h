@@ -0,0 +1,82 @@
+/** \file qspi_flash_utilities.h **********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: qspi_flash_utilities.h
+ *         Description: Serial NOR flash on a slave select line of the AXI
+ *                      Quad SPI controller (e.g. for sample logging).  Reads
+ *                      and page programs use the dual or quad lane commands
+ *                      when the core was built in dual or quad mode; the
+ *                      core runs the command, address and dummy phases on
+ *                      one lane and the data phase on 2 or 4.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef QSPI_FLASH_UTILITIES_H_
+#define QSPI_FLASH_UTILITIES_H_
+
+#include "xbasic_types.h"
+
+#define QSPI_FLASH_SLAVE 1              //!< Slave select line of the flash (line 0 is the MAX31723)
+
+#define QSPI_FLASH_MODE_STANDARD 0      //!< Core build option C_SPI_MODE;  same values as the XSpi SpiMode XSP_..._MODE
+#define QSPI_FLASH_MODE_DUAL 1
+#define QSPI_FLASH_MODE_QUAD 2
+
+#define QSPI_FLASH_CMD_WRITE_ENABLE 0x06
+#define QSPI_FLASH_CMD_READ_STATUS 0x05
+#define QSPI_FLASH_CMD_READ_ID 0x9F     //!< JEDEC ID:  manufacturer, memory type, capacity
+#define QSPI_FLASH_CMD_FAST_READ 0x0B   //!< 1-1-1, 1 dummy byte
+#define QSPI_FLASH_CMD_DUAL_READ 0x3B   //!< 1-1-2 (dual output), 1 dummy byte
+#define QSPI_FLASH_CMD_QUAD_READ 0x6B   //!< 1-1-4 (quad output), 1 dummy byte
+#define QSPI_FLASH_CMD_PAGE_PROGRAM 0x02        //!< 1-1-1
+#define QSPI_FLASH_CMD_QUAD_PAGE_PROGRAM 0x32   //!< 1-1-4 (quad input)
+#define QSPI_FLASH_CMD_SECTOR_ERASE 0x20        //!< 4 KB
+
+#define QSPI_FLASH_STATUS_WIP 0x01      //!< write (program or erase) in progress
+#define QSPI_FLASH_STATUS_WEL 0x02      //!< write enable latch
+
+#define QSPI_FLASH_PAGE_SIZE 256
+#define QSPI_FLASH_SECTOR_SIZE 4096
+#define QSPI_FLASH_DUMMY_BYTES 1        //!< 8 dummy clocks for the fast, dual and quad output reads
+#define QSPI_FLASH_PROGRAM_TIMEOUT_MS 10
+#define QSPI_FLASH_ERASE_TIMEOUT_MS 1000
+
+/*
+ * Flash commands are exact byte counts (a 1 byte write enable, a 2 byte status read, a page
+ * program of any length), and the core only runs its dual and quad modes with 8 bit transfers,
+ * so qspi_flash_init() refuses a controller built wider than 8 bits (see spi_word_bytes()).
+ */
+
+struct maximQspiFlash                   //!< One flash device
+{
+	u32 unPeripheralAddressSPI;
+	int nSlave;
+	u8 uchReadCommand;                  //!< QSPI_FLASH_CMD_..._READ matching the controller's mode
+	u8 uchProgramCommand;               //!< QSPI_FLASH_CMD_..._PAGE_PROGRAM matching the controller's mode
+	u8 uchSpiMode;                      //!< QSPI_FLASH_MODE_... the core was built with
+	u8 auchId[3];                       //!< JEDEC ID read by qspi_flash_init()
+};
+
+int qspi_flash_init(struct maximQspiFlash *pFlash, u32 unPeripheralAddressSPI, int nSlave, u8 uchSpiMode);
+int qspi_flash_read_id(struct maximQspiFlash *pFlash, u8 *auchId);
+u8 qspi_flash_read_status(struct maximQspiFlash *pFlash);
+int qspi_flash_read(struct maximQspiFlash *pFlash, u32 unAddress, u8 *auchData, int nLength);
+int qspi_flash_program(struct maximQspiFlash *pFlash, u32 unAddress, const u8 *auchData, int nLength);
+int qspi_flash_erase_sector(struct maximQspiFlash *pFlash, u32 unAddress);
+
+#endif /* QSPI_FLASH_UTILITIES_H_ */
@@ -0,0 +1,464 @@
+/** \file register_map.c *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: register_map.c
+ *         Description: Table driven register access for SPI sensors.  A
+ *                      device is described once (register offsets, widths,
+ *                      address encoding, burst support, conversion timing)
+ *                      and one engine plans the burst reads, caches the
+ *                      registers and encodes/decodes their values.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "spi_utilities.h"
+#include "register_map.h"
+
+struct regmapRun                        //!< One planned burst:  bytes [nStart, nEnd) of the address space
+{
+	int nStart;
+	int nEnd;
+};
+
+
+static void regmap_note_configuration(struct maximRegisterMap *pMap, s32 lConfiguration)
+/**
+* \brief       Take the validity of the conversion results from a configuration value.
+*/
+{
+	if(pMap->pDevice->pfnConversionUs != NULL)
+		pMap->unConversionUs = pMap->pDevice->pfnConversionUs((u32)lConfiguration);
+}
+
+int regmap_init(struct maximRegisterMap *pMap, const struct maximDeviceDesc *pDevice, u32 unPeripheralAddressSPI,
+		int nSlave)
+/**
+* \brief       Attach a register map to one part.  Nothing is read until the first regmap_read().
+* \par         Details
+*              The select polarity is declared to the SPI layer here (see spi_set_slave_polarity()).
+*              Until the configuration register is read or written, conversion results are cached
+*              for the conversion time of configuration 0.
+*
+* \param[out]  *pMap                    - register map instance
+* \param[in]   *pDevice                 - description of the part
+* \param[in]   unPeripheralAddressSPI   - SPI controller the part is on
+* \param[in]   nSlave                   - its slave select line
+*
+* \retval      FALSE if the description exceeds REGMAP_MAX_BYTES or REGMAP_MAX_REGISTERS
+*/
+{
+	memset(pMap, 0, sizeof(*pMap));
+	if(pDevice->uchSize > REGMAP_MAX_BYTES || pDevice->nRegisters > REGMAP_MAX_REGISTERS)
+		return(FALSE);
+	pMap->pDevice = pDevice;
+	pMap->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	pMap->nSlave = nSlave;
+	regmap_note_configuration(pMap, 0);
+	spi_set_slave_polarity(unPeripheralAddressSPI, nSlave, pDevice->uchCsActiveHigh);
+	return(TRUE);
+}
+
+int regmap_find(const struct maximDeviceDesc *pDevice, const char *sName)
+/**
+* \brief       Index of a register by name.
+*
+* \retval      Index into axRegisters, -1 if there is none
+*/
+{
+	int i;
+
+	for(i=0;i<pDevice->nRegisters;i++)
+		if(strcmp(pDevice->axRegisters[i].sName, sName) == 0)
+			return(i);
+	return(-1);
+}
+
+static s32 regmap_decode(const struct maximRegisterDesc *pRegister, const u8 *auchBytes)
+/**
+* \brief       Value of a register from its bytes in address order.
+*/
+{
+	u32 unRaw = 0;
+	u32 unMask = (pRegister->uchBits >= 32) ? 0xFFFFFFFF : ((1UL << pRegister->uchBits) - 1);
+	int i;
+
+	for(i=0;i<pRegister->uchBytes;i++)
+	{
+		if(pRegister->uchFlags & REGMAP_LSB_FIRST)
+			unRaw |= (u32)auchBytes[i] << (8 * i);
+		else
+			unRaw = (unRaw << 8) | auchBytes[i];
+	}
+	unRaw = (unRaw >> pRegister->uchShift) & unMask;
+	if((pRegister->uchFlags & REGMAP_SIGNED) && pRegister->uchBits < 32 && (unRaw & (1UL << (pRegister->uchBits - 1))))
+		unRaw |= ~unMask;
+	return((s32)unRaw);
+}
+
+static void regmap_encode(const struct maximRegisterDesc *pRegister, s32 lValue, u8 *auchBytes)
+/**
+* \brief       Bytes of a register value in address order;  bits outside the field are written as 0.
+*/
+{
+	u32 unMask = (pRegister->uchBits >= 32) ? 0xFFFFFFFF : ((1UL << pRegister->uchBits) - 1);
+	u32 unRaw = ((u32)lValue & unMask) << pRegister->uchShift;
+	int i;
+
+	for(i=0;i<pRegister->uchBytes;i++)
+	{
+		if(pRegister->uchFlags & REGMAP_LSB_FIRST)
+			auchBytes[i] = (u8)(unRaw >> (8 * i));
+		else
+			auchBytes[i] = (u8)(unRaw >> (8 * (pRegister->uchBytes - 1 - i)));
+	}
+}
+
+static int regmap_is_fresh(const struct maximRegisterMap *pMap, int nRegister, u32 unNow)
+{
+	if(!pMap->auchValid[nRegister])
+		return(FALSE);
+	if(!(pMap->pDevice->axRegisters[nRegister].uchFlags & REGMAP_VOLATILE))
+		return(TRUE);
+	return(unNow - pMap->aunReadTimeUs[nRegister] < pMap->unConversionUs);
+}
+
+static int regmap_plan(const struct maximRegisterMap *pMap, u32 unNeeded, struct regmapRun *axRuns)
+/**
+* \brief       Merge the byte ranges of the needed registers into as few bursts as pay off.
+* \par         Details
+*              Ranges are taken in address order;  one joins the current burst when the bytes
+*              between them are no more than REGMAP_BURST_GAP.  A device without burst reads gets
+*              one transaction per register, and one without an address always reads its frame
+*              from offset 0.
+*
+* \retval      Number of bursts in axRuns
+*/
+{
+	const struct maximDeviceDesc *pDevice = pMap->pDevice;
+	const struct maximRegisterDesc *pRegister;
+	u8 auchOrder[REGMAP_MAX_REGISTERS];
+	int nOrdered = 0, nRuns = 0;
+	int i, j, nStart, nEnd;
+
+	// Insertion sort of the needed registers by offset
+	for(i=0;i<pDevice->nRegisters;i++)
+	{
+		if(!(unNeeded & (1UL << i)))
+			continue;
+		for(j=nOrdered;j>0 && pDevice->axRegisters[auchOrder[j-1]].uchOffset > pDevice->axRegisters[i].uchOffset;j--)
+			auchOrder[j] = auchOrder[j-1];
+		auchOrder[j] = (u8)i;
+		nOrdered++;
+	}
+
+	for(i=0;i<nOrdered;i++)
+	{
+		pRegister = &pDevice->axRegisters[auchOrder[i]];
+		nStart = pDevice->uchAddressed ? pRegister->uchOffset : 0;
+		nEnd = pRegister->uchOffset + pRegister->uchBytes;
+		if(nRuns > 0 && (!pDevice->uchAddressed || (pDevice->uchBurst && nStart <= axRuns[nRuns-1].nEnd + REGMAP_BURST_GAP)))
+		{
+			if(nEnd > axRuns[nRuns-1].nEnd)
+				axRuns[nRuns-1].nEnd = nEnd;
+			continue;
+		}
+		axRuns[nRuns].nStart = nStart;
+		axRuns[nRuns].nEnd = nEnd;
+		nRuns++;
+	}
+	return(nRuns);
+}
+
+static void regmap_fetch(struct maximRegisterMap *pMap, const struct regmapRun *pRun, u32 unNow)
+/**
+* \brief       Read one burst into the shadow and validate every register it covers.
+* \par         Details
+*              The burst is lengthened to whole SPI words over the following bytes, or over the
+*              preceding ones where it would run past the end of the address space.
+*/
+{
+	const struct maximDeviceDesc *pDevice = pMap->pDevice;
+	const struct maximRegisterDesc *pRegister;
+	u8 auchWrite[REGMAP_FRAME_BYTES];
+	u8 auchRead[REGMAP_FRAME_BYTES];
+	int nHeader = pDevice->uchAddressed ? 1 : 0;
+	int nStart = pRun->nStart;
+	int nEnd = pRun->nEnd;
+	int i;
+
+	nEnd += SPI_ALIGN_BYTES(nHeader + nEnd - nStart, spi_word_bytes(pMap->unPeripheralAddressSPI)) - (nHeader + nEnd - nStart);
+	if(nHeader && nEnd > pDevice->uchSize && nStart >= nEnd - pDevice->uchSize)
+	{
+		nStart -= nEnd - pDevice->uchSize;
+		nEnd = pDevice->uchSize;
+	}
+
+	memset(auchWrite, 0, nHeader + nEnd - nStart);
+	if(nHeader)
+		auchWrite[0] = (u8)(nStart | pDevice->uchReadFlag);
+	SpiRWSlave(pMap->unPeripheralAddressSPI, pMap->nSlave, pDevice->uchCPHA, pDevice->uchCPOL, auchWrite, auchRead,
+			nHeader + nEnd - nStart, pDevice->uchCsActiveHigh);
+	if(nEnd > pDevice->uchSize)
+		nEnd = pDevice->uchSize;
+	memcpy(&pMap->auchShadow[nStart], &auchRead[nHeader], nEnd - nStart);
+	pMap->unTransfers++;
+
+	for(i=0;i<pDevice->nRegisters;i++)
+	{
+		pRegister = &pDevice->axRegisters[i];
+		if(!(pRegister->uchFlags & REGMAP_READ) || pRegister->uchOffset < nStart ||
+				pRegister->uchOffset + pRegister->uchBytes > nEnd)
+			continue;
+		pMap->auchValid[i] = TRUE;
+		pMap->aunReadTimeUs[i] = unNow;
+		if(pRegister->uchFlags & REGMAP_CONFIG)
+			regmap_note_configuration(pMap, regmap_decode(pRegister, &pMap->auchShadow[pRegister->uchOffset]));
+	}
+}
+
+int regmap_read(struct maximRegisterMap *pMap, const u8 *auchRegisters, int nRegisters, s32 *alValues)
+/**
+* \brief       Read several registers, from the cache where it is still valid.
+* \par         Details
+*              The registers that must come from the part are fetched with the fewest bursts
+*              regmap_plan() finds.  Conversion results are not read before the first conversion
+*              after a configuration write has completed:  until then they are returned with their
+*              last value and are not marked valid, the other registers are read as usual, and the
+*              call returns REGMAP_NOT_READY instead of waiting.
+*
+* \param[in]   *pMap            - register map instance
+* \param[in]   auchRegisters    - register indices
+* \param[in]   nRegisters       - entries in auchRegisters
+* \param[out]  alValues         - decoded values, in the order of auchRegisters
+*
+* \retval      Number of SPI transactions it took (0 when everything was cached), REGMAP_NOT_READY,
+*              or -1 for an unknown or write-only register
+*/
+{
+	const struct maximDeviceDesc *pDevice = pMap->pDevice;
+	const struct maximRegisterDesc *pRegister;
+	struct regmapRun axRuns[REGMAP_MAX_REGISTERS];
+	u32 unNeeded = 0;
+	u32 unNow = get_time_us();
+	int nVolatile = FALSE;
+	int nNotReady = FALSE;
+	int nRuns, i;
+
+	for(i=0;i<nRegisters;i++)
+	{
+		if(auchRegisters[i] >= pDevice->nRegisters || !(pDevice->axRegisters[auchRegisters[i]].uchFlags & REGMAP_READ))
+			return(-1);
+		if(regmap_is_fresh(pMap, auchRegisters[i], unNow))
+		{
+			pMap->unHits++;
+			continue;
+		}
+		unNeeded |= (1UL << auchRegisters[i]);
+		if(pDevice->axRegisters[auchRegisters[i]].uchFlags & REGMAP_VOLATILE)
+			nVolatile = TRUE;
+	}
+
+	if(nVolatile && pMap->uchReadyPending)
+	{
+		if((s32)(unNow - pMap->unReadyTimeUs) < 0)
+		{
+			for(i=0;i<nRegisters;i++)
+				if(pDevice->axRegisters[auchRegisters[i]].uchFlags & REGMAP_VOLATILE)
+					unNeeded &= ~(1UL << auchRegisters[i]);
+			nNotReady = TRUE;
+		}
+		else
+			pMap->uchReadyPending = FALSE;
+	}
+
+	nRuns = 0;
+	if(unNeeded != 0)
+	{
+		nRuns = regmap_plan(pMap, unNeeded, axRuns);
+		for(i=0;i<nRuns;i++)
+			regmap_fetch(pMap, &axRuns[i], unNow);
+		for(i=0;i<pDevice->nRegisters;i++)
+			if(unNeeded & (1UL << i))
+				pMap->unMisses++;
+	}
+
+	for(i=0;i<nRegisters;i++)
+	{
+		pRegister = &pDevice->axRegisters[auchRegisters[i]];
+		alValues[i] = regmap_decode(pRegister, &pMap->auchShadow[pRegister->uchOffset]);
+	}
+	return(nNotReady ? REGMAP_NOT_READY : nRuns);
+}
+
+int regmap_read_one(struct maximRegisterMap *pMap, int nRegister, s32 *plValue)
+/**
+* \brief       regmap_read() of a single register.
+*
+* \retval      TRUE if the value came from the cache, FALSE if the part was read, the register is unknown
+*              or its conversion result is not ready yet
+*/
+{
+	u8 uchRegister = (u8)nRegister;
+
+	if(nRegister < 0)
+		return(FALSE);
+	return(regmap_read(pMap, &uchRegister, 1, plValue) == 0);
+}
+
+static int regmap_register_at(const struct maximDeviceDesc *pDevice, int nOffset)
+/**
+* \brief       Index of the register holding a byte of the address space, -1 for an undescribed byte.
+*/
+{
+	int i;
+
+	for(i=0;i<pDevice->nRegisters;i++)
+		if(nOffset >= pDevice->axRegisters[i].uchOffset &&
+				nOffset < pDevice->axRegisters[i].uchOffset + pDevice->axRegisters[i].uchBytes)
+			return(i);
+	return(-1);
+}
+
+static int regmap_pad_write(struct maximRegisterMap *pMap, int nRegister, int nPad)
+/**
+* \brief       Place the word padding of a write frame on bytes the write leaves unchanged.
+* \par         Details
+*              Bytes of read-only registers are used first:  the part ignores them.  Otherwise the
+*              padding may cover readable, writable registers that are neither REGMAP_CONFIG nor
+*              REGMAP_VOLATILE;  they are brought into the cache here, so the frame can carry
+*              their current value from the shadow.
+*
+* \retval      Padding bytes in front of the register, -1 if every arrangement would change the part
+*/
+{
+	const struct maximDeviceDesc *pDevice = pMap->pDevice;
+	const struct maximRegisterDesc *pRegister = &pDevice->axRegisters[nRegister];
+	u8 auchKeep[REGMAP_MAX_REGISTERS];
+	s32 alValues[REGMAP_MAX_REGISTERS];
+	int nPass, nBefore, nOffset, nOther, nKeep, nUsable, i;
+	u8 uchFlags;
+
+	for(nPass=0;nPass<2;nPass++)
+	{
+		for(nBefore=0;nBefore<=nPad;nBefore++)
+		{
+			if(pRegister->uchOffset < nBefore || pRegister->uchOffset + pRegister->uchBytes + nPad - nBefore > pDevice->uchSize)
+				continue;
+			nKeep = 0;
+			nUsable = TRUE;
+			for(nOffset=pRegister->uchOffset-nBefore;nUsable && nOffset<pRegister->uchOffset+pRegister->uchBytes+nPad-nBefore;nOffset++)
+			{
+				nOther = regmap_register_at(pDevice, nOffset);
+				if(nOther == nRegister)
+					continue;
+				if(nOther < 0)
+				{
+					nUsable = FALSE;
+					continue;
+				}
+				uchFlags = pDevice->axRegisters[nOther].uchFlags;
+				if(!(uchFlags & REGMAP_WRITE))
+					continue;
+				if(nPass == 0 || !(uchFlags & REGMAP_READ) || (uchFlags & (REGMAP_CONFIG | REGMAP_VOLATILE)))
+				{
+					nUsable = FALSE;
+					continue;
+				}
+				for(i=0;i<nKeep && auchKeep[i]!=nOther;i++)
+					;
+				if(i == nKeep)
+					auchKeep[nKeep++] = (u8)nOther;
+			}
+			if(!nUsable)
+				continue;
+			if(nKeep > 0)
+				regmap_read(pMap, auchKeep, nKeep, alValues);
+			return(nBefore);
+		}
+	}
+	return(-1);
+}
+
+int regmap_write(struct maximRegisterMap *pMap, int nRegister, s32 lValue)
+/**
+* \brief       Write a register and invalidate its cached value.
+* \par         Details
+*              Writing the REGMAP_CONFIG register also invalidates the conversion results and
+*              holds off reading them until one conversion time at the new configuration has passed.
+*              On a core wider than 8 bits the frame is padded to whole words as regmap_pad_write()
+*              finds;  the bytes it adds leave the part unchanged.
+*
+* \param[in]   *pMap        - register map instance
+* \param[in]   nRegister    - register index
+* \param[in]   lValue       - value, before encoding
+*
+* \retval      FALSE for an unknown or read-only register, a device without an address, or a
+*              register whose frame cannot be padded to whole words
+*/
+{
+	const struct maximDeviceDesc *pDevice = pMap->pDevice;
+	const struct maximRegisterDesc *pRegister;
+	u8 auchWrite[REGMAP_FRAME_BYTES];
+	u8 auchRead[REGMAP_FRAME_BYTES];
+	int nPad, nBefore, nStart, nLength;
+	int i;
+
+	if(nRegister < 0 || nRegister >= pDevice->nRegisters || !pDevice->uchAddressed)
+		return(FALSE);
+	pRegister = &pDevice->axRegisters[nRegister];
+	if(!(pRegister->uchFlags & REGMAP_WRITE))
+		return(FALSE);
+
+	nPad = SPI_ALIGN_BYTES(1 + pRegister->uchBytes, spi_word_bytes(pMap->unPeripheralAddressSPI)) - (1 + pRegister->uchBytes);
+	nBefore = (nPad > 0) ? regmap_pad_write(pMap, nRegister, nPad) : 0;
+	if(nBefore < 0)
+		return(FALSE);
+	nStart = pRegister->uchOffset - nBefore;
+	nLength = pRegister->uchBytes + nPad;
+
+	auchWrite[0] = (u8)(nStart | pDevice->uchWriteFlag);
+	memcpy(&auchWrite[1], &pMap->auchShadow[nStart], nLength);
+	regmap_encode(pRegister, lValue, &auchWrite[1 + nBefore]);
+	SpiRWSlave(pMap->unPeripheralAddressSPI, pMap->nSlave, pDevice->uchCPHA, pDevice->uchCPOL, auchWrite, auchRead,
+			1 + nLength, pDevice->uchCsActiveHigh);
+	pMap->unTransfers++;
+	pMap->auchValid[nRegister] = FALSE;
+
+	if(pRegister->uchFlags & REGMAP_CONFIG)
+	{
+		regmap_note_configuration(pMap, lValue);
+		pMap->unReadyTimeUs = get_time_us() + pMap->unConversionUs;
+		pMap->uchReadyPending = TRUE;
+		for(i=0;i<pDevice->nRegisters;i++)
+			if(pDevice->axRegisters[i].uchFlags & REGMAP_VOLATILE)
+				pMap->auchValid[i] = FALSE;
+	}
+	return(TRUE);
+}
+
+void regmap_invalidate(struct maximRegisterMap *pMap)
+/**
+* \brief       Drop every cached register, e.g. after the part was written by other code.
+*
+* \retval      None
+*/
+{
+	memset(pMap->auchValid, 0, sizeof(pMap->auchValid));
+}
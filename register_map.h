@@ -0,0 +1,119 @@
+/** \file register_map.h *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: register_map.h
+ *         Description: Table driven register access for SPI sensors.  A
+ *                      device is described once (register offsets, widths,
+ *                      address encoding, burst support, conversion timing)
+ *                      and one engine plans the burst reads, caches the
+ *                      registers and encodes/decodes their values.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef REGISTER_MAP_H_
+#define REGISTER_MAP_H_
+
+#include "xbasic_types.h"
+
+#define REGMAP_MAX_BYTES 32             //!< Largest device address space (bytes)
+#define REGMAP_MAX_REGISTERS 16         //!< Most registers in one device description
+#define REGMAP_BURST_GAP 2              //!< Unwanted bytes worth reading to save a separate transaction
+#define REGMAP_FRAME_BYTES (1 + REGMAP_MAX_BYTES + 3)   //!< Largest transaction:  command byte, address space, word padding
+
+#define REGMAP_READ 0x01                //!< register can be read
+#define REGMAP_WRITE 0x02               //!< register can be written
+#define REGMAP_VOLATILE 0x04            //!< changes on its own (a conversion result);  cached for one conversion time
+#define REGMAP_SIGNED 0x08              //!< value is two's complement in uchBits bits
+#define REGMAP_LSB_FIRST 0x10           //!< lowest address holds the least significant byte
+#define REGMAP_CONFIG 0x20              //!< selects the conversion time;  writing it restarts conversions
+
+#define REGMAP_NOT_READY -2             //!< regmap_read():  no conversion result yet at the configuration last written
+
+/*
+ * A device's registers are byte ranges of one address space.  Addressed devices take a command
+ * byte (offset | uchReadFlag or offset | uchWriteFlag) followed by data;  with uchBurst the
+ * address auto-increments, so any run of registers is one transaction.  Devices without an
+ * address (uchAddressed FALSE, e.g. a read-only thermocouple converter) shift their whole frame
+ * from offset 0 on every read.
+ *
+ * A register value is the bytes of its range assembled in the order given by REGMAP_LSB_FIRST,
+ * shifted right by uchShift and uchBits wide.  regmap_read() fetches the registers that are not
+ * cached, merging ranges that lie within REGMAP_BURST_GAP bytes of each other into one burst,
+ * and every register a burst covers is cached as well.  Writes go to the part and invalidate the
+ * register;  max31723_cache.c keeps its values in such a map.  After a configuration write,
+ * regmap_read() does not wait for the first conversion:  until it has completed, the conversion
+ * results keep their last value, stay stale and the read returns REGMAP_NOT_READY.
+ *
+ * Every transaction is a whole number of SPI words (see spi_word_bytes()).  A burst read is
+ * lengthened over the following registers, or the preceding ones at the end of the address space.
+ * A write frame is lengthened over read-only registers, which ignore the bytes, or else over
+ * writable ones that are written back with their cached value;  a register with no such neighbours
+ * cannot be written on that controller.
+ */
+
+struct maximRegisterDesc                //!< One register of a device description
+{
+	const char *sName;
+	u8 uchOffset;                       //!< first byte in the device address space
+	u8 uchBytes;                        //!< 1 to 4
+	u8 uchFlags;                        //!< REGMAP_...
+	u8 uchShift;                        //!< value starts this many bits up in the assembled bytes
+	u8 uchBits;                         //!< value width
+};
+
+struct maximDeviceDesc                  //!< Everything the engine needs to know about a part
+{
+	const char *sName;
+	u8 uchCPHA;
+	u8 uchCPOL;
+	u8 uchCsActiveHigh;
+	u8 uchAddressed;                    //!< FALSE for a device that only shifts out its frame
+	u8 uchReadFlag;                     //!< ORed into the offset to form a read command
+	u8 uchWriteFlag;                    //!< ORed into the offset to form a write command (bit 7 on most Maxim parts)
+	u8 uchBurst;                        //!< address auto-increments across registers
+	u8 uchSize;                         //!< bytes in the address space
+	u32 (*pfnConversionUs)(u32 unConfiguration);   //!< conversion time for a REGMAP_CONFIG value, or NULL
+	const struct maximRegisterDesc *axRegisters;
+	int nRegisters;
+};
+
+struct maximRegisterMap                 //!< One part and its register cache
+{
+	const struct maximDeviceDesc *pDevice;
+	u32 unPeripheralAddressSPI;
+	int nSlave;
+	u8 auchShadow[REGMAP_MAX_BYTES];    //!< bytes as last read from the part
+	u8 auchValid[REGMAP_MAX_REGISTERS];
+	u32 aunReadTimeUs[REGMAP_MAX_REGISTERS];
+	u32 unConversionUs;                 //!< validity of REGMAP_VOLATILE registers;  pfnConversionUs(0) until the configuration is known
+	u32 unReadyTimeUs;                  //!< first conversion after a configuration write completes here
+	u8 uchReadyPending;                 //!< TRUE until conversion results have been read after that write
+	u32 unHits;
+	u32 unMisses;                       //!< registers fetched from the part
+	u32 unTransfers;                    //!< SPI transactions issued
+};
+
+int regmap_init(struct maximRegisterMap *pMap, const struct maximDeviceDesc *pDevice, u32 unPeripheralAddressSPI,
+		int nSlave);
+int regmap_find(const struct maximDeviceDesc *pDevice, const char *sName);
+int regmap_read(struct maximRegisterMap *pMap, const u8 *auchRegisters, int nRegisters, s32 *alValues);
+int regmap_read_one(struct maximRegisterMap *pMap, int nRegister, s32 *plValue);
+int regmap_write(struct maximRegisterMap *pMap, int nRegister, s32 lValue);
+void regmap_invalidate(struct maximRegisterMap *pMap);
+
+#endif /* REGISTER_MAP_H_ */
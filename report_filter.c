@@ -0,0 +1,134 @@
+/** \file report_filter.c ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: report_filter.c
+ *         Description: Report-on-change filter between the acquisition and
+ *                      an output sink (UART text, command stream, OLED, LEDs).
+ *                      A reading is passed on when it moved by more than a
+ *                      deadband, when it crossed an alarm setpoint (with
+ *                      hysteresis), or when the sink has been silent too
+ *                      long.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "report_filter.h"
+#include "memory_sections.h"
+
+
+void report_default_config(struct maximReportConfig *pConfig)
+/**
+* \brief       Fill in the REPORT_DEFAULT_... settings.
+*
+* \retval      None
+*/
+{
+	pConfig->nDeadband = REPORT_DEFAULT_DEADBAND;
+	pConfig->nHysteresis = REPORT_DEFAULT_HYSTERESIS;
+	pConfig->unMaxSilenceMs = REPORT_DEFAULT_MAX_SILENCE_MS;
+}
+
+void report_filter_init(struct maximReportFilter *pFilter, const struct maximReportConfig *pConfig)
+/**
+* \brief       Prepare a filter;  the first reading offered is always reported.
+*
+* \param[out]  *pFilter     - filter instance
+* \param[in]   *pConfig     - settings, or NULL for the defaults
+*
+* \retval      None
+*/
+{
+	memset(pFilter, 0, sizeof(*pFilter));
+	if(pConfig != NULL)
+		pFilter->xConfig = *pConfig;
+	else
+		report_default_config(&pFilter->xConfig);
+	pFilter->uchForce = TRUE;
+}
+
+void report_filter_force(struct maximReportFilter *pFilter)
+/**
+* \brief       Report the next reading whatever it is, e.g. after the sink was cleared or its units changed.
+*
+* \retval      None
+*/
+{
+	pFilter->uchForce = TRUE;
+}
+
+__fast_text static u8 report_zone(const struct maximReportFilter *pFilter, s16 nTemp, s16 nLowAlarm, s16 nHighAlarm)
+/**
+* \brief       Alarm zone of a reading, given the zone of the last one.
+*/
+{
+	s16 nHysteresis = pFilter->xConfig.nHysteresis;
+
+	if(nTemp > nHighAlarm)
+		return(REPORT_ZONE_HIGH);
+	if(nTemp < nLowAlarm)
+		return(REPORT_ZONE_LOW);
+	if(pFilter->uchZone == REPORT_ZONE_HIGH && nTemp >= nHighAlarm - nHysteresis)
+		return(REPORT_ZONE_HIGH);
+	if(pFilter->uchZone == REPORT_ZONE_LOW && nTemp <= nLowAlarm + nHysteresis)
+		return(REPORT_ZONE_LOW);
+	return(REPORT_ZONE_NORMAL);
+}
+
+__fast_text int report_filter_offer(struct maximReportFilter *pFilter, s16 nTemp, s16 nLowAlarm, s16 nHighAlarm, u32 unNowMs)
+/**
+* \brief       Decide whether a new reading goes to the sink.
+* \par         Details
+*              When the reading is reported it becomes the reference for the deadband and the
+*              silence timer restarts;  a suppressed reading changes neither, so a slow drift is
+*              reported once it adds up to more than the deadband.  The alarm zone is tracked on
+*              every reading.
+*
+* \param[in]   *pFilter     - filter instance
+* \param[in]   nTemp        - reading in 1/16 degC
+* \param[in]   nLowAlarm    - Tlow in 1/16 degC
+* \param[in]   nHighAlarm   - Thigh in 1/16 degC
+* \param[in]   unNowMs      - get_time_ms()
+*
+* \retval      REPORT_NONE to skip the sink, otherwise the REPORT_... reasons
+*/
+{
+	int nReasons = REPORT_NONE;
+	s32 nChange = (s32)nTemp - pFilter->nLastReported;
+	u8 uchZone = report_zone(pFilter, nTemp, nLowAlarm, nHighAlarm);
+
+	pFilter->unOffered++;
+	if(pFilter->uchForce)
+		nReasons |= REPORT_FIRST;
+	if(nChange > pFilter->xConfig.nDeadband || nChange < -pFilter->xConfig.nDeadband)
+		nReasons |= REPORT_CHANGE;
+	if(uchZone != pFilter->uchZone)
+		nReasons |= REPORT_ZONE;
+	if(pFilter->xConfig.unMaxSilenceMs != 0 && unNowMs - pFilter->unLastReportMs >= pFilter->xConfig.unMaxSilenceMs)
+		nReasons |= REPORT_SILENCE;
+	pFilter->uchZone = uchZone;
+
+	if(nReasons != REPORT_NONE)
+	{
+		pFilter->uchForce = FALSE;
+		pFilter->nLastReported = nTemp;
+		pFilter->unLastReportMs = unNowMs;
+		pFilter->unReported++;
+	}
+	return(nReasons);
+}
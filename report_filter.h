@@ -0,0 +1,76 @@
+/** \file report_filter.h ****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: report_filter.h
+ *         Description: Report-on-change filter between the acquisition and
+ *                      an output sink (UART text, command stream, OLED, LEDs).
+ *                      A reading is passed on when it moved by more than a
+ *                      deadband, when it crossed an alarm setpoint (with
+ *                      hysteresis), or when the sink has been silent too
+ *                      long.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef REPORT_FILTER_H_
+#define REPORT_FILTER_H_
+
+#include "xbasic_types.h"
+
+#define REPORT_DEFAULT_DEADBAND 1       //!< Changes up to 1/16 degC (sensor dither) are not reported
+#define REPORT_DEFAULT_HYSTERESIS 8     //!< An alarm zone is left 0.5 degC inside the setpoint
+#define REPORT_DEFAULT_MAX_SILENCE_MS 10000 //!< Report at least this often, 0 for never
+
+#define REPORT_NONE 0x00
+#define REPORT_FIRST 0x01               //!< first reading, or after report_filter_force()
+#define REPORT_CHANGE 0x02              //!< moved by more than the deadband since the last report
+#define REPORT_ZONE 0x04                //!< entered or left the Tlow / Thigh alarm zone
+#define REPORT_SILENCE 0x08             //!< nothing reported for unMaxSilenceMs
+
+#define REPORT_ZONE_NORMAL 0
+#define REPORT_ZONE_LOW 1               //!< below Tlow, until above Tlow + hysteresis
+#define REPORT_ZONE_HIGH 2              //!< above Thigh, until below Thigh - hysteresis
+
+/*
+ * Each sink owns a filter, so a display can use a wider deadband than a log.  Zone changes are
+ * reported whatever the deadband, so an alarm transition always reaches the operator.
+ */
+
+struct maximReportConfig
+{
+	s16 nDeadband;                      //!< 1/16 degC
+	s16 nHysteresis;                    //!< 1/16 degC
+	u32 unMaxSilenceMs;
+};
+
+struct maximReportFilter
+{
+	struct maximReportConfig xConfig;
+	u8 uchForce;
+	u8 uchZone;                         //!< REPORT_ZONE_...
+	s16 nLastReported;
+	u32 unLastReportMs;
+	u32 unOffered;
+	u32 unReported;
+};
+
+void report_default_config(struct maximReportConfig *pConfig);
+void report_filter_init(struct maximReportFilter *pFilter, const struct maximReportConfig *pConfig);
+void report_filter_force(struct maximReportFilter *pFilter);
+int report_filter_offer(struct maximReportFilter *pFilter, s16 nTemp, s16 nLowAlarm, s16 nHighAlarm, u32 unNowMs);
+
+#endif /* REPORT_FILTER_H_ */
@@ -0,0 +1,98 @@
+/** \file sample_ring.c ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sample_ring.c
+ *         Description: Fixed size single-producer / single-consumer ring of
+ *                      timestamped raw temperature samples.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include "sample_ring.h"
+#include "memory_sections.h"
+
+
+void sample_ring_init(struct maximSampleRing *pRing)
+/**
+* \brief       Empty the ring and clear the dropped sample counter.
+*
+* \param[out]  *pRing       - ring to initialize
+*
+* \retval      None
+*/
+{
+	pRing->unHead = 0;
+	pRing->unTail = 0;
+	pRing->unDropped = 0;
+}
+
+__fast_text int sample_ring_push(struct maximSampleRing *pRing, const struct maximSample *pSample)
+/**
+* \brief       Append a sample (producer side).
+* \par         Details
+*              When the ring is full the new sample is dropped and counted; the producer never
+*              moves unTail, which keeps the ring lock free.
+*
+* \param[in]   *pRing       - ring
+* \param[in]   *pSample     - sample to copy into the ring
+*
+* \retval      TRUE if stored, FALSE if the ring was full
+*/
+{
+	u32 unHead = pRing->unHead;
+
+	if(unHead - pRing->unTail >= SAMPLE_RING_SIZE)
+	{
+		pRing->unDropped++;
+		return(FALSE);
+	}
+	pRing->axSamples[unHead & (SAMPLE_RING_SIZE - 1)] = *pSample;
+	SAMPLE_RING_BARRIER();
+	pRing->unHead = unHead + 1;
+	return(TRUE);
+}
+
+__fast_text int sample_ring_pop(struct maximSampleRing *pRing, struct maximSample *pSample)
+/**
+* \brief       Remove the oldest sample (consumer side).
+*
+* \param[in]   *pRing       - ring
+* \param[out]  *pSample     - the sample is copied here
+*
+* \retval      TRUE if a sample was returned, FALSE if the ring was empty
+*/
+{
+	u32 unTail = pRing->unTail;
+
+	if(unTail == pRing->unHead)
+		return(FALSE);
+	SAMPLE_RING_BARRIER();
+	*pSample = pRing->axSamples[unTail & (SAMPLE_RING_SIZE - 1)];
+	SAMPLE_RING_BARRIER();
+	pRing->unTail = unTail + 1;
+	return(TRUE);
+}
+
+__fast_text u32 sample_ring_count(const struct maximSampleRing *pRing)
+/**
+* \brief       Number of samples waiting in the ring.
+*
+* \retval      Sample count
+*/
+{
+	return(pRing->unHead - pRing->unTail);
+}
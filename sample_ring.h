@@ -0,0 +1,66 @@
+/** \file sample_ring.h ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sample_ring.h
+ *         Description: Fixed size single-producer / single-consumer ring of
+ *                      timestamped raw temperature samples.  The producer
+ *                      only writes unHead and the consumer only writes unTail,
+ *                      so one side may run in an interrupt (or on the other
+ *                      CPU) without locking.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include "xbasic_types.h"
+
+#define SAMPLE_RING_SIZE 256            //!< Samples held by a ring.  Must be a power of two.
+
+// Orders the sample copy against the index update.  A ring in normal (non-device) memory shared with
+// the other CPU is weakly ordered, so a compiler barrier alone is not enough there.
+#if defined(__arm__)
+#define SAMPLE_RING_BARRIER() __asm__ __volatile__("dmb" ::: "memory")
+#else
+#define SAMPLE_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+struct maximSample                      //!< One timestamped reading (8 bytes)
+{
+	u32 unTimestampUs;                  //!< get_time_us() when the reading was taken
+	s16 nRaw;                           //!< temperature in 1/16 degC
+	u8 uchSensor;                       //!< index of the sensor that produced it
+	u8 uchFlags;                        //!< SAMPLE_FLAG_... bits
+};
+
+#define SAMPLE_FLAG_LATE 0x01           //!< sample was taken more than one period after its deadline
+
+struct maximSampleRing
+{
+	volatile u32 unHead;                //!< samples pushed (written by the producer only)
+	volatile u32 unTail;                //!< samples popped (written by the consumer only)
+	u32 unDropped;                      //!< samples discarded because the ring was full (producer)
+	struct maximSample axSamples[SAMPLE_RING_SIZE];
+};
+
+void sample_ring_init(struct maximSampleRing *pRing);
+int sample_ring_push(struct maximSampleRing *pRing, const struct maximSample *pSample);
+int sample_ring_pop(struct maximSampleRing *pRing, struct maximSample *pSample);
+u32 sample_ring_count(const struct maximSampleRing *pRing);
+
+#endif /* SAMPLE_RING_H_ */
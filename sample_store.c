@@ -0,0 +1,243 @@
+/** \file sample_store.c *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sample_store.c
+ *         Description: Fixed size history of timestamped temperature samples
+ *                      with running statistics (min, max, mean, EWMA and
+ *                      variance) updated on every insert, so summaries are
+ *                      read in constant time.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "sample_store.h"
+#include "fixed_point_utilities.h"
+#include "print_utilities.h"
+#include "delays.h"
+#include "memory_sections.h"
+
+#define SAMPLE_STORE_ROUND(l) ((s16)(((l) + (1L << (SAMPLE_STORE_STAT_SHIFT - 1))) >> SAMPLE_STORE_STAT_SHIFT))
+
+
+static u32 sample_store_isqrt(u64 ullValue)
+/**
+* \brief       Integer square root, rounded down.
+*/
+{
+	u64 ullBit = 1ULL << 62;
+	u64 ullRoot = 0;
+
+	while(ullBit > ullValue)
+		ullBit >>= 2;
+	while(ullBit != 0)
+	{
+		if(ullValue >= ullRoot + ullBit)
+		{
+			ullValue -= ullRoot + ullBit;
+			ullRoot = (ullRoot >> 1) + ullBit;
+		}
+		else
+			ullRoot >>= 1;
+		ullBit >>= 2;
+	}
+	return((u32)ullRoot);
+}
+
+void sample_store_init(struct maximSampleStore *pStore)
+/**
+* \brief       Empty the history and reset the statistics.
+*
+* \param[out]  *pStore      - store to initialize
+*
+* \retval      None
+*/
+{
+	pStore->unHead = 0;
+	pStore->unCount = 0;
+	pStore->nMin = 0;
+	pStore->nMax = 0;
+	pStore->lMean = 0;
+	pStore->lEwma = 0;
+	pStore->ullM2 = 0;
+	pStore->unFirstTimestampUs = 0;
+}
+
+__fast_text void sample_store_add(struct maximSampleStore *pStore, const struct maximSample *pSample)
+/**
+* \brief       Append a sample to the history and fold it into the statistics.
+* \par         Details
+*              The mean and sum of squares follow Welford's update (delta from the old mean times
+*              delta from the new one), which does not need the sum of squares of the raw values
+*              and so cannot lose precision to a large offset.  The first sample seeds the EWMA.
+*
+* \param[in]   *pStore      - store
+* \param[in]   *pSample     - sample to copy into the store
+*
+* \retval      None
+*/
+{
+	s32 lValue = (s32)pSample->nRaw << SAMPLE_STORE_STAT_SHIFT;
+	s32 lDelta;
+
+	pStore->axSamples[pStore->unHead & (SAMPLE_STORE_SIZE - 1)] = *pSample;
+	pStore->unHead++;
+
+	if(pStore->unCount == 0)
+	{
+		pStore->unCount = 1;
+		pStore->nMin = pSample->nRaw;
+		pStore->nMax = pSample->nRaw;
+		pStore->lMean = lValue;
+		pStore->lEwma = lValue;
+		pStore->ullM2 = 0;
+		pStore->unFirstTimestampUs = pSample->unTimestampUs;
+		return;
+	}
+
+	pStore->unCount++;
+	if(pSample->nRaw < pStore->nMin)
+		pStore->nMin = pSample->nRaw;
+	if(pSample->nRaw > pStore->nMax)
+		pStore->nMax = pSample->nRaw;
+
+	lDelta = lValue - pStore->lMean;
+	pStore->lMean += lDelta / (s32)pStore->unCount;
+	pStore->ullM2 += (u64)(((s64)lDelta * (lValue - pStore->lMean)) >> SAMPLE_STORE_STAT_SHIFT);
+
+	pStore->lEwma += (lValue - pStore->lEwma) >> SAMPLE_STORE_EWMA_SHIFT;
+}
+
+__fast_text void sample_store_add_raw(struct maximSampleStore *pStore, s16 nRaw, u8 uchSensor)
+/**
+* \brief       Append a reading taken now.
+*
+* \param[in]   *pStore      - store
+* \param[in]   nRaw         - temperature in 1/16 degC
+* \param[in]   uchSensor    - index of the sensor that produced it
+*
+* \retval      None
+*/
+{
+	struct maximSample xSample;
+
+	xSample.unTimestampUs = get_time_us();
+	xSample.nRaw = nRaw;
+	xSample.uchSensor = uchSensor;
+	xSample.uchFlags = 0;
+	sample_store_add(pStore, &xSample);
+}
+
+u32 sample_store_count(const struct maximSampleStore *pStore)
+/**
+* \brief       Number of samples held in the history (at most SAMPLE_STORE_SIZE).
+*
+* \retval      Sample count
+*/
+{
+	return((pStore->unHead < SAMPLE_STORE_SIZE) ? pStore->unHead : SAMPLE_STORE_SIZE);
+}
+
+int sample_store_get(const struct maximSampleStore *pStore, u32 unAge, struct maximSample *pSample)
+/**
+* \brief       Read a sample from the history.
+*
+* \param[in]   *pStore      - store
+* \param[in]   unAge        - 0 for the latest sample, 1 for the one before, ...
+* \param[out]  *pSample     - the sample is copied here
+*
+* \retval      TRUE if the sample is still in the history, FALSE otherwise
+*/
+{
+	if(unAge >= sample_store_count(pStore))
+		return(FALSE);
+	*pSample = pStore->axSamples[(pStore->unHead - 1 - unAge) & (SAMPLE_STORE_SIZE - 1)];
+	return(TRUE);
+}
+
+void sample_store_stats(const struct maximSampleStore *pStore, struct maximSampleStats *pStats)
+/**
+* \brief       Summary of every sample added since sample_store_init().
+* \par         Details
+*              Constant time: only the standard deviation is computed here, from the running sum
+*              of squares.  All fields are 0 while the store is empty.
+*
+* \param[in]   *pStore      - store
+* \param[out]  *pStats      - summary
+*
+* \retval      None
+*/
+{
+	u64 ullVariance = 0;
+
+	pStats->unCount = pStore->unCount;
+	pStats->nMin = pStore->nMin;
+	pStats->nMax = pStore->nMax;
+	pStats->nMean = SAMPLE_STORE_ROUND(pStore->lMean);
+	pStats->nEwma = SAMPLE_STORE_ROUND(pStore->lEwma);
+	pStats->unFirstTimestampUs = pStore->unFirstTimestampUs;
+	if(pStore->unCount == 0)
+	{
+		pStats->nLatest = 0;
+		pStats->unLastTimestampUs = 0;
+	}
+	else
+	{
+		pStats->nLatest = pStore->axSamples[(pStore->unHead - 1) & (SAMPLE_STORE_SIZE - 1)].nRaw;
+		pStats->unLastTimestampUs = pStore->axSamples[(pStore->unHead - 1) & (SAMPLE_STORE_SIZE - 1)].unTimestampUs;
+	}
+
+	if(pStore->unCount > 1)
+		ullVariance = pStore->ullM2 / (pStore->unCount - 1);
+	pStats->unVariance = (u32)((ullVariance + (1UL << (SAMPLE_STORE_STAT_SHIFT - 1))) >> SAMPLE_STORE_STAT_SHIFT);
+	// sqrt of (1/16 degC)^2 << 16 is 1/16 degC << 8
+	pStats->nStdDev = (s16)((sample_store_isqrt(ullVariance) + (1UL << 7)) >> 8);
+}
+
+void sample_store_print(const struct maximSampleStore *pStore, int displayCelsius)
+/**
+* \brief       Print the summary for the menu.
+*
+* \param[in]   *pStore          - store
+* \param[in]   displayCelsius   - true = degrees C, false = degrees F
+*
+* \retval      None
+*/
+{
+	struct maximSampleStats xStats;
+	char sText[Q4_MAX_TEXT];
+	s32 nStdDev;
+
+	sample_store_stats(pStore, &xStats);
+	printf("Samples = %lu over %lu s\r\n", (unsigned long)xStats.unCount,
+			(unsigned long)((xStats.unLastTimestampUs - xStats.unFirstTimestampUs) / 1000000));
+	if(xStats.unCount == 0)
+		return;
+	printf("Min = ");
+	printf_temp_q4(xStats.nMin, displayCelsius, TRUE);
+	printf("Max = ");
+	printf_temp_q4(xStats.nMax, displayCelsius, TRUE);
+	printf("Mean = ");
+	printf_temp_q4(xStats.nMean, displayCelsius, TRUE);
+	printf("EWMA = ");
+	printf_temp_q4(xStats.nEwma, displayCelsius, TRUE);
+
+	// A spread converts to Fahrenheit without the 32 degree offset
+	nStdDev = displayCelsius ? xStats.nStdDev : q4_celsius_to_fahrenheit(xStats.nStdDev) - Q4_FROM_INT(32);
+	q4_format(sText, nStdDev, 2);
+	printf("Std dev = %s deg %c\r\n", sText, displayCelsius ? 'C' : 'F');
+}
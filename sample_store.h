@@ -0,0 +1,86 @@
+/** \file sample_store.h *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sample_store.h
+ *         Description: Fixed size history of timestamped temperature samples
+ *                      with running statistics (min, max, mean, EWMA and
+ *                      variance) updated on every insert, so summaries are
+ *                      read in constant time.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SAMPLE_STORE_H_
+#define SAMPLE_STORE_H_
+
+#include "xbasic_types.h"
+#include "sample_ring.h"
+
+#ifndef SAMPLE_STORE_SIZE
+#define SAMPLE_STORE_SIZE 128           //!< Samples kept in the history.  Must be a power of two.
+#endif
+#ifndef SAMPLE_STORE_EWMA_SHIFT
+#define SAMPLE_STORE_EWMA_SHIFT 3       //!< EWMA weight of a new sample is 1 / 2^SHIFT
+#endif
+
+/*
+ * The history keeps the last SAMPLE_STORE_SIZE samples and overwrites the oldest one.  The
+ * statistics cover every sample added since sample_store_init(), not just the ones still in the
+ * history.  Mean, EWMA and the Welford sum of squares are kept in 1/2^20 degC (the 1/16 degC
+ * sample shifted left by SAMPLE_STORE_STAT_SHIFT) so the running division by the sample count
+ * does not lose the sensor resolution;  all arithmetic is integer.
+ *
+ * One writer only.  A reader on the same CPU (menu, OLED, command interface) needs no locking.
+ */
+#define SAMPLE_STORE_STAT_SHIFT 16      //!< Fraction bits added below 1/16 degC in the running values
+
+struct maximSampleStats                 //!< Snapshot returned by sample_store_stats()
+{
+	u32 unCount;                        //!< samples added since sample_store_init()
+	s16 nLatest;                        //!< 1/16 degC, as are all temperatures below
+	s16 nMin;
+	s16 nMax;
+	s16 nMean;
+	s16 nEwma;
+	s16 nStdDev;                        //!< sample standard deviation, 0 with fewer than two samples
+	u32 unVariance;                     //!< sample variance in (1/16 degC)^2
+	u32 unFirstTimestampUs;             //!< timestamp of the first sample
+	u32 unLastTimestampUs;              //!< timestamp of the latest sample
+};
+
+struct maximSampleStore
+{
+	u32 unHead;                         //!< samples written to axSamples (wraps)
+	u32 unCount;                        //!< samples added since sample_store_init()
+	s16 nMin;
+	s16 nMax;
+	s32 lMean;                          //!< running mean, 1/16 degC << SAMPLE_STORE_STAT_SHIFT
+	s32 lEwma;                          //!< 1/16 degC << SAMPLE_STORE_STAT_SHIFT
+	u64 ullM2;                          //!< Welford sum of squared deviations, (1/16 degC)^2 << SAMPLE_STORE_STAT_SHIFT
+	u32 unFirstTimestampUs;
+	struct maximSample axSamples[SAMPLE_STORE_SIZE];
+};
+
+void sample_store_init(struct maximSampleStore *pStore);
+void sample_store_add(struct maximSampleStore *pStore, const struct maximSample *pSample);
+void sample_store_add_raw(struct maximSampleStore *pStore, s16 nRaw, u8 uchSensor);
+u32 sample_store_count(const struct maximSampleStore *pStore);
+int sample_store_get(const struct maximSampleStore *pStore, u32 unAge, struct maximSample *pSample);
+void sample_store_stats(const struct maximSampleStore *pStore, struct maximSampleStats *pStats);
+void sample_store_print(const struct maximSampleStore *pStore, int displayCelsius);
+
+#endif /* SAMPLE_STORE_H_ */
@@ -0,0 +1,167 @@
+/** \file sensor_array.c *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sensor_array.c
+ *         Description: Several MAX31723s on separate slave select lines,
+ *                      read in one scan.  Every sensor is given a one-shot
+ *                      conversion at the same time and the results are read
+ *                      back to back once the conversion time has passed.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "spi_utilities.h"
+#include "spi_backend.h"
+#include "max31723_utilities.h"
+#include "sensor_array.h"
+
+
+int sensor_array_init(struct maximSensorArray *pArray, const struct maximSensorArrayEntry *axEntries, int nSensors,
+		u8 uchResolution)
+/**
+* \brief       Configure every sensor of the array in one pass.
+* \par         Details
+*              The active high select of each sensor is declared to its controller before any
+*              sensor is addressed, so no transfer selects two of them.  Each part is then shut
+*              down at the scan resolution, ready for sensor_array_trigger().
+*
+* \param[out]  *pArray      - array instance
+* \param[in]   axEntries    - (controller, slave select) of each sensor;  must outlive the array
+* \param[in]   nSensors     - entries in axEntries, 1 to SENSOR_ARRAY_MAX
+* \param[in]   uchResolution - MAX31723_CONFIG_RESOLUTION_...
+*
+* \retval      FALSE if nSensors is out of range
+*/
+{
+	int i;
+
+	memset(pArray, 0, sizeof(*pArray));
+	if(nSensors < 1 || nSensors > SENSOR_ARRAY_MAX)
+		return(FALSE);
+	pArray->axEntries = axEntries;
+	pArray->nSensors = nSensors;
+	pArray->uchResolution = uchResolution & MAX31723_CONFIG_RESOLUTION_MASK;
+	pArray->unConversionUs = max_MAX31723_conversion_time_ms(pArray->uchResolution) * 1000;
+
+	for(i=0;i<nSensors;i++)
+		spi_set_slave_polarity(axEntries[i].unPeripheralAddressSPI, axEntries[i].uchSlave, TRUE);
+	for(i=0;i<nSensors;i++)
+		max_MAX31723_configure_slave(axEntries[i].unPeripheralAddressSPI, axEntries[i].uchSlave,
+				pArray->uchResolution | MAX31723_CONFIG_SHUTDOWN);
+	return(TRUE);
+}
+
+void sensor_array_trigger(struct maximSensorArray *pArray)
+/**
+* \brief       Start a one-shot conversion on every sensor.  Returns once the writes are done.
+* \par         Details
+*              The configuration writes run concurrently across controllers.
+*
+* \retval      None
+*/
+{
+	struct spiTransfer axTransfers[SENSOR_ARRAY_MAX];
+	u8 auchCommand[4] = { 0 };
+	int i;
+
+	auchCommand[0] = MAX31723_CONFIG_WRITE;
+	auchCommand[1] = pArray->uchResolution | MAX31723_CONFIG_SHUTDOWN | MAX31723_CONFIG_ONE_SHOT;
+	for(i=0;i<pArray->nSensors;i++)
+		spi_transfer_setup(&axTransfers[i], pArray->axEntries[i].unPeripheralAddressSPI, pArray->axEntries[i].uchSlave,
+				1, 0, auchCommand, NULL,
+				SPI_ALIGN_BYTES(2, spi_word_bytes(pArray->axEntries[i].unPeripheralAddressSPI)), TRUE);
+	spi_transfer_run_all(axTransfers, pArray->nSensors);
+	// The conversions started one write apart;  the last one started last
+	pArray->unTriggerTimeUs = get_time_us();
+	pArray->uchState = SENSOR_SCAN_CONVERTING;
+}
+
+int sensor_array_poll(struct maximSensorArray *pArray)
+/**
+* \brief       Read the array once its conversions have finished.  Never waits for a conversion.
+* \par         Details
+*              The reads run concurrently across controllers and in table order on each one.  All
+*              readings of a scan carry the time the reads completed.
+*
+* \param[in]   *pArray      - array instance
+*
+* \retval      TRUE when axReadings holds a new scan
+*/
+{
+	static const u8 auchCommand[4] = { MAX31723_TEMP_READ, 0x00, 0x00, 0x00 };
+	struct spiTransfer axTransfers[SENSOR_ARRAY_MAX];
+	u8 aauchRead[SENSOR_ARRAY_MAX][4];
+	struct maximSample *pReading;
+	u32 unNow;
+	int i;
+
+	if(pArray->uchState != SENSOR_SCAN_CONVERTING)
+		return(FALSE);
+	if(get_time_us() - pArray->unTriggerTimeUs < pArray->unConversionUs)
+		return(FALSE);
+
+	for(i=0;i<pArray->nSensors;i++)
+		spi_transfer_setup(&axTransfers[i], pArray->axEntries[i].unPeripheralAddressSPI, pArray->axEntries[i].uchSlave,
+				1, 0, auchCommand, aauchRead[i],
+				SPI_ALIGN_BYTES(3, spi_word_bytes(pArray->axEntries[i].unPeripheralAddressSPI)), TRUE);
+	spi_transfer_run_all(axTransfers, pArray->nSensors);
+	unNow = get_time_us();
+
+	for(i=0;i<pArray->nSensors;i++)
+	{
+		pReading = &pArray->axReadings[i];
+		pReading->nRaw = max_MAX31723_decode_raw(aauchRead[i]);
+		pReading->unTimestampUs = unNow;
+		pReading->uchSensor = (u8)i;
+		pReading->uchFlags = 0;
+	}
+	pArray->unLastScanUs = unNow - pArray->unTriggerTimeUs;
+	pArray->unScanCount++;
+	pArray->uchState = SENSOR_SCAN_DONE;
+	return(TRUE);
+}
+
+int sensor_array_scan(struct maximSensorArray *pArray)
+/**
+* \brief       Trigger and read the whole array, waiting out one conversion time.
+*
+* \retval      Number of readings in axReadings
+*/
+{
+	sensor_array_trigger(pArray);
+	while(!sensor_array_poll(pArray))
+		;
+	return(pArray->nSensors);
+}
+
+void sensor_array_stop(struct maximSensorArray *pArray, u8 uchConfiguration)
+/**
+* \brief       Write one configuration to every sensor, e.g. to return them to continuous mode.
+*
+* \retval      None
+*/
+{
+	int i;
+
+	for(i=0;i<pArray->nSensors;i++)
+		max_MAX31723_configure_slave(pArray->axEntries[i].unPeripheralAddressSPI, pArray->axEntries[i].uchSlave,
+				uchConfiguration);
+	pArray->uchState = SENSOR_SCAN_IDLE;
+}
@@ -0,0 +1,79 @@
+/** \file sensor_array.h *****************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: sensor_array.h
+ *         Description: Several MAX31723s on separate slave select lines,
+ *                      read in one scan.  Every sensor is given a one-shot
+ *                      conversion at the same time and the results are read
+ *                      back to back once the conversion time has passed.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SENSOR_ARRAY_H_
+#define SENSOR_ARRAY_H_
+
+#include "xbasic_types.h"
+#include "sample_ring.h"
+
+#define SENSOR_ARRAY_MAX 8              //!< Most sensors in one array
+
+#define SENSOR_SCAN_IDLE 0              //!< no scan started, or the last one has been collected
+#define SENSOR_SCAN_CONVERTING 1        //!< one-shot conversions running
+#define SENSOR_SCAN_DONE 2              //!< axReadings hold the results of the last scan
+
+/*
+ * A scan costs one conversion time plus one 3 byte transfer per sensor (4 on a 16 or 32 bit core),
+ * whatever the number of sensors:  sensor_array_trigger() starts a one-shot conversion on each part
+ * (one 2 or 4 byte write each) and sensor_array_poll() reads them all once the slowest can have finished.  Between scans
+ * the parts stay shut down.
+ *
+ * Transfers go through spi_transfer_run_all() (see spi_backend.h), so sensors on different
+ * controllers are written and read at the same time and only the transfers on the busiest
+ * controller add up.  Each controller's other select lines stay at their idle level:
+ * sensor_array_init() declares every sensor active high with spi_set_slave_polarity(), and the
+ * max_MAX31723_...() functions that take no slave (slave 0, through the fixed SPI profile) deselect
+ * with the same controller state, so they never select an array sensor as well.
+ */
+
+struct maximSensorArrayEntry            //!< Where one sensor of the array is connected
+{
+	u32 unPeripheralAddressSPI;
+	u8 uchSlave;                        //!< slave select line, 0-31
+};
+
+struct maximSensorArray
+{
+	const struct maximSensorArrayEntry *axEntries;
+	int nSensors;
+	u8 uchResolution;                   //!< MAX31723_CONFIG_RESOLUTION_... of the one-shot conversions
+	u8 uchState;                        //!< SENSOR_SCAN_...
+	u32 unConversionUs;                 //!< conversion time at uchResolution
+	u32 unTriggerTimeUs;                //!< get_time_us() when the conversions were started
+	u32 unScanCount;
+	u32 unLastScanUs;                   //!< trigger to last reading, of the last scan
+	struct maximSample axReadings[SENSOR_ARRAY_MAX];    //!< uchSensor is the index in axEntries
+};
+
+int sensor_array_init(struct maximSensorArray *pArray, const struct maximSensorArrayEntry *axEntries, int nSensors,
+		u8 uchResolution);
+void sensor_array_trigger(struct maximSensorArray *pArray);
+int sensor_array_poll(struct maximSensorArray *pArray);
+int sensor_array_scan(struct maximSensorArray *pArray);
+void sensor_array_stop(struct maximSensorArray *pArray, u8 uchConfiguration);
+
+#endif /* SENSOR_ARRAY_H_ */
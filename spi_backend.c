@@ -0,0 +1,647 @@
+/** \file spi_backend.c ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: spi_backend.c
+ *         Description: Controller backends behind the SPI API.  A transfer is
+ *                      started on a controller and then completed by polling
+ *                      or from the controller's interrupt, so transfers on
+ *                      different controllers (AXI Quad SPI, PS SPI0, PS SPI1)
+ *                      shift at the same time.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "spi_utilities.h"
+#include "spi_backend.h"
+#include "spi_capture.h"
+#include "log_utilities.h"
+#include "interrupt_utilities.h"
+#include "memory_sections.h"
+
+// AXI Quad SPI bits (the register offsets are in spi_utilities.h)
+#define SPI_AXI_CR_INHIBIT 0x00000100
+#define SPI_AXI_CR_FIFO_RESET 0x00000060
+#define SPI_AXI_SR_TX_EMPTY 0x00000004
+#define SPI_AXI_DGIER_GIE 0x80000000
+#define SPI_AXI_IRQ_DTR_EMPTY 0x00000004
+
+// PS SPI (Cadence) register map, see the Zynq TRM appendix B.30
+#define SPI_PS_CR_OFFSET 0x00
+#define SPI_PS_SR_OFFSET 0x04
+#define SPI_PS_IER_OFFSET 0x08
+#define SPI_PS_IDR_OFFSET 0x0C
+#define SPI_PS_ER_OFFSET 0x14
+#define SPI_PS_TXD_OFFSET 0x1C
+#define SPI_PS_RXD_OFFSET 0x20
+#define SPI_PS_RX_THRES_OFFSET 0x2C
+
+#define SPI_PS_CR_MASTER 0x00000001
+#define SPI_PS_CR_CPOL 0x00000002
+#define SPI_PS_CR_CPHA 0x00000004
+#define SPI_PS_CR_BAUD_SHIFT 3
+#define SPI_PS_CR_CS_SHIFT 10
+#define SPI_PS_CR_CS_NONE 0x00003C00    //!< every select line high
+#define SPI_PS_CR_MANUAL_CS 0x00004000
+#define SPI_PS_SR_RX_NOT_EMPTY 0x00000010   //!< Rx FIFO holds at least RX_THRES bytes
+#define SPI_PS_SR_STICKY 0x00000043     //!< RX_OVERFLOW, MODE_FAIL, TX_UNDERFLOW:  write 1 to clear
+#define SPI_PS_IRQ_ALL 0x0000007F
+
+#if defined(__arm__)
+#define SPI_BACKEND_WAIT() __asm__ __volatile__("wfi" ::: "memory")    //!< Sleep until the next interrupt
+#else
+#define SPI_BACKEND_WAIT() __asm__ __volatile__("" ::: "memory")
+#endif
+
+struct spiBackendController             //!< Interrupt state of one controller
+{
+	u32 unPeripheralAddressSPI;         //!< 0 marks an unused entry
+	u8 uchInterrupt;                    //!< TRUE once spi_backend_attach_interrupt() connected it
+	struct spiTransfer * volatile pActive;  //!< transfer the ISR steps
+};
+
+__fast_bss static struct spiBackendController g_axSpiBackendControllers[SPI_MAX_CONTROLLERS];
+
+
+// ---------------------------------------------------------------------------------------- //
+// Segment walk shared by the backends
+// ---------------------------------------------------------------------------------------- //
+
+__fast_text static u8 spi_transfer_tx_byte(struct spiTransfer *pTransfer)
+/**
+* \brief       Next byte to queue.
+*/
+{
+	const struct spiSegment *pSegment;
+	u8 uchByte;
+
+	pTransfer->nSent++;
+	while(pTransfer->nTxSegment < pTransfer->nSegments &&
+			pTransfer->nTxOffset >= pTransfer->axSegments[pTransfer->nTxSegment].nNumBytes)
+	{
+		pTransfer->nTxSegment++;
+		pTransfer->nTxOffset = 0;
+	}
+	if(pTransfer->nTxSegment >= pTransfer->nSegments)
+		return(0x00);
+	pSegment = &pTransfer->axSegments[pTransfer->nTxSegment];
+	uchByte = ((pSegment->uchFlags & SPI_SEG_ZERO_TX) || pSegment->auchWriteBuf == NULL) ? 0x00 :
+			pSegment->auchWriteBuf[pTransfer->nTxOffset];
+	pTransfer->nTxOffset++;
+	return(uchByte);
+}
+
+__fast_text static void spi_transfer_rx_byte(struct spiTransfer *pTransfer, u8 uchByte)
+/**
+* \brief       Store a received byte.
+*/
+{
+	const struct spiSegment *pSegment;
+
+	pTransfer->nReceived++;
+	while(pTransfer->nRxSegment < pTransfer->nSegments &&
+			pTransfer->nRxOffset >= pTransfer->axSegments[pTransfer->nRxSegment].nNumBytes)
+	{
+		pTransfer->nRxSegment++;
+		pTransfer->nRxOffset = 0;
+	}
+	if(pTransfer->nRxSegment >= pTransfer->nSegments)
+		return;
+	pSegment = &pTransfer->axSegments[pTransfer->nRxSegment];
+	if(!(pSegment->uchFlags & SPI_SEG_DISCARD_RX) && pSegment->auchReadBuf != NULL)
+		pSegment->auchReadBuf[pTransfer->nRxOffset] = uchByte;
+#if LOG_SPI_BYTES
+	LOG2(LOG_ID_SPI_BYTE, ((pSegment->uchFlags & SPI_SEG_ZERO_TX) || pSegment->auchWriteBuf == NULL) ? 0x00 :
+			pSegment->auchWriteBuf[pTransfer->nRxOffset], uchByte);
+#endif
+	pTransfer->nRxOffset++;
+}
+
+
+// ---------------------------------------------------------------------------------------- //
+// AXI Quad SPI:  select, then one FIFO burst per step
+// ---------------------------------------------------------------------------------------- //
+
+__fast_text static u32 spi_axi_control(const struct spiTransfer *pTransfer)
+{
+	return(0x00000186 | ((u32)pTransfer->uchCPHA << 4) | ((u32)pTransfer->uchCPOL << 3));
+}
+
+__fast_text static void spi_axi_queue_burst(struct spiTransfer *pTransfer, int nWordBytes)
+/**
+* \brief       Queue up to SPI_FIFO_DEPTH words, MSB first, and release them.
+*/
+{
+	u32 unAddress = pTransfer->unPeripheralAddressSPI;
+	u32 unWord;
+	int i, k;
+
+	pTransfer->nBurst = (pTransfer->nNumBytes - pTransfer->nSent + nWordBytes - 1) / nWordBytes;
+	if(pTransfer->nBurst > SPI_FIFO_DEPTH)
+		pTransfer->nBurst = SPI_FIFO_DEPTH;
+	for(i=0;i<pTransfer->nBurst;i++)
+	{
+		unWord = 0;
+		for(k=0;k<nWordBytes;k++)
+			unWord = (unWord << 8) | spi_transfer_tx_byte(pTransfer);
+		XSpi_WriteReg(unAddress, XSP_DTR_OFFSET, unWord);
+	}
+	XSpi_WriteReg(unAddress, XSP_CR_OFFSET, spi_axi_control(pTransfer) & ~SPI_AXI_CR_INHIBIT);
+}
+
+__fast_text static void spi_axi_start(struct spiTransfer *pTransfer)
+{
+	u32 unAddress = pTransfer->unPeripheralAddressSPI;
+	struct spiController *pController = spi_controller(unAddress);
+
+	if(pTransfer->uchCsActiveHigh)
+		pController->unIdleSelect &= ~(1UL << pTransfer->nSlave);
+	else
+		pController->unIdleSelect |= (1UL << pTransfer->nSlave);
+
+	XSpi_WriteReg(unAddress, XSP_CR_OFFSET, spi_axi_control(pTransfer) | SPI_AXI_CR_FIFO_RESET);
+	XSpi_WriteReg(unAddress, XSP_SSR_OFFSET, pController->unIdleSelect);
+	XSpi_WriteReg(unAddress, XSP_SSR_OFFSET, pController->unIdleSelect ^ (1UL << pTransfer->nSlave));
+	spi_axi_queue_burst(pTransfer, pController->uchWordBytes);
+}
+
+__fast_text static int spi_axi_service(struct spiTransfer *pTransfer)
+{
+	u32 unAddress = pTransfer->unPeripheralAddressSPI;
+	struct spiController *pController;
+	int nWordBytes, i, k;
+	u32 unWord;
+
+	if(!(XSpi_ReadReg(unAddress, XSP_SR_OFFSET) & SPI_AXI_SR_TX_EMPTY))
+		return(FALSE);
+	pController = spi_controller(unAddress);
+	nWordBytes = pController->uchWordBytes;
+	XSpi_WriteReg(unAddress, XSP_CR_OFFSET, spi_axi_control(pTransfer));
+
+	// Without Rx data to keep the Rx FIFO is left for the next transfer's FIFO reset
+	for(i=0;i<pTransfer->nBurst;i++)
+	{
+		unWord = pTransfer->uchKeepRx ? XSpi_ReadReg(unAddress, XSP_DRR_OFFSET) : 0;
+		for(k=nWordBytes-1;k>=0;k--)
+			spi_transfer_rx_byte(pTransfer, (u8)(unWord >> (8 * k)));
+	}
+	if(pTransfer->nSent < pTransfer->nNumBytes)
+	{
+		spi_axi_queue_burst(pTransfer, nWordBytes);
+		return(FALSE);
+	}
+	XSpi_WriteReg(unAddress, XSP_SSR_OFFSET, pController->unIdleSelect);
+	pTransfer->uchState = SPI_XFER_COMPLETE;
+	return(TRUE);
+}
+
+static void spi_axi_interrupt_enable(u32 unPeripheralAddressSPI, int nEnable)
+{
+	if(nEnable)
+	{
+		XSpi_WriteReg(unPeripheralAddressSPI, XSP_IIER_OFFSET, SPI_AXI_IRQ_DTR_EMPTY);
+		XSpi_WriteReg(unPeripheralAddressSPI, XSP_DGIER_OFFSET, SPI_AXI_DGIER_GIE);
+	}
+	else
+		XSpi_WriteReg(unPeripheralAddressSPI, XSP_DGIER_OFFSET, 0);
+}
+
+__fast_text static void spi_axi_interrupt_ack(u32 unPeripheralAddressSPI)
+{
+	// IPISR bits toggle on write
+	XSpi_WriteReg(unPeripheralAddressSPI, XSP_IISR_OFFSET, XSpi_ReadReg(unPeripheralAddressSPI, XSP_IISR_OFFSET));
+}
+
+const struct spiBackendOps g_xSpiBackendAxiQspi =
+{
+	"AXI_QSPI",
+	spi_axi_start,
+	spi_axi_service,
+	spi_axi_interrupt_enable,
+	spi_axi_interrupt_ack
+};
+
+
+// ---------------------------------------------------------------------------------------- //
+// PS SPI:  manual select, automatic start, byte wide FIFOs
+// ---------------------------------------------------------------------------------------- //
+#if SPI_BACKEND_PS_PRESENT
+
+__fast_text static u32 spi_ps_control(const struct spiTransfer *pTransfer)
+{
+	return(SPI_PS_CR_MASTER | SPI_PS_CR_MANUAL_CS | (SPI_PS_BAUD_DIV << SPI_PS_CR_BAUD_SHIFT) |
+			(pTransfer->uchCPOL ? SPI_PS_CR_CPOL : 0) | (pTransfer->uchCPHA ? SPI_PS_CR_CPHA : 0));
+}
+
+__fast_text static void spi_ps_queue_burst(struct spiTransfer *pTransfer)
+/**
+* \brief       Queue up to SPI_PS_FIFO_DEPTH bytes;  the controller starts shifting on the first one.
+* \par         Details
+*              The Rx threshold is the burst length, so Rx-not-empty (and its interrupt) only
+*              asserts once the whole burst has been received.
+*/
+{
+	u32 unAddress = pTransfer->unPeripheralAddressSPI;
+	int i;
+
+	pTransfer->nBurst = pTransfer->nNumBytes - pTransfer->nSent;
+	if(pTransfer->nBurst > SPI_PS_FIFO_DEPTH)
+		pTransfer->nBurst = SPI_PS_FIFO_DEPTH;
+	XSpi_WriteReg(unAddress, SPI_PS_RX_THRES_OFFSET, pTransfer->nBurst);
+	for(i=0;i<pTransfer->nBurst;i++)
+		XSpi_WriteReg(unAddress, SPI_PS_TXD_OFFSET, spi_transfer_tx_byte(pTransfer));
+}
+
+__fast_text static void spi_ps_start(struct spiTransfer *pTransfer)
+{
+	u32 unAddress = pTransfer->unPeripheralAddressSPI;
+	u32 unControl = spi_ps_control(pTransfer);
+	int i;
+
+	XSpi_WriteReg(unAddress, SPI_PS_ER_OFFSET, 0);
+	for(i=0;i<SPI_PS_FIFO_DEPTH && (XSpi_ReadReg(unAddress, SPI_PS_SR_OFFSET) & SPI_PS_SR_RX_NOT_EMPTY);i++)
+		XSpi_ReadReg(unAddress, SPI_PS_RXD_OFFSET);
+	XSpi_WriteReg(unAddress, SPI_PS_SR_OFFSET, SPI_PS_SR_STICKY);
+	XSpi_WriteReg(unAddress, SPI_PS_CR_OFFSET, unControl | SPI_PS_CR_CS_NONE);
+	XSpi_WriteReg(unAddress, SPI_PS_CR_OFFSET,
+			unControl | (((~(1UL << pTransfer->nSlave)) & 0xF) << SPI_PS_CR_CS_SHIFT));
+	XSpi_WriteReg(unAddress, SPI_PS_ER_OFFSET, 1);
+	spi_ps_queue_burst(pTransfer);
+}
+
+__fast_text static int spi_ps_service(struct spiTransfer *pTransfer)
+{
+	u32 unAddress = pTransfer->unPeripheralAddressSPI;
+	int i;
+
+	if(!(XSpi_ReadReg(unAddress, SPI_PS_SR_OFFSET) & SPI_PS_SR_RX_NOT_EMPTY))
+		return(FALSE);
+	for(i=0;i<pTransfer->nBurst;i++)
+		spi_transfer_rx_byte(pTransfer, (u8)XSpi_ReadReg(unAddress, SPI_PS_RXD_OFFSET));
+	if(pTransfer->nSent < pTransfer->nNumBytes)
+	{
+		spi_ps_queue_burst(pTransfer);
+		return(FALSE);
+	}
+	XSpi_WriteReg(unAddress, SPI_PS_CR_OFFSET, spi_ps_control(pTransfer) | SPI_PS_CR_CS_NONE);
+	XSpi_WriteReg(unAddress, SPI_PS_ER_OFFSET, 0);
+	pTransfer->uchState = SPI_XFER_COMPLETE;
+	return(TRUE);
+}
+
+static void spi_ps_interrupt_enable(u32 unPeripheralAddressSPI, int nEnable)
+{
+	XSpi_WriteReg(unPeripheralAddressSPI, SPI_PS_IDR_OFFSET, SPI_PS_IRQ_ALL);
+	if(nEnable)
+		XSpi_WriteReg(unPeripheralAddressSPI, SPI_PS_IER_OFFSET, SPI_PS_SR_RX_NOT_EMPTY);
+}
+
+__fast_text static void spi_ps_interrupt_ack(u32 unPeripheralAddressSPI)
+{
+	// Rx-not-empty clears itself when the FIFO is read;  only the sticky error bits need writing
+	XSpi_WriteReg(unPeripheralAddressSPI, SPI_PS_SR_OFFSET, SPI_PS_SR_STICKY);
+}
+
+const struct spiBackendOps g_xSpiBackendPs =
+{
+	"PS_SPI",
+	spi_ps_start,
+	spi_ps_service,
+	spi_ps_interrupt_enable,
+	spi_ps_interrupt_ack
+};
+
+#endif /* SPI_BACKEND_PS_PRESENT */
+
+
+// ---------------------------------------------------------------------------------------- //
+// Scheduling
+// ---------------------------------------------------------------------------------------- //
+
+int spi_backend_is_ps(u32 unPeripheralAddressSPI)
+/**
+* \brief       TRUE for the base address of a PS SPI controller.
+*/
+{
+#ifdef XPAR_XSPIPS_0_BASEADDR
+	if(unPeripheralAddressSPI == XPAR_XSPIPS_0_BASEADDR)
+		return(TRUE);
+#endif
+#ifdef XPAR_XSPIPS_1_BASEADDR
+	if(unPeripheralAddressSPI == XPAR_XSPIPS_1_BASEADDR)
+		return(TRUE);
+#endif
+	return(FALSE);
+}
+
+__fast_text const struct spiBackendOps *spi_backend_for(u32 unPeripheralAddressSPI)
+/**
+* \brief       Backend of a controller, chosen from its base address.
+*
+* \retval      g_xSpiBackendPs for PS SPI0/SPI1, g_xSpiBackendAxiQspi for anything else
+*/
+{
+#if SPI_BACKEND_PS_PRESENT
+	if(spi_backend_is_ps(unPeripheralAddressSPI))
+		return(&g_xSpiBackendPs);
+#endif
+	return(&g_xSpiBackendAxiQspi);
+}
+
+__fast_text static struct spiBackendController *spi_backend_controller(u32 unPeripheralAddressSPI)
+/**
+* \brief       Interrupt state of a controller, or NULL if it has none and the table is full.
+*/
+{
+	int i;
+
+	for(i=0;i<SPI_MAX_CONTROLLERS;i++)
+	{
+		if(g_axSpiBackendControllers[i].unPeripheralAddressSPI == unPeripheralAddressSPI)
+			return(&g_axSpiBackendControllers[i]);
+		if(g_axSpiBackendControllers[i].unPeripheralAddressSPI == 0)
+		{
+			g_axSpiBackendControllers[i].unPeripheralAddressSPI = unPeripheralAddressSPI;
+			return(&g_axSpiBackendControllers[i]);
+		}
+	}
+	return(NULL);
+}
+
+__fast_text static void spi_backend_isr(void *pCallbackRef)
+/**
+* \brief       Step the active transfer of the controller that interrupted.
+*/
+{
+	struct spiBackendController *pEntry = (struct spiBackendController *)pCallbackRef;
+	struct spiTransfer *pTransfer = pEntry->pActive;
+	const struct spiBackendOps *pOps = spi_backend_for(pEntry->unPeripheralAddressSPI);
+
+	pOps->pfnInterruptAck(pEntry->unPeripheralAddressSPI);
+	if(pTransfer == NULL || pTransfer->uchState != SPI_XFER_ACTIVE)
+		return;
+	if(pOps->pfnService(pTransfer))
+	{
+		pOps->pfnInterruptEnable(pEntry->unPeripheralAddressSPI, FALSE);
+		pEntry->pActive = NULL;
+	}
+}
+
+int spi_backend_attach_interrupt(u32 unPeripheralAddressSPI, u32 unInterruptId)
+/**
+* \brief       Step the transfers of a controller from its interrupt rather than by polling.
+* \par         Details
+*              The controller's interrupt output is only enabled while one of its transfers runs
+*              under spi_transfer_run_all();  spi_transfer_run() (SpiRWSlave(), SpiRWv()) and the
+*              fixed profiles keep polling.
+*
+* \param[in]   unPeripheralAddressSPI   - base address of the SPI controller
+* \param[in]   unInterruptId            - its GIC interrupt, e.g. XPAR_XSPIPS_0_INTR or
+*                                         XPAR_FABRIC_AXI_QUAD_SPI_0_IP2INTC_IRPT_INTR
+*
+* \retval      TRUE if connected;  FALSE if the GIC is not ready or the table is full
+*/
+{
+	struct spiBackendController *pEntry = spi_backend_controller(unPeripheralAddressSPI);
+
+	if(pEntry == NULL)
+		return(FALSE);
+	spi_backend_for(unPeripheralAddressSPI)->pfnInterruptEnable(unPeripheralAddressSPI, FALSE);
+	if(interrupt_connect(unInterruptId, (Xil_InterruptHandler)spi_backend_isr, pEntry) != XST_SUCCESS)
+		return(FALSE);
+	pEntry->uchInterrupt = TRUE;
+	return(TRUE);
+}
+
+void spi_transfer_setup(struct spiTransfer *pTransfer, u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA,
+		unsigned int unCPOL, const u8 *auchWriteBuf, u8 *auchReadBuf, int nNumBytes, u8 uchCsActiveHigh)
+/**
+* \brief       Describe a transfer for spi_transfer_run_all().  Arguments as for SpiRWSlave().
+* \par         Details
+*              The buffers are held as the transfer's single segment, inside *pTransfer:  set up
+*              transfers in the table they run from rather than copying them there.
+*
+* \retval      None
+*/
+{
+	struct spiSegment xSegment;
+
+	xSegment.auchWriteBuf = auchWriteBuf;
+	xSegment.auchReadBuf = auchReadBuf;
+	xSegment.nNumBytes = nNumBytes;
+	xSegment.uchFlags = 0;
+	spi_transfer_setupv(pTransfer, unPeripheralAddressSPI, nSlave, unCPHA, unCPOL, &xSegment, 1, uchCsActiveHigh);
+	pTransfer->xSegment = xSegment;
+	pTransfer->axSegments = &pTransfer->xSegment;
+}
+
+__fast_text void spi_transfer_setupv(struct spiTransfer *pTransfer, u32 unPeripheralAddressSPI, int nSlave,
+		unsigned int unCPHA, unsigned int unCPOL, const struct spiSegment *axSegments, int nSegments, u8 uchCsActiveHigh)
+/**
+* \brief       Describe a scatter-gather transfer.  Arguments as for SpiRWv();  axSegments must stay
+*              valid until the transfer is done.
+*
+* \retval      None
+*/
+{
+	int i;
+
+	memset(pTransfer, 0, sizeof(*pTransfer));
+	pTransfer->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	pTransfer->nSlave = nSlave;
+	pTransfer->uchCPHA = (u8)unCPHA;
+	pTransfer->uchCPOL = (u8)unCPOL;
+	pTransfer->uchCsActiveHigh = uchCsActiveHigh;
+	pTransfer->axSegments = axSegments;
+	pTransfer->nSegments = nSegments;
+	for(i=0;i<nSegments;i++)
+	{
+		pTransfer->nNumBytes += axSegments[i].nNumBytes;
+		if(!(axSegments[i].uchFlags & SPI_SEG_DISCARD_RX) && axSegments[i].auchReadBuf != NULL)
+			pTransfer->uchKeepRx = TRUE;
+	}
+	pTransfer->pOps = spi_backend_for(unPeripheralAddressSPI);
+	pTransfer->uchState = SPI_XFER_IDLE;
+}
+
+#if SPI_CAPTURE_ENABLED
+static void spi_transfer_capture(const struct spiTransfer *pTransfer)
+/**
+* \brief       Gather the segments into one SPI capture record.  Discarded Rx bytes are captured as 0x00.
+*/
+{
+	u8 auchWrite[SPI_CAPTURE_MAX_TRANSFER];
+	u8 auchRead[SPI_CAPTURE_MAX_TRANSFER];
+	const struct spiSegment *pSegment;
+	int i, k, nOffset = 0;
+
+	for(i=0;i<pTransfer->nSegments && pTransfer->nNumBytes <= SPI_CAPTURE_MAX_TRANSFER;i++)
+	{
+		pSegment = &pTransfer->axSegments[i];
+		for(k=0;k<pSegment->nNumBytes;k++,nOffset++)
+		{
+			auchWrite[nOffset] = ((pSegment->uchFlags & SPI_SEG_ZERO_TX) || pSegment->auchWriteBuf == NULL) ? 0x00 :
+					pSegment->auchWriteBuf[k];
+			auchRead[nOffset] = ((pSegment->uchFlags & SPI_SEG_DISCARD_RX) || pSegment->auchReadBuf == NULL) ? 0x00 :
+					pSegment->auchReadBuf[k];
+		}
+	}
+	spi_capture_record(pTransfer->unPeripheralAddressSPI, pTransfer->nSlave, pTransfer->uchCPHA, pTransfer->uchCPOL, auchWrite,
+			pTransfer->uchKeepRx ? auchRead : NULL, pTransfer->nNumBytes, pTransfer->uchCsActiveHigh);
+}
+#endif
+
+__fast_text static void spi_transfer_start(struct spiTransfer *pTransfer, int nInterrupt)
+/**
+* \brief       Start a transfer whose controller is free, stepped from the controller's interrupt
+*              if nInterrupt and one is attached.
+*/
+{
+	struct spiBackendController *pEntry = spi_backend_controller(pTransfer->unPeripheralAddressSPI);
+
+	LOG3(LOG_ID_SPI_BEGIN, pTransfer->unPeripheralAddressSPI, pTransfer->nNumBytes, pTransfer->uchCsActiveHigh);
+	// A partial last word would be padded with bytes nobody asked for (see SpiRWv())
+	if(pTransfer->nNumBytes % spi_word_bytes(pTransfer->unPeripheralAddressSPI) != 0)
+	{
+		LOG2(LOG_ID_SPI_UNALIGNED, pTransfer->unPeripheralAddressSPI, pTransfer->nNumBytes);
+		pTransfer->nResult = SPI_ERROR_UNALIGNED;
+		pTransfer->uchState = SPI_XFER_COMPLETE;
+		return;
+	}
+	if(pTransfer->nNumBytes <= 0)
+	{
+		pTransfer->uchState = SPI_XFER_COMPLETE;
+		return;
+	}
+	pTransfer->uchInterrupt = (nInterrupt && pEntry != NULL && pEntry->uchInterrupt);
+	pTransfer->uchState = SPI_XFER_ACTIVE;
+	pTransfer->pOps->pfnStart(pTransfer);
+	if(pTransfer->uchInterrupt)
+	{
+		pEntry->pActive = pTransfer;
+		pTransfer->pOps->pfnInterruptEnable(pTransfer->unPeripheralAddressSPI, TRUE);
+	}
+}
+
+__fast_text static void spi_transfer_finish(struct spiTransfer *pTransfer)
+/**
+* \brief       Log and capture a completed transfer.
+*/
+{
+	LOG0(LOG_ID_SPI_END);
+#if SPI_CAPTURE_ENABLED
+	if(g_xSpiCapture.nArmed && pTransfer->nResult == 0)
+		spi_transfer_capture(pTransfer);
+#endif
+	pTransfer->uchState = SPI_XFER_DONE;
+}
+
+__fast_text static int spi_transfer_controller_free(const struct spiTransfer *axTransfers, int nTransfer)
+/**
+* \brief       TRUE when every earlier transfer on the same controller is done, so transfers on one
+*              controller run in table order.
+*/
+{
+	int i;
+
+	for(i=0;i<nTransfer;i++)
+		if(axTransfers[i].unPeripheralAddressSPI == axTransfers[nTransfer].unPeripheralAddressSPI &&
+				axTransfers[i].uchState != SPI_XFER_DONE)
+			return(FALSE);
+	return(TRUE);
+}
+
+__fast_text int spi_transfer_run_all(struct spiTransfer *axTransfers, int nTransfers)
+/**
+* \brief       Run a set of transfers, concurrently across controllers.
+* \par         Details
+*              Each controller runs its transfers in table order, one at a time;  different
+*              controllers run at the same time.  Polled controllers are stepped in turn;  when
+*              every running transfer is interrupt driven the CPU waits in WFI.  Each transfer is
+*              logged and captured as it completes, as SpiRWSlave() would.
+*
+* \param[in]   axTransfers  - transfers set up with spi_transfer_setup()
+* \param[in]   nTransfers   - entries in axTransfers
+*
+* \retval      nTransfers
+*/
+{
+	struct spiTransfer *pTransfer;
+	int nRemaining = nTransfers;
+	int nSleep;
+	u32 unCpsr;
+	int i;
+
+	while(nRemaining > 0)
+	{
+		nSleep = TRUE;
+		for(i=0;i<nTransfers;i++)
+		{
+			pTransfer = &axTransfers[i];
+			if(pTransfer->uchState == SPI_XFER_IDLE)
+			{
+				if(!spi_transfer_controller_free(axTransfers, i))
+					continue;
+				spi_transfer_start(pTransfer, TRUE);
+				nSleep = FALSE;
+			}
+			if(pTransfer->uchState == SPI_XFER_ACTIVE && !pTransfer->uchInterrupt)
+			{
+				pTransfer->pOps->pfnService(pTransfer);
+				nSleep = FALSE;
+			}
+			if(pTransfer->uchState == SPI_XFER_COMPLETE)
+			{
+				spi_transfer_finish(pTransfer);
+				nRemaining--;
+				nSleep = FALSE;
+			}
+		}
+		if(nSleep)
+		{
+			// An ISR completing a transfer between the scan above and WFI would leave the CPU
+			// asleep;  with IRQs masked it cannot run, and a pending IRQ still ends the WFI
+			unCpsr = interrupt_disable();
+			for(i=0;i<nTransfers && axTransfers[i].uchState != SPI_XFER_COMPLETE;i++)
+				;
+			if(i == nTransfers)
+				SPI_BACKEND_WAIT();
+			interrupt_restore(unCpsr);
+		}
+	}
+	return(nTransfers);
+}
+
+__fast_text void spi_transfer_run(struct spiTransfer *pTransfer)
+/**
+* \brief       Run one transfer to completion, polling its controller.
+* \par         Details
+*              This is the transfer core of SpiRWSlave() and SpiRWv().  It polls even when the
+*              controller has an interrupt attached:  a register access is over before a WFI
+*              wakeup would notice it.
+*
+* \param[in]   *pTransfer   - transfer set up with spi_transfer_setup() or spi_transfer_setupv()
+*
+* \retval      None
+*/
+{
+	spi_transfer_start(pTransfer, FALSE);
+	while(pTransfer->uchState == SPI_XFER_ACTIVE)
+		pTransfer->pOps->pfnService(pTransfer);
+	spi_transfer_finish(pTransfer);
+}
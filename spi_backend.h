@@ -0,0 +1,124 @@
+/** \file spi_backend.h ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: spi_backend.h
+ *         Description: Controller backends behind the SPI API.  A transfer is
+ *                      started on a controller and then completed by polling
+ *                      or from the controller's interrupt, so transfers on
+ *                      different controllers (AXI Quad SPI, PS SPI0, PS SPI1)
+ *                      shift at the same time.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SPI_BACKEND_H_
+#define SPI_BACKEND_H_
+
+#include "xbasic_types.h"
+#include "xparameters.h"
+#include "spi_utilities.h"
+
+// The PS SPI controllers are only known when the hardware platform enables them
+#if defined(XPAR_XSPIPS_0_BASEADDR) || defined(XPAR_XSPIPS_1_BASEADDR)
+#define SPI_BACKEND_PS_PRESENT 1
+#else
+#define SPI_BACKEND_PS_PRESENT 0
+#endif
+
+#ifndef SPI_PS_BAUD_DIV
+#define SPI_PS_BAUD_DIV 5               //!< PS SPI SCLK = SPI ref clock / 2^(DIV+1);  166 MHz / 64 = 2.6 MHz
+#endif
+#ifndef SPI_BACKEND_INTERRUPTS
+#define SPI_BACKEND_INTERRUPTS 0        //!< 1 to let the application step array transfers from the SPI interrupts
+#endif
+#define SPI_PS_FIFO_DEPTH 128           //!< Bytes in each PS SPI FIFO
+#define SPI_PS_MAX_SLAVES 3             //!< Select lines of a PS SPI controller without an external decoder
+
+#define SPI_XFER_IDLE 0                 //!< set up, not started
+#define SPI_XFER_ACTIVE 1               //!< shifting;  the backend owns the controller
+#define SPI_XFER_COMPLETE 2             //!< all bytes moved, select released (set by the backend, possibly in an ISR)
+#define SPI_XFER_DONE 3                 //!< logged and captured by spi_transfer_run_all()
+
+/*
+ * Each backend moves one FIFO load per step:  pfnStart() selects the slave and queues the first
+ * burst, pfnService() returns at once while the burst is still shifting, otherwise empties the
+ * Rx FIFO and queues the next burst.  Nothing waits inside a backend, so spi_transfer_run_all()
+ * keeps one transfer going on every controller at once;  a scan of sensors spread over k
+ * controllers takes about 1/k of the bus time of the same scan on one.
+ *
+ * With spi_backend_attach_interrupt() a controller's steps run from its interrupt instead and the
+ * waiting CPU sleeps in WFI.  Without a faster interrupt source the 1 kHz tick bounds how late a
+ * completed transfer is noticed, so the interrupt only pays for long transfers;  short register
+ * reads are best left polled.
+ *
+ * SpiRWSlave() and SpiRWv() are one polled transfer through the same backends (spi_transfer_run()),
+ * so there is a single implementation of each controller's register sequence.
+ *
+ * PS SPI select lines are active low only.  A slave with an active high select (the MAX31723 CE)
+ * needs an inverter between the PS pin and the part;  uchCsActiveHigh is then ignored.
+ */
+
+struct spiTransfer;
+
+struct spiBackendOps                    //!< Register level implementation of one kind of controller
+{
+	const char *sName;
+	void (*pfnStart)(struct spiTransfer *pTransfer);
+	int (*pfnService)(struct spiTransfer *pTransfer);      //!< TRUE once the transfer is complete
+	void (*pfnInterruptEnable)(u32 unPeripheralAddressSPI, int nEnable);
+	void (*pfnInterruptAck)(u32 unPeripheralAddressSPI);
+};
+
+struct spiTransfer                      //!< One SpiRWv() style transfer, run asynchronously
+{
+	u32 unPeripheralAddressSPI;
+	int nSlave;
+	u8 uchCPHA;
+	u8 uchCPOL;
+	u8 uchCsActiveHigh;
+	u8 uchKeepRx;                       //!< some segment keeps its received bytes
+	const struct spiSegment *axSegments;    //!< wire order;  &xSegment after spi_transfer_setup(), so set up in place
+	int nSegments;
+	struct spiSegment xSegment;
+	int nNumBytes;                      //!< sum of the segment lengths
+	int nSent;                          //!< bytes queued in the Tx FIFO so far
+	int nReceived;                      //!< bytes taken from the Rx FIFO so far
+	int nTxSegment, nTxOffset;          //!< segment position of the next byte to queue
+	int nRxSegment, nRxOffset;          //!< segment position of the next byte received
+	int nBurst;                         //!< words in flight
+	int nResult;                        //!< 0, or SPI_ERROR_UNALIGNED for a transfer that was refused
+	volatile u8 uchState;               //!< SPI_XFER_...
+	u8 uchInterrupt;                    //!< TRUE when the controller's interrupt steps it
+	const struct spiBackendOps *pOps;
+};
+
+extern const struct spiBackendOps g_xSpiBackendAxiQspi;
+#if SPI_BACKEND_PS_PRESENT
+extern const struct spiBackendOps g_xSpiBackendPs;
+#endif
+
+const struct spiBackendOps *spi_backend_for(u32 unPeripheralAddressSPI);
+int spi_backend_is_ps(u32 unPeripheralAddressSPI);
+int spi_backend_attach_interrupt(u32 unPeripheralAddressSPI, u32 unInterruptId);
+void spi_transfer_setup(struct spiTransfer *pTransfer, u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA,
+		unsigned int unCPOL, const u8 *auchWriteBuf, u8 *auchReadBuf, int nNumBytes, u8 uchCsActiveHigh);
+void spi_transfer_setupv(struct spiTransfer *pTransfer, u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA,
+		unsigned int unCPOL, const struct spiSegment *axSegments, int nSegments, u8 uchCsActiveHigh);
+int spi_transfer_run_all(struct spiTransfer *axTransfers, int nTransfers);
+void spi_transfer_run(struct spiTransfer *pTransfer);
+
+#endif /* SPI_BACKEND_H_ */
@@ -0,0 +1,183 @@
+/** \file spi_capture.c ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: spi_capture.c
+ *         Description: SPI transaction capture (see spi_capture.h).
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include "xbasic_types.h"
+#include "delays.h"
+#include "spi_capture.h"
+
+#define SPI_CAPTURE_MASK (SPI_CAPTURE_RING_BYTES - 1)
+#define SPI_CAPTURE_RECORD_BYTES(nLength) \
+	((sizeof(struct maximSpiCaptureHeader) + 2 * (u32)(nLength) + 3) & ~3UL)
+
+struct maximSpiCapture g_xSpiCapture;
+
+
+static void spi_capture_put(u32 unPosition, const u8 *auchData, u32 unCount)
+{
+	u32 i;
+
+	for(i=0;i<unCount;i++)
+		g_xSpiCapture.auchRing[(unPosition + i) & SPI_CAPTURE_MASK] = (auchData != NULL) ? auchData[i] : 0x00;
+}
+
+static void spi_capture_get(u32 unPosition, u8 *auchData, u32 unCount)
+{
+	u32 i;
+
+	for(i=0;i<unCount;i++)
+		auchData[i] = g_xSpiCapture.auchRing[(unPosition + i) & SPI_CAPTURE_MASK];
+}
+
+static void spi_capture_drop_oldest(void)
+{
+	struct maximSpiCaptureHeader xHeader;
+
+	spi_capture_get(g_xSpiCapture.unTail, (u8 *)&xHeader, sizeof(xHeader));
+	g_xSpiCapture.unTail += SPI_CAPTURE_RECORD_BYTES(xHeader.uLength);
+	g_xSpiCapture.unTailSequence++;
+}
+
+void spi_capture_start(void)
+/**
+* \brief       Start capturing.  Transactions already held are kept.
+*
+* \retval      None
+*/
+{
+	g_xSpiCapture.nArmed = TRUE;
+}
+
+void spi_capture_stop(void)
+/**
+* \brief       Stop capturing.  The ring keeps its contents until dumped or cleared.
+*
+* \retval      None
+*/
+{
+	g_xSpiCapture.nArmed = FALSE;
+}
+
+void spi_capture_clear(void)
+/**
+* \brief       Discard every transaction held and reset the lost and skipped counters.
+*
+* \retval      None
+*/
+{
+	g_xSpiCapture.unTail = g_xSpiCapture.unHead;
+	g_xSpiCapture.unTailSequence = g_xSpiCapture.unHeadSequence;
+	g_xSpiCapture.unLost = 0;
+	g_xSpiCapture.unSkipped = 0;
+}
+
+void spi_capture_record(u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA, unsigned int unCPOL,
+		const u8 *auchWriteBuf, const u8 *auchReadBuf, int nNumBytes, u8 uchCsActiveHigh)
+/**
+* \brief       Store one transaction.  Called from SpiRW() through SPI_CAPTURE() while armed.
+* \par         Details
+*              The oldest transactions are overwritten until the new one fits.  NULL buffers are
+*              stored as zeros, as SpiRW() sends zeros for a NULL auchWriteBuf.  Not reentrant:
+*              SPI transfers from an interrupt handler must not overlap one from the main loop
+*              anyway.
+*
+* \param[in]   unPeripheralAddressSPI   - SPI peripheral used
+* \param[in]   nSlave                   - slave select line
+* \param[in]   unCPHA                   - CPHA of the transfer
+* \param[in]   unCPOL                   - CPOL of the transfer
+* \param[in]   *auchWriteBuf            - bytes sent, or NULL
+* \param[in]   *auchReadBuf             - bytes received, or NULL
+* \param[in]   nNumBytes                - transfer length
+* \param[in]   uchCsActiveHigh          - slave select polarity
+*
+* \retval      None
+*/
+{
+	struct maximSpiCaptureHeader xHeader;
+	u32 unRecordBytes;
+
+	if(nNumBytes <= 0 || nNumBytes > SPI_CAPTURE_MAX_TRANSFER)
+	{
+		g_xSpiCapture.unSkipped++;
+		return;
+	}
+	unRecordBytes = SPI_CAPTURE_RECORD_BYTES(nNumBytes);
+	while(g_xSpiCapture.unHead - g_xSpiCapture.unTail + unRecordBytes > SPI_CAPTURE_RING_BYTES)
+	{
+		spi_capture_drop_oldest();
+		g_xSpiCapture.unLost++;
+	}
+
+	xHeader.unTimestamp = (u32)get_time_ticks();
+	xHeader.unPeripheralAddressSPI = unPeripheralAddressSPI;
+	xHeader.uLength = (u16)nNumBytes;
+	xHeader.uchMode = (u8)((unCPHA ? SPI_CAPTURE_MODE_CPHA : 0) | (unCPOL ? SPI_CAPTURE_MODE_CPOL : 0)
+			| (uchCsActiveHigh ? SPI_CAPTURE_MODE_CS_HIGH : 0) | ((auchReadBuf == NULL) ? SPI_CAPTURE_MODE_NO_RX : 0));
+	xHeader.uchSlave = (u8)nSlave;
+
+	spi_capture_put(g_xSpiCapture.unHead, (const u8 *)&xHeader, sizeof(xHeader));
+	spi_capture_put(g_xSpiCapture.unHead + sizeof(xHeader), auchWriteBuf, (u32)nNumBytes);
+	spi_capture_put(g_xSpiCapture.unHead + sizeof(xHeader) + (u32)nNumBytes, auchReadBuf, (u32)nNumBytes);
+	g_xSpiCapture.unHead += unRecordBytes;
+	g_xSpiCapture.unHeadSequence++;
+}
+
+u32 spi_capture_dump(void)
+/**
+* \brief       Print and remove every transaction held, in the format described in spi_capture.h.
+* \par         Details
+*              Capturing is paused while dumping, so the ring cannot be overwritten under the
+*              reader.
+*
+* \retval      Number of transactions printed
+*/
+{
+	struct maximSpiCaptureHeader xHeader;
+	u8 auchBytes[SPI_CAPTURE_MAX_TRANSFER];
+	int nArmed = g_xSpiCapture.nArmed;
+	u32 unSent = 0;
+	u32 i;
+
+	g_xSpiCapture.nArmed = FALSE;
+	while(g_xSpiCapture.unTail != g_xSpiCapture.unHead)
+	{
+		spi_capture_get(g_xSpiCapture.unTail, (u8 *)&xHeader, sizeof(xHeader));
+		printf("CAP %08lx %08lx %08lx %02x %02x %02x ", (unsigned long)g_xSpiCapture.unTailSequence,
+				(unsigned long)xHeader.unTimestamp, (unsigned long)xHeader.unPeripheralAddressSPI,
+				(unsigned int)xHeader.uchSlave, (unsigned int)xHeader.uchMode, (unsigned int)xHeader.uLength);
+		spi_capture_get(g_xSpiCapture.unTail + sizeof(xHeader), auchBytes, xHeader.uLength);
+		for(i=0;i<xHeader.uLength;i++)
+			printf("%02x", (unsigned int)auchBytes[i]);
+		printf(" ");
+		spi_capture_get(g_xSpiCapture.unTail + sizeof(xHeader) + xHeader.uLength, auchBytes, xHeader.uLength);
+		for(i=0;i<xHeader.uLength;i++)
+			printf("%02x", (unsigned int)auchBytes[i]);
+		printf("\r\n");
+		spi_capture_drop_oldest();
+		unSent++;
+	}
+	fflush(stdout);
+	g_xSpiCapture.nArmed = nArmed;
+	return(unSent);
+}
@@ -0,0 +1,95 @@
+/** \file spi_capture.h ******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: spi_capture.h
+ *         Description: SPI transaction capture.  While armed, every SpiRW()
+ *                      call is stored (device, mode, TX and RX bytes, timer
+ *                      timestamp) in a byte ring that overwrites the oldest
+ *                      transactions, so the ring always holds the most recent
+ *                      history.  The dump is read back on the host by
+ *                      bench/replay_host, which feeds the RX bytes through
+ *                      the same driver code.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SPI_CAPTURE_H_
+#define SPI_CAPTURE_H_
+
+#include "xbasic_types.h"
+
+#ifndef SPI_CAPTURE_ENABLED
+#define SPI_CAPTURE_ENABLED 1           //!< 0 compiles the capture hook out of SpiRW()
+#endif
+
+#define SPI_CAPTURE_RING_BYTES 4096     //!< Ring size.  Must be a power of two.
+#define SPI_CAPTURE_MAX_TRANSFER 128    //!< Longer transfers are counted in unSkipped, not stored
+
+#define SPI_CAPTURE_MODE_CPHA 0x01
+#define SPI_CAPTURE_MODE_CPOL 0x02
+#define SPI_CAPTURE_MODE_CS_HIGH 0x04   //!< slave select is active high
+#define SPI_CAPTURE_MODE_NO_RX 0x08     //!< the caller discarded RX; the RX bytes are stored as 00
+
+/*
+ * Dump format (spi_capture_dump()), oldest transaction first, all fields hex:
+ *
+ *   CAP <sequence> <timestamp> <SPI base address> <slave> <mode> <length> <TX bytes> <RX bytes>
+ *
+ * e.g. "CAP 00000003 1f2e3d4c 41e00000 00 05 03 010000 00103f".  Gaps in the sequence numbers are
+ * transactions that were overwritten.  The timestamp is the low 32 bits of the global timer.  The
+ * controller (SPI base address) and slave select line tell the devices on a capture apart.
+ */
+
+struct maximSpiCaptureHeader            //!< Stored in front of the TX and RX bytes of each transaction (12 bytes)
+{
+	u32 unTimestamp;
+	u32 unPeripheralAddressSPI;
+	u16 uLength;
+	u8 uchMode;                         //!< SPI_CAPTURE_MODE_... bits
+	u8 uchSlave;                        //!< slave select line of the controller
+};
+
+struct maximSpiCapture
+{
+	int nArmed;
+	u32 unHead;                         //!< bytes ever written (header, TX, RX, padded to 4)
+	u32 unTail;                         //!< bytes ever dumped or overwritten
+	u32 unHeadSequence;                 //!< sequence number of the next transaction stored
+	u32 unTailSequence;                 //!< sequence number of the oldest transaction held
+	u32 unLost;                         //!< transactions overwritten before they were dumped
+	u32 unSkipped;                      //!< transactions longer than SPI_CAPTURE_MAX_TRANSFER
+	u8 auchRing[SPI_CAPTURE_RING_BYTES];
+};
+
+extern struct maximSpiCapture g_xSpiCapture;
+
+#if SPI_CAPTURE_ENABLED
+#define SPI_CAPTURE(unAddress, nSlave, unCPHA, unCPOL, auchTx, auchRx, nLength, uchCsActiveHigh) \
+	do { if(g_xSpiCapture.nArmed) spi_capture_record((unAddress), (nSlave), (unCPHA), (unCPOL), (auchTx), (auchRx), \
+			(nLength), (uchCsActiveHigh)); } while(0)
+#else
+#define SPI_CAPTURE(unAddress, nSlave, unCPHA, unCPOL, auchTx, auchRx, nLength, uchCsActiveHigh) do { } while(0)
+#endif
+
+void spi_capture_start(void);
+void spi_capture_stop(void);
+void spi_capture_clear(void);
+void spi_capture_record(u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA, unsigned int unCPOL,
+		const u8 *auchWriteBuf, const u8 *auchReadBuf, int nNumBytes, u8 uchCsActiveHigh);
+u32 spi_capture_dump(void);
+
+#endif /* SPI_CAPTURE_H_ */
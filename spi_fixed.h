@@ -0,0 +1,196 @@
+/** \file spi_fixed.h ********************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: spi_fixed.h
+ *         Description: Compile-time specialized SPI transfers for devices
+ *                      whose mode, select line and select polarity never
+ *                      change.  SPI_FIXED_DEVICE() generates inline transfer
+ *                      functions for one device profile; the control word,
+ *                      the select bit and the word packing are folded to
+ *                      constants, and the buffer checks SpiRW() makes per
+ *                      byte disappear.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef SPI_FIXED_H_
+#define SPI_FIXED_H_
+
+#include "xbasic_types.h"
+#include "xparameters.h"
+#include "spi_utilities.h"
+#include "spi_backend.h"
+#include "log_utilities.h"
+#include "profile_utilities.h"
+#include "spi_capture.h"
+
+/*
+ * Usage, in a driver header:
+ *
+ *   SPI_FIXED_DEVICE(max31723_spi, 0, 1, 0, 1)    // slave 0, CPHA=1, CPOL=0, active high CE
+ *
+ * defines
+ *
+ *   int max31723_spi_rw(u32 unPeripheralAddressSPI, const u8 *auchWriteBuf, u8 *auchReadBuf, int nNumBytes);
+ *   int max31723_spi_write(u32 unPeripheralAddressSPI, const u8 *auchWriteBuf, int nNumBytes);
+ *   int max31723_spi_read(u32 unPeripheralAddressSPI, u8 *auchReadBuf, int nNumBytes);
+ *
+ * which move the same bytes on the wire as SpiRWSlave() with those arguments.  Both buffers of
+ * _rw() must be valid; _write() leaves the Rx data in the FIFO and _read() sends zeros.  Like
+ * SpiRWSlave() they refuse a length that is not a multiple of SPI_FIXED_WORD_BYTES;  size frames
+ * with SPI_ALIGN_BYTES(n, SPI_FIXED_WORD_BYTES).
+ *
+ * The other select lines of the controller stay at the idle levels declared with
+ * spi_set_slave_polarity(), as with SpiRWSlave(), so only the profile's slave is ever asserted;  the
+ * profile declares its own polarity on every transfer.  A PS SPI controller has no AXI registers to
+ * specialize for, so on one the functions hand the transfer to SpiRWSlave(), which picks the PS
+ * backend (see spi_backend.h).  The transfer width is fixed at SPI_FIXED_WORD_BYTES;
+ * spi_set_transfer_width() does not affect these functions.  Per byte LOG records are not written
+ * (the SPI capture still records every transaction).
+ */
+
+#ifndef SPI_FIXED_WORD_BYTES
+#ifdef XPAR_AXI_QUAD_SPI_0_NUM_TRANSFER_BITS
+#define SPI_FIXED_WORD_BYTES (XPAR_AXI_QUAD_SPI_0_NUM_TRANSFER_BITS / 8)   //!< Transfer width the core was built with
+#else
+#define SPI_FIXED_WORD_BYTES 1
+#endif
+#endif
+
+#define SPI_FIXED_CONTROL(unCPHA, unCPOL) (0x00000186 | ((unCPHA) << 4) | ((unCPOL) << 3))  //!< SPICR, inhibited
+
+#define SPI_FIXED_INLINE static inline __attribute__((always_inline))
+
+
+SPI_FIXED_INLINE u32 spi_fixed_pack(const u8 *auchWriteBuf, const int nWordBytes)
+/**
+* \brief       Next Tx word, MSB first.
+*/
+{
+	u32 unWord = 0;
+	int k;
+
+	for(k=0;k<nWordBytes;k++)
+		unWord = (unWord << 8) | auchWriteBuf[k];
+	return(unWord);
+}
+
+SPI_FIXED_INLINE void spi_fixed_unpack(u8 *auchReadBuf, u32 unWord, const int nWordBytes)
+/**
+* \brief       Store the bytes of an Rx word.
+*/
+{
+	int k;
+
+	for(k=0;k<nWordBytes;k++)
+		auchReadBuf[k] = (u8)(unWord >> (8 * (nWordBytes - 1 - k)));
+}
+
+SPI_FIXED_INLINE int spi_fixed_transfer(u32 unPeripheralAddressSPI, const int nSlave, const unsigned int unCPHA,
+		const unsigned int unCPOL, const u8 uchCsActiveHigh, const int nWordBytes, const int nHasTx,
+		const int nHasRx, const u8 *auchWriteBuf, u8 *auchReadBuf, int nNumBytes)
+/**
+* \brief       Body of the SPI_FIXED_DEVICE() functions.  Every argument but the address, the
+*              buffers and the length is a constant at the call site;  nHasTx and nHasRx say
+*              which buffers are used, so no buffer is tested for NULL.
+* \par         Details
+*              Same register sequence as SpiRWSlave():  FIFO reset, select, bursts of up to
+*              SPI_FIFO_DEPTH words each released with one un-inhibit, deselect.  The deselect
+*              value is the controller's unIdleSelect, so slaves of either polarity on the other
+*              lines stay deselected.  A length of zero or less completes at once without touching
+*              the bus, as in spi_transfer_start().
+*
+* \retval      0, or SPI_ERROR_UNALIGNED if nothing was sent
+*/
+{
+	const u32 unControl = SPI_FIXED_CONTROL(unCPHA, unCPOL);
+	struct spiController *pController;
+	u32 unDeselect, unSelect;
+	int nWords = nNumBytes / nWordBytes;
+	int nWord, nBurst, i;
+
+#if SPI_BACKEND_PS_PRESENT
+	if(spi_backend_is_ps(unPeripheralAddressSPI))
+		return(SpiRWSlave(unPeripheralAddressSPI, nSlave, unCPHA, unCPOL, (u8 *)auchWriteBuf, auchReadBuf, nNumBytes,
+				uchCsActiveHigh));
+#endif
+	if(nNumBytes <= 0)
+		return(0);
+	if(nWordBytes > 1 && nNumBytes % nWordBytes != 0)
+	{
+		LOG2(LOG_ID_SPI_UNALIGNED, unPeripheralAddressSPI, nNumBytes);
+		return(SPI_ERROR_UNALIGNED);
+	}
+	PROF_BEGIN(PROF_SPI_FIXED);
+	LOG3(LOG_ID_SPI_BEGIN, unPeripheralAddressSPI, nNumBytes, uchCsActiveHigh);
+	pController = spi_controller(unPeripheralAddressSPI);
+	if(uchCsActiveHigh)
+		pController->unIdleSelect &= ~(1UL << nSlave);
+	else
+		pController->unIdleSelect |= (1UL << nSlave);
+	unDeselect = pController->unIdleSelect;
+	unSelect = unDeselect ^ (1UL << nSlave);
+	XSpi_WriteReg(unPeripheralAddressSPI, XSP_CR_OFFSET, unControl | 0x00000060);
+	XSpi_WriteReg(unPeripheralAddressSPI, XSP_SSR_OFFSET, unDeselect);
+	XSpi_WriteReg(unPeripheralAddressSPI, XSP_SSR_OFFSET, unSelect);
+
+	for(nWord=0;nWord<nWords;nWord+=nBurst)
+	{
+		nBurst = (nWords - nWord < SPI_FIFO_DEPTH) ? (nWords - nWord) : SPI_FIFO_DEPTH;
+
+		for(i=nWord;i<nWord+nBurst;i++)
+			XSpi_WriteReg(unPeripheralAddressSPI, XSP_DTR_OFFSET,
+					nHasTx ? spi_fixed_pack(&auchWriteBuf[i * nWordBytes], nWordBytes) : 0);
+
+		XSpi_WriteReg(unPeripheralAddressSPI, XSP_CR_OFFSET, unControl & 0xFFFFFEFF);
+		while(!(XSpi_ReadReg(unPeripheralAddressSPI, XSP_SR_OFFSET) & 0x00000004))
+			;
+		XSpi_WriteReg(unPeripheralAddressSPI, XSP_CR_OFFSET, unControl);
+
+		if(nHasRx)
+		{
+			for(i=nWord;i<nWord+nBurst;i++)
+				spi_fixed_unpack(&auchReadBuf[i * nWordBytes], XSpi_ReadReg(unPeripheralAddressSPI, XSP_DRR_OFFSET),
+						nWordBytes);
+		}
+	}
+	XSpi_WriteReg(unPeripheralAddressSPI, XSP_SSR_OFFSET, unDeselect);
+	LOG0(LOG_ID_SPI_END);
+	SPI_CAPTURE(unPeripheralAddressSPI, nSlave, unCPHA, unCPOL, nHasTx ? auchWriteBuf : NULL, nHasRx ? auchReadBuf : NULL,
+			nNumBytes, uchCsActiveHigh);
+	PROF_END(PROF_SPI_FIXED);
+	return(0);
+}
+
+#define SPI_FIXED_DEVICE(name, nSlave, unCPHA, unCPOL, uchCsActiveHigh) \
+	SPI_FIXED_INLINE int name##_rw(u32 unPeripheralAddressSPI, const u8 *auchWriteBuf, u8 *auchReadBuf, int nNumBytes) \
+	{ \
+		return(spi_fixed_transfer(unPeripheralAddressSPI, (nSlave), (unCPHA), (unCPOL), (uchCsActiveHigh), \
+				SPI_FIXED_WORD_BYTES, 1, 1, auchWriteBuf, auchReadBuf, nNumBytes)); \
+	} \
+	SPI_FIXED_INLINE int name##_write(u32 unPeripheralAddressSPI, const u8 *auchWriteBuf, int nNumBytes) \
+	{ \
+		return(spi_fixed_transfer(unPeripheralAddressSPI, (nSlave), (unCPHA), (unCPOL), (uchCsActiveHigh), \
+				SPI_FIXED_WORD_BYTES, 1, 0, auchWriteBuf, NULL, nNumBytes)); \
+	} \
+	SPI_FIXED_INLINE int name##_read(u32 unPeripheralAddressSPI, u8 *auchReadBuf, int nNumBytes) \
+	{ \
+		return(spi_fixed_transfer(unPeripheralAddressSPI, (nSlave), (unCPHA), (unCPOL), (uchCsActiveHigh), \
+				SPI_FIXED_WORD_BYTES, 0, 1, NULL, auchReadBuf, nNumBytes)); \
+	}
+
+#endif /* SPI_FIXED_H_ */
@@ -63,9 +63,118 @@
 #include "stdio.h"
 #include "xbasic_types.h"
 #include "spi_utilities.h"
+#include "log_utilities.h"
+#include "memory_sections.h"
+#include "profile_utilities.h"
+#include "spi_capture.h"
+#include "spi_backend.h"
 //#include "maximPMOD.h"
 
-int SpiRW( u32 unPeripheralAddressSPI, unsigned int unCPHA, unsigned int unCPOL,
+__fast_bss static struct spiController g_axSpiControllers[SPI_MAX_CONTROLLERS];
+
+__fast_text struct spiController *spi_controller(u32 unPeripheralAddressSPI)
+/**
+* \brief       Settings of a controller, registered with the defaults on first use.
+* \par         Details
+*              Defaults are 8 bit transfers and every select line deasserted high.  If the table
+*              is full the last entry is shared, which only costs the settings of controllers
+*              beyond SPI_MAX_CONTROLLERS.
+*
+* \retval      Controller entry
+*/
+{
+	struct spiController *pController;
+	int i;
+
+	for(i=0;i<SPI_MAX_CONTROLLERS;i++)
+	{
+		pController = &g_axSpiControllers[i];
+		if(pController->uchWordBytes != 0 && pController->unPeripheralAddressSPI == unPeripheralAddressSPI)
+			return(pController);
+		if(pController->uchWordBytes == 0)
+			break;
+	}
+	if(i == SPI_MAX_CONTROLLERS)
+		return(&g_axSpiControllers[SPI_MAX_CONTROLLERS - 1]);
+	pController->unPeripheralAddressSPI = unPeripheralAddressSPI;
+	pController->unIdleSelect = 0xFFFFFFFF;
+	pController->uchWordBytes = 1;
+	return(pController);
+}
+
+int spi_set_transfer_width(u32 unPeripheralAddressSPI, u8 uchTransferBits)
+/**
+* \brief       Tell SpiRW() the transfer width the AXI Quad SPI core was built with.
+* \par         Details
+*              The width (C_NUM_TRANSFER_BITS) is a hardware build option that cannot be read back
+*              from the core's registers; pass the DataWidth of the initialized XSpi instance.
+*              Controllers that were never registered are driven 8 bits at a time.
+*
+* \param[in]   unPeripheralAddressSPI   - base address of the SPI controller
+* \param[in]   uchTransferBits          - 8, 16 or 32
+*
+* \retval      TRUE if set, FALSE for an unsupported width
+*/
+{
+	if(uchTransferBits != 8 && uchTransferBits != 16 && uchTransferBits != 32)
+		return(FALSE);
+	spi_controller(unPeripheralAddressSPI)->uchWordBytes = uchTransferBits / 8;
+	return(TRUE);
+}
+
+int spi_word_bytes(u32 unPeripheralAddressSPI)
+/**
+* \brief       Bytes the controller shifts per FIFO word;  every transfer must be a multiple of it.
+* \par         Details
+*              Drivers size their frames with SPI_ALIGN_BYTES(n, spi_word_bytes(...)), using the
+*              bytes that follow a command to fill the last word with ones the part ignores.
+*
+* \retval      1 for the PS SPI controllers, the width set with spi_set_transfer_width() otherwise
+*/
+{
+#if SPI_BACKEND_PS_PRESENT
+	if(spi_backend_is_ps(unPeripheralAddressSPI))
+		return(1);
+#endif
+	return(spi_controller(unPeripheralAddressSPI)->uchWordBytes);
+}
+
+void spi_set_slave_polarity(u32 unPeripheralAddressSPI, int nSlave, u8 uchCsActiveHigh)
+/**
+* \brief       Declare the select polarity of a slave before any other slave is used.
+* \par         Details
+*              SpiRWSlave() leaves the select lines of the other slaves at their idle level.  It
+*              learns a slave's idle level from the first transfer to that slave; a slave with
+*              an active high select must be declared here first, or a transfer to another slave
+*              made before it would also select it.
+*
+* \param[in]   unPeripheralAddressSPI   - base address of the SPI controller
+* \param[in]   nSlave                   - slave select line, 0-31
+* \param[in]   uchCsActiveHigh          - polarity of slave select 0=active low, 1=active high
+*
+* \retval      None
+*/
+{
+	struct spiController *pController = spi_controller(unPeripheralAddressSPI);
+
+	if(uchCsActiveHigh)
+		pController->unIdleSelect &= ~(1UL << nSlave);
+	else
+		pController->unIdleSelect |= (1UL << nSlave);
+}
+
+__fast_text int SpiRW( u32 unPeripheralAddressSPI, unsigned int unCPHA, unsigned int unCPOL,
+		u8* auchWriteBuf, u8* auchReadBuf, int unNumBytes, u8 uchCsActiveHigh )
+/**
+* \brief       Perform a SPI read or write with the slave on select line 0.  See SpiRWSlave().
+*
+* \retval      0, or SPI_ERROR_UNALIGNED
+*/
+{
+	return(SpiRWSlave(unPeripheralAddressSPI, 0, unCPHA, unCPOL, auchWriteBuf, auchReadBuf, unNumBytes, uchCsActiveHigh));
+}
+
+__fast_text int SpiRWSlave( u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA, unsigned int unCPOL,
 		u8* auchWriteBuf, u8* auchReadBuf, int unNumBytes, u8 uchCsActiveHigh )
 /**
 * \brief       Perform a SPI read or write.
@@ -77,8 +186,11 @@ int SpiRW( u32 unPeripheralAddressSPI, unsigned int unCPHA, unsigned int unCPOL,
 *              Data from the MISO pin will be placed into the auchReadBuf
 *              uchCsActiveHigh==TRUE allows SS configurations to be used
 *              uchCsActiveHigh==FALSE allows SS# configurations to be used
+* \n           This is a SpiRWv() transaction with a single segment;  see there for how the bytes
+*              move through the controller.
 *
 * \param[in]   unPeripheralAddressSPI         - @help
+* \param[in]   nSlave             - slave select line, 0-31;  the other lines stay at their idle level
 * \param[in]   unCPHA             - phase of SCK (edge to trigger on). 0=Leading edge, 1=Trailing edge
 * \param[in]   unCPOL             - polarity of SCK. 0=Active high, 1=Active low  
 * \param[in]   auchWriteBuf       - pointer to write data buffer
@@ -86,78 +198,57 @@ int SpiRW( u32 unPeripheralAddressSPI, unsigned int unCPHA, unsigned int unCPOL,
 * \param[in]   unNumBytes         - number of bytes to transfer
 * \param[in]   uchCsActiveHigh    - polarity of slave select 0=active low, 1=active high
 *
-* \retval      Always returns 0
+* \retval      0, or SPI_ERROR_UNALIGNED if nothing was sent
 */
 {
-	int i;
-	unsigned int unControlData = 0x00000186;
-
-	//If CPHA or CPOL = 1, we need to set the corresponding bits in the control register
-	unControlData = unControlData | (unCPHA << 4);
-	unControlData = unControlData | (unCPOL << 3);
+	struct spiSegment xSegment;
 
-	//Write config data to SPICR.  We need the inhibit bit=1.
-	XSpi_WriteReg(unPeripheralAddressSPI, 0x60, unControlData);
-
-	//Deassert CS to 1 to ensure SPI slave is inactive
-	if( uchCsActiveHigh )
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x70, 0xFFFFFFFE);
-	else
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x70, 0xFFFFFFFF);
-
-	for( i = 0; i < unNumBytes; i++)
-	{
-		if( auchWriteBuf != 0 )
-		{
-			//Write data to SPIDTR.  This is the data that will be transferred to the SPI slave.
-			XSpi_WriteReg(unPeripheralAddressSPI, 0x68, auchWriteBuf[ i ]);
-			//Debug//printf( "Write %02x; ", auchWriteBuf[i]);
-		}
-		else
-		{
-			//Write data to SPIDTR.  This is the data that will be transferred to the SPI slave.
-			XSpi_WriteReg(unPeripheralAddressSPI, 0x68, 0x00);
-		}
-
-		//Write config data to SPICR.  We need the inhibit bit=1.
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x60, unControlData);
-
-		//Assert CS for our PMOD part
-		if( uchCsActiveHigh )
-			XSpi_WriteReg(unPeripheralAddressSPI, 0x70, 0xFFFFFFFF);
-		else
-			XSpi_WriteReg(unPeripheralAddressSPI, 0x70, 0xFFFFFFFE);
-
-		//Un-inhibit our SPI master to transfer the data
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x60, unControlData & 0xFFFFFEFF);
-
-		//Wait for transaction to complete.  Check to see if Tx_Empty flag is set before proceeding.
-		while( !(XSpi_ReadReg( unPeripheralAddressSPI, 0x64 ) & 0x00000004) )
-			;
-
-		//Inhibit SPI master to prevent further action
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x60, unControlData);
-
-		//Read received data
-		if( (auchReadBuf != 0) )
-		{
-			auchReadBuf[ i ] = XSpi_ReadReg(unPeripheralAddressSPI, 0x6C);
-			//Debug//printf( "Read %02x\r\n", auchReadBuf[i]);
-		}
-	}
-	if( uchCsActiveHigh )
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x70, 0xFFFFFFFE);
-	else
-		XSpi_WriteReg(unPeripheralAddressSPI, 0x70, 0xFFFFFFFF);
-	return 0;
+	xSegment.auchWriteBuf = auchWriteBuf;
+	xSegment.auchReadBuf = auchReadBuf;
+	xSegment.nNumBytes = unNumBytes;
+	xSegment.uchFlags = 0;
+	return(SpiRWv(unPeripheralAddressSPI, nSlave, unCPHA, unCPOL, &xSegment, 1, uchCsActiveHigh));
 }
 
+__fast_text int SpiRWv( u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA, unsigned int unCPOL,
+		const struct spiSegment *axSegments, int nSegments, u8 uchCsActiveHigh )
+/**
+* \brief       Perform one SPI transaction made of several segments (scatter-gather).
+* \par         Details
+*              The segments are shifted back to back under one slave select assertion, exactly as
+*              if their bytes had been copied into one buffer for SpiRWSlave():  a command header,
+*              an address and a payload can come from separate buffers without staging them.
+*              Bytes are packed into words across segment boundaries on cores wider than 8 bits.
+* \n           The transaction runs through the controller's backend (spi_backend.h), polled:  on
+*              the AXI Quad SPI the data moves through the FIFOs in bursts of up to SPI_FIFO_DEPTH
+*              words, with one un-inhibit / Tx empty wait per burst, and on a core built with a 16
+*              or 32 bit transfer width (see spi_set_transfer_width()) one DTR write and one DRR
+*              read move 2 or 4 bytes, packed MSB first.  The PS SPI controllers move single bytes.
+* \n           The AXI core always shifts whole words and its width is fixed when it is built, so a
+*              length that is not a multiple of spi_word_bytes() cannot be sent as asked:  padding
+*              the last word would clock bytes the caller never wrote into the selected part (with
+*              an auto-incrementing part, into the next register).  Such a transaction is refused
+*              before anything is selected.
+* \n           Per segment, SPI_SEG_ZERO_TX (or a NULL auchWriteBuf) sends nNumBytes zeros and
+*              SPI_SEG_DISCARD_RX (or a NULL auchReadBuf) drops the bytes received.  When no segment
+*              keeps its Rx data the Rx FIFO is not read at all.
+*
+* \param[in]   unPeripheralAddressSPI   - base address of the SPI controller
+* \param[in]   nSlave             - slave select line, 0-31;  the other lines stay at their idle level
+* \param[in]   unCPHA             - phase of SCK (edge to trigger on). 0=Leading edge, 1=Trailing edge
+* \param[in]   unCPOL             - polarity of SCK. 0=Active high, 1=Active low
+* \param[in]   axSegments         - segments, in wire order
+* \param[in]   nSegments          - number of segments
+* \param[in]   uchCsActiveHigh    - polarity of slave select 0=active low, 1=active high
+*
+* \retval      0, or SPI_ERROR_UNALIGNED if nothing was sent
+*/
+{
+	struct spiTransfer xTransfer;
+	PROF_BEGIN(PROF_SPI_RW);
 
-
-
-
-
-
-
-
-
+	spi_transfer_setupv(&xTransfer, unPeripheralAddressSPI, nSlave, unCPHA, unCPOL, axSegments, nSegments, uchCsActiveHigh);
+	spi_transfer_run(&xTransfer);
+	PROF_END(PROF_SPI_RW);
+	return(xTransfer.nResult);
+}
@@ -70,6 +70,7 @@
 #include "xparameters.h"    
 #include "xgpio.h"          
 #include "xgpio_l.h"        
+#include "mmio_utilities.h"
 //#include "maximPMOD.h"
 #endif /* UTILITIES_H_ */
 
@@ -90,11 +91,52 @@
 //====================================================================================================
 int SpiRW(u32 unPeripheralAddressSPI, unsigned int unCPHA, unsigned int unCPOL,
 		u8* auchWriteBuf, u8* auchReadBuf, int unNumBytes, u8 uchCsActiveHigh );
+int SpiRWSlave(u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA, unsigned int unCPOL,
+		u8* auchWriteBuf, u8* auchReadBuf, int unNumBytes, u8 uchCsActiveHigh );
+
+#define SPI_SEG_DISCARD_RX 0x01         //!< Drop the bytes received during the segment
+#define SPI_SEG_ZERO_TX 0x02            //!< Send nNumBytes zeros (auchWriteBuf is not read)
+
+struct spiSegment                       //!< One piece of a SpiRWv() transaction
+{
+	const u8 *auchWriteBuf;             //!< data to send, or NULL for zeros
+	u8 *auchReadBuf;                    //!< received data, or NULL to discard
+	int nNumBytes;
+	u8 uchFlags;                        //!< SPI_SEG_...
+};
+
+int SpiRWv(u32 unPeripheralAddressSPI, int nSlave, unsigned int unCPHA, unsigned int unCPOL,
+		const struct spiSegment *axSegments, int nSegments, u8 uchCsActiveHigh );
+
+#define SPI_ERROR_UNALIGNED (-1)        //!< Transfer refused:  not a whole number of words (see spi_word_bytes())
+#define SPI_ALIGN_BYTES(nNumBytes, nWordBytes) ((((nNumBytes) + (nWordBytes) - 1) / (nWordBytes)) * (nWordBytes))   //!< Length rounded up to whole words
+
+#define SPI_FIFO_DEPTH 16               //!< Words per SpiRW() burst; the AXI Quad SPI FIFO depth (C_FIFO_DEPTH)
+#define SPI_MAX_CONTROLLERS 4           //!< SPI controllers whose settings are kept
+
+struct spiController                    //!< Build options and select line state of one controller
+{
+	u32 unPeripheralAddressSPI;
+	u32 unIdleSelect;                   //!< SSR value with every slave deselected
+	u8 uchWordBytes;                    //!< 1, 2 or 4 (see spi_set_transfer_width());  0 marks an unused entry
+};
+
+struct spiController *spi_controller(u32 unPeripheralAddressSPI);
+int spi_set_transfer_width(u32 unPeripheralAddressSPI, u8 uchTransferBits);
+int spi_word_bytes(u32 unPeripheralAddressSPI);
+void spi_set_slave_polarity(u32 unPeripheralAddressSPI, int nSlave, u8 uchCsActiveHigh);
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
+#if MMIO_TRACE_ENABLED
+#undef XSpi_In32
+#undef XSpi_Out32
+#define XSpi_In32(Addr)			MMIO_IN32(Addr)
+#define XSpi_Out32(Addr, Value)	MMIO_OUT32(Addr, Value)
+#else
 #define XSpi_In32	Xil_In32
 #define XSpi_Out32	Xil_Out32
+#endif
 
 /****************************************************************************/
 /**
@@ -0,0 +1,190 @@
+/** \file thermostat_utilities.c *********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: thermostat_utilities.c
+ *         Description: Event driven alarm monitoring.  The MAX31723 compares
+ *                      each conversion against Thigh/Tlow itself and signals a
+ *                      crossing on TOUT; TOUT is wired to an AXI GPIO input
+ *                      whose interrupt wakes the application.  The sensor is
+ *                      otherwise only read on a slow heartbeat.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "xbasic_types.h"
+#include "xparameters.h"
+#include "delays.h"
+#include "interrupt_utilities.h"
+#include "max31723_utilities.h"
+#include "max31723_cache.h"
+#include "thermostat_utilities.h"
+#include "log_utilities.h"
+#include "memory_sections.h"
+
+#if THERMOSTAT_TOUT_PRESENT
+__fast_text static void thermostat_tout_isr(void *pCallbackRef)
+/**
+* \brief       TOUT GPIO interrupt:  flag the event for thermostat_poll().
+* \par         Details
+*              The AXI GPIO interrupts on both edges;  only the edge to the asserted level is an
+*              event, the release caused by the acknowledging read is ignored.
+*/
+{
+	struct maximThermostatMonitor *pMonitor = (struct maximThermostatMonitor *)pCallbackRef;
+	u32 unLevel;
+
+	XGpio_InterruptClear(&pMonitor->xGpio, XGPIO_IR_CH1_MASK);
+	unLevel = XGpio_DiscreteRead(&pMonitor->xGpio, 1) & THERMOSTAT_TOUT_MASK;
+	if(THERMOSTAT_TOUT_ACTIVE_LOW ? (unLevel == 0) : (unLevel != 0))
+	{
+		pMonitor->uchPending = TRUE;
+		pMonitor->unInterruptCount++;
+	}
+}
+#endif
+
+int thermostat_init(struct maximThermostatMonitor *pMonitor, struct maximMax31723Cache *pCache,
+		s16 nLowAlarm, s16 nHighAlarm, u32 unHeartbeatMs)
+/**
+* \brief       Program the alarm thresholds, put TOUT in interrupt mode and enable its interrupt.
+* \par         Details
+*              Without interrupt_init() (or a TOUT GPIO) the monitor runs on the heartbeat alone.
+*              The current temperature is read once at the end, which also releases TOUT if it was
+*              asserted before the monitor started;  a reading already above Thigh is reported as a
+*              HIGH event by the first poll.
+*
+* \param[out]  *pMonitor        - monitor instance
+* \param[in]   *pCache          - cache of the MAX31723 to monitor
+* \param[in]   nLowAlarm        - Tlow in 1/16 degC
+* \param[in]   nHighAlarm       - Thigh in 1/16 degC
+* \param[in]   unHeartbeatMs    - time between readings when nothing happens, e.g. THERMOSTAT_HEARTBEAT_MS
+*
+* \retval      TRUE if TOUT interrupts are used, FALSE if only the heartbeat is
+*/
+{
+	s16 nTemp;
+	int nToutEnabled = FALSE;
+
+	memset(pMonitor, 0, sizeof(*pMonitor));
+	pMonitor->pCache = pCache;
+	pMonitor->uchConfiguration = pCache->uchConfiguration;
+	pMonitor->unHeartbeatMs = unHeartbeatMs;
+
+	max31723_cache_set_alarm(pCache, nLowAlarm, MAX31723_LOW_ALARM_WRITE);
+	max31723_cache_set_alarm(pCache, nHighAlarm, MAX31723_HIGH_ALARM_WRITE);
+	max31723_cache_read_raw(pCache, &pMonitor->nLowAlarm, MAX31723_LOW_ALARM_READ);
+	max31723_cache_read_raw(pCache, &pMonitor->nHighAlarm, MAX31723_HIGH_ALARM_READ);
+	max31723_cache_configure(pCache, (pCache->uchConfiguration & ~MAX31723_CONFIG_SHUTDOWN) | MAX31723_CONFIG_TM_INTERRUPT);
+
+#if THERMOSTAT_TOUT_PRESENT
+	if(XGpio_Initialize(&pMonitor->xGpio, XPAR_AXI_GPIO_TOUT_DEVICE_ID) == XST_SUCCESS)
+	{
+		XGpio_SetDataDirection(&pMonitor->xGpio, 1, THERMOSTAT_TOUT_MASK);
+		XGpio_InterruptClear(&pMonitor->xGpio, XGPIO_IR_CH1_MASK);
+		if(interrupt_connect(XPAR_FABRIC_AXI_GPIO_TOUT_IP2INTC_IRPT_INTR,
+				(Xil_InterruptHandler)thermostat_tout_isr, pMonitor) == XST_SUCCESS)
+		{
+			XGpio_InterruptEnable(&pMonitor->xGpio, XGPIO_IR_CH1_MASK);
+			XGpio_InterruptGlobalEnable(&pMonitor->xGpio);
+			nToutEnabled = TRUE;
+		}
+	}
+#endif
+
+	// Without a conversion at the new configuration yet, the first poll makes the read
+	if(max31723_cache_read_raw(pCache, &nTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY || nTemp > pMonitor->nHighAlarm)
+		pMonitor->uchPending = TRUE;
+	pMonitor->unLastReadMs = get_time_ms();
+	LOG3(LOG_ID_THERMOSTAT_START, pMonitor->nLowAlarm, pMonitor->nHighAlarm, nToutEnabled);
+	return(nToutEnabled);
+}
+
+int thermostat_poll(struct maximThermostatMonitor *pMonitor, s16 *pnTemp)
+/**
+* \brief       Handle a pending TOUT event or a due heartbeat.  Never blocks.
+* \par         Details
+*              A TOUT event forces a read from the part (bypassing the cache), which acknowledges
+*              TOUT.  The MAX31723 alternates HIGH and LOW events, so the direction follows from
+*              the alarm state;  the reading is checked against it so a missed edge cannot leave the
+*              state inverted.
+*
+* \param[in]   *pMonitor    - monitor instance
+* \param[out]  *pnTemp      - temperature in 1/16 degC, written unless THERMOSTAT_EVENT_NONE is returned
+*
+* \retval      THERMOSTAT_EVENT_...
+*/
+{
+	u32 unNow = get_time_ms();
+	int nEvent = THERMOSTAT_EVENT_NONE;
+
+	if(pMonitor->uchPending)
+	{
+		pMonitor->uchPending = FALSE;
+		max31723_cache_invalidate(pMonitor->pCache);
+		if(max31723_cache_read_raw(pMonitor->pCache, pnTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+		{
+			// No conversion at the monitor's configuration yet:  acknowledge TOUT on a later poll
+			pMonitor->uchPending = TRUE;
+			return(THERMOSTAT_EVENT_NONE);
+		}
+		nEvent = THERMOSTAT_EVENT_HEARTBEAT;
+	}
+	else if(unNow - pMonitor->unLastReadMs >= pMonitor->unHeartbeatMs)
+	{
+		if(max31723_cache_read_raw(pMonitor->pCache, pnTemp, MAX31723_TEMP_READ) == MAX31723_CACHE_NOT_READY)
+			return(THERMOSTAT_EVENT_NONE);
+		pMonitor->unHeartbeatCount++;
+		nEvent = THERMOSTAT_EVENT_HEARTBEAT;
+	}
+	else
+		return(THERMOSTAT_EVENT_NONE);
+	pMonitor->unLastReadMs = unNow;
+
+	// Same hysteresis as the part:  HIGH above Thigh, LOW again only below Tlow
+	if(!pMonitor->uchAlarmActive && *pnTemp > pMonitor->nHighAlarm)
+	{
+		pMonitor->uchAlarmActive = TRUE;
+		nEvent = THERMOSTAT_EVENT_HIGH;
+	}
+	else if(pMonitor->uchAlarmActive && *pnTemp < pMonitor->nLowAlarm)
+	{
+		pMonitor->uchAlarmActive = FALSE;
+		nEvent = THERMOSTAT_EVENT_LOW;
+	}
+
+	if(nEvent == THERMOSTAT_EVENT_HIGH || nEvent == THERMOSTAT_EVENT_LOW)
+	{
+		pMonitor->unEventCount++;
+		LOG2(LOG_ID_THERMOSTAT_EVENT, nEvent, *pnTemp);
+	}
+	return(nEvent);
+}
+
+void thermostat_stop(struct maximThermostatMonitor *pMonitor)
+/**
+* \brief       Disable the TOUT interrupt and restore the configuration the monitor started with.
+*
+* \retval      None
+*/
+{
+#if THERMOSTAT_TOUT_PRESENT
+	XGpio_InterruptDisable(&pMonitor->xGpio, XGPIO_IR_CH1_MASK);
+	XGpio_InterruptClear(&pMonitor->xGpio, XGPIO_IR_CH1_MASK);
+#endif
+	max31723_cache_configure(pMonitor->pCache, pMonitor->uchConfiguration);
+}
@@ -0,0 +1,99 @@
+/** \file thermostat_utilities.h *********************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: thermostat_utilities.h
+ *         Description: Event driven alarm monitoring.  The MAX31723 compares
+ *                      each conversion against Thigh/Tlow itself and signals a
+ *                      crossing on TOUT; TOUT is wired to an AXI GPIO input
+ *                      whose interrupt wakes the application.  The sensor is
+ *                      otherwise only read on a slow heartbeat.
+ *
+ *  --------------------------------------------------------------------
+ *
+ *    This code follows the following naming conventions.
+ *
+ * 	  char                   chPmodValue
+ * 	  char (array)           sPmodString[16]
+ * 	  float                  fPmodValue
+ * 	  int                    nPmodValue
+ * 	  int (array)            anPmodValue[16]
+ * 	  u16                    uPmodValue
+ * 	  u8                     uchPmodValue
+ * 	  u8 (array)             auchPmodBuffer[16]
+ * 	  unsigned int           unPmodValue
+ * 	  int *                  punPmodValue
+ *
+ * ------------------------------------------------------------------------- */
+
+#ifndef THERMOSTAT_UTILITIES_H_
+#define THERMOSTAT_UTILITIES_H_
+
+#include "xbasic_types.h"
+#include "xparameters.h"
+#include "max31723_cache.h"
+
+// TOUT goes to channel 1 of an AXI GPIO with its interrupt output connected to the GIC
+#if defined(XPAR_AXI_GPIO_TOUT_DEVICE_ID) && defined(XPAR_FABRIC_AXI_GPIO_TOUT_IP2INTC_IRPT_INTR)
+#define THERMOSTAT_TOUT_PRESENT 1
+#include "xgpio.h"
+#else
+#define THERMOSTAT_TOUT_PRESENT 0       //!< No TOUT input:  crossings are found on the heartbeat only
+#endif
+
+#ifndef THERMOSTAT_TOUT_MASK
+#define THERMOSTAT_TOUT_MASK 0x00000001 //!< GPIO channel 1 bit TOUT is wired to
+#endif
+#ifndef THERMOSTAT_TOUT_ACTIVE_LOW
+#define THERMOSTAT_TOUT_ACTIVE_LOW 1    //!< TOUT is an active low, open drain output (needs a pull-up)
+#endif
+#define THERMOSTAT_HEARTBEAT_MS 10000   //!< Default time between reads when no crossing occurs
+#define THERMOSTAT_TICK_RATE_HZ 4       //!< Tick while monitoring:  bounds the key and heartbeat latency, not the alarm's
+
+#define THERMOSTAT_EVENT_NONE 0
+#define THERMOSTAT_EVENT_HIGH 1         //!< temperature rose above Thigh
+#define THERMOSTAT_EVENT_LOW 2          //!< temperature fell below Tlow after a HIGH event
+#define THERMOSTAT_EVENT_HEARTBEAT 3    //!< reading without a crossing (heartbeat or spurious TOUT edge)
+
+/*
+ * In interrupt mode the MAX31723 asserts TOUT when a conversion exceeds Thigh, and after that when
+ * one falls below Tlow;  TOUT stays asserted until a register is read.  The GPIO interrupt only
+ * flags the event, and thermostat_poll() does the acknowledging read from the main loop, so the
+ * SPI bus is never used in interrupt context.
+ *
+ * Without a TOUT input the heartbeat reading is compared in software with the same hysteresis.
+ *
+ * The caller sleeps (THERMOSTAT_WAIT()) between polls.  Any interrupt ends the sleep, so while
+ * monitoring the tick runs at THERMOSTAT_TICK_RATE_HZ (tick_timer_set_rate()) instead of
+ * TICK_RATE_HZ;  apart from TOUT it only has to notice a key press and the heartbeat.
+ */
+
+#if defined(__arm__)
+#define THERMOSTAT_WAIT() __asm__ __volatile__("wfi" ::: "memory")  //!< Sleep until the next interrupt
+#else
+#define THERMOSTAT_WAIT() __asm__ __volatile__("" ::: "memory")
+#endif
+
+struct maximThermostatMonitor
+{
+	struct maximMax31723Cache *pCache;
+	u8 uchConfiguration;                //!< configuration restored by thermostat_stop()
+	s16 nLowAlarm;                      //!< 1/16 degC
+	s16 nHighAlarm;
+	u8 uchAlarmActive;                  //!< TRUE between a HIGH and the following LOW event
+	volatile u8 uchPending;             //!< set by the TOUT interrupt
+	volatile u32 unInterruptCount;
+	u32 unHeartbeatMs;
+	u32 unLastReadMs;
+	u32 unEventCount;                   //!< HIGH and LOW events reported
+	u32 unHeartbeatCount;
+#if THERMOSTAT_TOUT_PRESENT
+	XGpio xGpio;
+#endif
+};
+
+int thermostat_init(struct maximThermostatMonitor *pMonitor, struct maximMax31723Cache *pCache,
+		s16 nLowAlarm, s16 nHighAlarm, u32 unHeartbeatMs);
+int thermostat_poll(struct maximThermostatMonitor *pMonitor, s16 *pnTemp);
+void thermostat_stop(struct maximThermostatMonitor *pMonitor);
+
+#endif /* THERMOSTAT_UTILITIES_H_ */
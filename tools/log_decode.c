@@ -0,0 +1,72 @@
+/** \file log_decode.c *******************************************************
+ *
+ *             Project: Maxim Plug-in Peripheral Modules
+ *            Filename: tools/log_decode.c
+ *         Description: Host tool that formats the "LOG ..." records drained
+ *                      by log_utilities.c, using the same format table the
+ *                      firmware was built with.  Other lines are passed
+ *                      through unchanged, so a whole terminal capture can be
+ *                      piped through it.
+ *
+ *                      Build:  cc -I.. -o log_decode log_decode.c
+ *                      Usage:  log_decode [ticks_per_second] < capture.txt
+ *
+ *                      ticks_per_second defaults to 333333343 (Zedboard,
+ *                      667 MHz CPU clock / 2).
+ *
+ * ------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log_formats.h"
+
+#define LOG_FORMAT_STRING(id, fmt) fmt,
+
+static const char *g_asFormats[] =
+{
+	LOG_FORMAT_TABLE(LOG_FORMAT_STRING)
+};
+
+int main(int argc, char *argv[])
+{
+	char sLine[256];
+	double dTicksPerSecond = 333333343.0;
+	unsigned long ulSequence, ulTimestamp, ulId, ulArgCount, aulArgs[3];
+	unsigned long ulPrevTimestamp = 0;
+	unsigned long long ullTicks = 0;
+	unsigned long ulExpectedSequence = 0;
+	int nFirst = 1;
+
+	if(argc > 1)
+		dTicksPerSecond = atof(argv[1]);
+
+	while(fgets(sLine, sizeof(sLine), stdin) != NULL)
+	{
+		if(sscanf(sLine, "LOG %lx %lx %lx %lx %lx %lx %lx", &ulSequence, &ulTimestamp, &ulId,
+				&ulArgCount, &aulArgs[0], &aulArgs[1], &aulArgs[2]) != 7)
+		{
+			fputs(sLine, stdout);
+			continue;
+		}
+
+		// The target only keeps the lower 32 bits of the timer; unwrap them here
+		if(!nFirst)
+		{
+			if(ulSequence != ulExpectedSequence)
+				printf("%-14s ... %lu entries lost ...\n", "", ulSequence - ulExpectedSequence);
+			ullTicks += (unsigned long)((ulTimestamp - ulPrevTimestamp) & 0xFFFFFFFFUL);
+		}
+		nFirst = 0;
+		ulPrevTimestamp = ulTimestamp;
+		ulExpectedSequence = ulSequence + 1;
+
+		printf("%12.6f s  ", (double)ullTicks / dTicksPerSecond);
+		if(ulId < LOG_ID_COUNT)
+			printf(g_asFormats[ulId], (unsigned int)aulArgs[0], (unsigned int)aulArgs[1], (unsigned int)aulArgs[2]);
+		else
+			printf("<unknown format %lu> %lx %lx %lx", ulId, aulArgs[0], aulArgs[1], aulArgs[2]);
+		printf("\n");
+	}
+	return 0;
+}
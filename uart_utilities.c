@@ -126,10 +126,56 @@ u8 checkUartEmpty(u32 unUartAddress)
 
 }
 
+// ----------------------------------------------------------------------------//
+u8 checkUartTxEmpty(u32 unUartAddress)
+/**
+* \brief       Check if the UART Tx FIFO is empty.
+* \par         Details
+*              A short line (less than the 64 byte FIFO) can be written without stalling when this is True.
+*
+* \param[in]   unUartAddress.  32 bit UART address
+*
+* \retval      True if empty (false if not)
+*/
+{
+	// Register UART BASE ADDR + 0x2C.  Bit 3 is a (1) when Tx FIFO is empty
+	if((Xil_In32(unUartAddress + 0x0000002C) & 0x00000008)==0x00000008)
+		return(TRUE);
+	return(FALSE);
+}
+
+// ----------------------------------------------------------------------------//
+void sendUartBuffer(u32 unUartAddress, const u8 *auchBuffer, int nLength)
+/**
+* \brief       Write nLength bytes straight to the UART Tx FIFO, bypassing stdio.
+* \par         Details
+*              Waits on the Tx FIFO full flag only, so a burst that fits in the 64 byte FIFO costs
+*              one status read and one FIFO write per byte.
+*
+* \param[in]   unUartAddress.  32 bit UART address
+* \param[in]   auchBuffer.  The bytes to be sent
+* \param[in]   nLength.  Number of bytes to send
+*
+* \retval      None
+*/
+{
+	int i;
+
+	for(i=0;i<nLength;i++)
+	{
+		// Register UART BASE ADDR + 0x2C.  Bit 4 is a (1) when Tx FIFO is full
+		while((Xil_In32(unUartAddress + 0x0000002C) & 0x00000010)==0x00000010)
+			;
+		Xil_Out32(unUartAddress + 0x00000030, auchBuffer[i]);
+	}
+}
+
 // ----------------------------------------------------------------------------//
 u8 getUartByte(u32 nUartAddress)
 /**
 * \brief       Get a byte from either the full UART in the Zynq PS,
+* \par         Details
+*              Waits until the Rx FIFO holds a byte, then pops it from the FIFO register.
 *
 * \param[in]  unUartAddress.  32 bit UART address
 *
@@ -142,7 +188,10 @@ u8 getUartByte(u32 nUartAddress)
 	// if not, assume it is an HDL instantiated AXI-UartLite
 	//cs if(nUartAddress==XPAR_PS7_UART_1_BASEADDR)
 		//csread(1, (char*)&uchInput, 1);	// Get a byte from stdin
-		uchInput=Xil_In8(nUartAddress);
+		while(checkUartEmpty(nUartAddress))
+			;
+		// Register UART BASE ADDR + 0x30 is the Tx/Rx FIFO
+		uchInput=Xil_In8(nUartAddress + 0x00000030);
 	//cs else
 	//cs	uchInput = XUartLite_RecvByte(nUartAddress);
 	return(uchInput);
@@ -78,6 +78,8 @@ int receive_byte_with_timeout(u32 unUartAddress, int nTimeoutInTenthsOfSeconds,
 u8 getUartByte(u32 nUartAddress);
 void sendUartByte(u32 unUartAddress, u8 uchByte);
 u8 checkUartEmpty(u32 unUartAddress);
+u8 checkUartTxEmpty(u32 unUartAddress);
+void sendUartBuffer(u32 unUartAddress, const u8 *auchBuffer, int nLength);
 
 unsigned int menu_get_direct_entry(u32 nUartAddress, int nNumberBits);
 u8 menu_retrieve_keypress(u32 nUartAddress);